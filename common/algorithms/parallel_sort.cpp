@@ -9,7 +9,7 @@ namespace embree
   template<typename Key>
   struct RadixSortRegressionTest : public RegressionTest
   {
-    RadixSortRegressionTest(const char* name) : RegressionTest(name) {
+    RadixSortRegressionTest(const char* name, Key mask = Key(-1)) : RegressionTest(name), mask(mask) {
       registerRegressionTest(this);
     }
     
@@ -22,7 +22,7 @@ namespace embree
       {
 	std::vector<Key> src(N); memset(src.data(),0,N*sizeof(Key));
 	std::vector<Key> tmp(N); memset(tmp.data(),0,N*sizeof(Key));
-	for (size_t i=0; i<N; i++) src[i] = uint64_t(rand())*uint64_t(rand());
+	for (size_t i=0; i<N; i++) src[i] = Key(uint64_t(rand())*uint64_t(rand())) & mask;
 	
 	/* calculate checksum */
 	Key sum0 = 0; for (size_t i=0; i<N; i++) sum0 += src[i];
@@ -43,8 +43,11 @@ namespace embree
       
       return passed;
     }
+
+    Key mask;
   };
 
   RadixSortRegressionTest<uint32_t> test_u32("RadixSortRegressionTestU32");
   RadixSortRegressionTest<uint64_t> test_u64("RadixSortRegressionTestU64");
+  RadixSortRegressionTest<uint64_t> test_u64_24bit("RadixSortRegressionTestU64_24Bit",0xFFFFFF);
 }
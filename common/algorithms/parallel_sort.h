@@ -260,6 +260,11 @@ namespace embree
     static const size_t BITS = 8;
     static const size_t BUCKETS = (1 << BITS);
     typedef unsigned int TyRadixCount[BUCKETS];
+
+    /* the scatter buffers a cache line of items per bucket and writes full lines with streaming stores */
+    static const size_t LINE_BYTES = 64;
+    static const size_t LINE_ITEMS = LINE_BYTES/sizeof(Ty);
+    static const size_t WRITE_COMBINE_THRESHOLD = 16*BUCKETS*LINE_ITEMS; //!< minimal number of items per task to use write combining
     
     template<typename T>
       static bool compare(const T& v0, const T& v1) {
@@ -380,6 +385,11 @@ namespace embree
       }
       
       /* copy items into their buckets */
+      if (useWriteCombining(dst,endID-startID)) {
+        scatterWriteCombined(shift,src,dst,startID,endID,offset);
+        return;
+      }
+      
 #if defined(__INTEL_COMPILER)
 #pragma nounroll
 #endif
@@ -393,36 +403,112 @@ namespace embree
         dst[offset[index]++] = elt;
       }
     }
+
+    static __forceinline bool useWriteCombining(const Ty* dst, const size_t numItems)
+    {
+      if (LINE_BYTES % sizeof(Ty) != 0 || LINE_ITEMS < 2) return false;
+      if (size_t(dst) % sizeof(Ty) != 0) return false;
+      return numItems >= WRITE_COMBINE_THRESHOLD;
+    }
+
+    /* stores the buffered cache line of a bucket with streaming stores */
+    static __forceinline void storeLine(Ty* __restrict dst, const Ty* __restrict line)
+    {
+      for (size_t i=0; i<LINE_BYTES; i+=sizeof(vintx))
+        vintx::store_nt((char*)dst+i, vintx::load((const void*)((const char*)line+i)));
+    }
+
+    void scatterWriteCombined(const Key shift,
+                              const Ty* __restrict const src,
+                              Ty* __restrict const dst,
+                              const size_t startID, const size_t endID,
+                              unsigned int* __restrict const offset)
+    {
+      /* mask to extract some number of bits */
+      const Key mask = BUCKETS-1;
+
+      /* one cache line of items per bucket */
+      __aligned(64) char storage[BUCKETS*LINE_BYTES];
+      Ty* __restrict const lines = (Ty*) storage;
+
+      /* slot of an item inside its cache line of the destination array */
+      const size_t misalignment = (size_t(dst) % LINE_BYTES) / sizeof(Ty);
+      auto slot = [&] (size_t i) { return (i+misalignment) % LINE_ITEMS; };
+
+      /* the lines at the bucket borders are shared with other tasks and get written item by item */
+      __aligned(64) unsigned int start[BUCKETS];
+      for (size_t i=0; i<BUCKETS; i++)
+        start[i] = offset[i];
+      
+#if defined(__INTEL_COMPILER)
+#pragma nounroll
+#endif
+      for (size_t i=startID; i<endID; i++) {
+        const Ty elt = src[i];
+#if defined(__X86_64__) || defined(__aarch64__)
+        const size_t index = ((size_t)(Key)src[i] >> (size_t)shift) & (size_t)mask;
+#else
+        const size_t index = ((Key)src[i] >> shift) & mask;
+#endif
+        const size_t o = offset[index]++;
+        Ty* __restrict const line = &lines[index*LINE_ITEMS];
+        line[slot(o)] = elt;
+        if (slot(o) != LINE_ITEMS-1) continue;
+
+        const ssize_t lineStart = ssize_t(o)-ssize_t(LINE_ITEMS-1);
+        if (likely(lineStart >= ssize_t(start[index])))
+          storeLine(&dst[lineStart],line);
+        else
+          for (size_t j=start[index]; j<=o; j++)
+            dst[j] = line[slot(j)];
+      }
+
+      /* write partially filled lines */
+      for (size_t i=0; i<BUCKETS; i++)
+      {
+        const size_t end = offset[i];
+        const ssize_t lineStart = max(ssize_t(end)-ssize_t(slot(end)),ssize_t(start[i]));
+        for (size_t j=lineStart; j<end; j++)
+          dst[j] = lines[i*LINE_ITEMS+slot(j)];
+      }
+      _mm_sfence(); // make streaming stores visible to other threads
+    }
     
-    void tbbRadixIteration(const Key shift, const bool last,
+    /* returns false if the iteration got skipped as all items fall into the same bucket */
+    bool tbbRadixIteration(const Key shift,
                            const Ty* __restrict src, Ty* __restrict dst,
                            const size_t numTasks)
     {
       affinity_partitioner ap;
       parallel_for_affinity(numTasks,[&] (size_t taskIndex) { tbbRadixIteration0(shift,src,dst,taskIndex,numTasks); },ap);
+
+      /* skip the scatter if all items have the same digit, e.g. for unused high key bits */
+      const size_t index = ((Key)src[0] >> shift) & (BUCKETS-1);
+      size_t count = 0;
+      for (size_t i=0; i<numTasks; i++)
+        count += radixCount[i][index];
+      if (count == N) return false;
+      
       parallel_for_affinity(numTasks,[&] (size_t taskIndex) { tbbRadixIteration1(shift,src,dst,taskIndex,numTasks); },ap);
+      return true;
     }
     
     void tbbRadixSort(const size_t numTasks)
     {
       radixCount = (TyRadixCount*) alignedMalloc(MAX_TASKS*sizeof(TyRadixCount),64);
-      
-      if (sizeof(Key) == sizeof(uint32_t)) {
-        tbbRadixIteration(0*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(1*BITS,0,tmp,src,numTasks);
-        tbbRadixIteration(2*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(3*BITS,1,tmp,src,numTasks);
+
+      Ty* in = src;
+      Ty* out = tmp;
+      for (size_t i=0; i<sizeof(Key)*8/BITS; i++) {
+        if (tbbRadixIteration(Key(i*BITS),in,out,numTasks))
+          std::swap(in,out);
       }
-      else if (sizeof(Key) == sizeof(uint64_t))
-      {
-        tbbRadixIteration(0*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(1*BITS,0,tmp,src,numTasks);
-        tbbRadixIteration(2*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(3*BITS,0,tmp,src,numTasks);
-        tbbRadixIteration(4*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(5*BITS,0,tmp,src,numTasks);
-        tbbRadixIteration(6*BITS,0,src,tmp,numTasks);
-        tbbRadixIteration(7*BITS,1,tmp,src,numTasks);
+
+      /* an odd number of scatters leaves the items in the temporary array */
+      if (in != src) {
+        parallel_for(size_t(0), N, size_t(4096), [&] (const range<size_t>& r) {
+            for (size_t i=r.begin(); i<r.end(); i++) src[i] = tmp[i];
+          });
       }
     }
     
@@ -162,6 +162,50 @@ namespace embree
   void os_advise(void *ptr, size_t bytes)
   {
   }
+
+  void* os_map_file(const char* fileName, size_t offset, size_t bytes, void*& mapping, size_t& mappingBytes)
+  {
+    HANDLE file = CreateFileA(fileName,GENERIC_READ,FILE_SHARE_READ,nullptr,OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+      throw std::runtime_error("cannot open file "+std::string(fileName));
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file,&fileSize) || offset > size_t(fileSize.QuadPart) || bytes > size_t(fileSize.QuadPart)-offset) {
+      CloseHandle(file);
+      throw std::runtime_error("range out of bounds of file "+std::string(fileName));
+    }
+
+    mapping = nullptr;
+    mappingBytes = 0;
+    if (bytes == 0) {
+      CloseHandle(file);
+      return nullptr;
+    }
+
+    /* views have to start at a multiple of the allocation granularity */
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const size_t mappingOffset = offset - offset % info.dwAllocationGranularity;
+    mappingBytes = offset-mappingOffset+bytes;
+
+    HANDLE fileMapping = CreateFileMapping(file,nullptr,PAGE_READONLY,0,0,nullptr);
+    CloseHandle(file);
+    if (fileMapping == nullptr) throw std::bad_alloc();
+    mapping = MapViewOfFile(fileMapping,FILE_MAP_READ,DWORD(uint64_t(mappingOffset) >> 32),DWORD(mappingOffset & 0xFFFFFFFF),mappingBytes);
+    CloseHandle(fileMapping);
+    if (mapping == nullptr) throw std::bad_alloc();
+    return (char*)mapping + (offset-mappingOffset);
+  }
+
+  void os_unmap_file(void* mapping, size_t mappingBytes)
+  {
+    if (mapping)
+      UnmapViewOfFile(mapping);
+  }
+
+  void os_prefetch(void* ptr, size_t bytes)
+  {
+  }
 }
 
 #endif
@@ -173,6 +217,9 @@ namespace embree
 #if defined(__UNIX__)
 
 #include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include <errno.h>
 #include <stdlib.h>
 #include <string.h>
@@ -299,6 +346,54 @@ namespace embree
   {
 #if defined(MADV_HUGEPAGE)
     madvise(pptr,bytes,MADV_HUGEPAGE); 
+#endif
+  }
+
+  void* os_map_file(const char* fileName, size_t offset, size_t bytes, void*& mapping, size_t& mappingBytes)
+  {
+    int fd = open(fileName,O_RDONLY);
+    if (fd == -1)
+      throw std::runtime_error("cannot open file "+std::string(fileName));
+
+    struct stat st;
+    if (fstat(fd,&st) == -1 || offset > size_t(st.st_size) || bytes > size_t(st.st_size)-offset) {
+      close(fd);
+      throw std::runtime_error("range out of bounds of file "+std::string(fileName));
+    }
+
+    mapping = nullptr;
+    mappingBytes = 0;
+    if (bytes == 0) {
+      close(fd);
+      return nullptr;
+    }
+
+    /* the mapping has to start at a page boundary */
+    const size_t pageSize = sysconf(_SC_PAGESIZE);
+    const size_t mappingOffset = offset & ~(pageSize-1);
+    mappingBytes = offset-mappingOffset+bytes;
+    mapping = mmap(0, mappingBytes, PROT_READ, MAP_SHARED, fd, mappingOffset);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+      mapping = nullptr;
+      throw std::bad_alloc();
+    }
+    return (char*)mapping + (offset-mappingOffset);
+  }
+
+  void os_unmap_file(void* mapping, size_t mappingBytes)
+  {
+    if (mapping)
+      munmap(mapping,mappingBytes);
+  }
+
+  /* asynchronously reads the pages of a file mapping */
+  void os_prefetch(void* pptr, size_t bytes)
+  {
+#if defined(MADV_WILLNEED)
+    const size_t pageSize = sysconf(_SC_PAGESIZE);
+    char* begin = (char*) (size_t(pptr) & ~(pageSize-1));
+    madvise(begin,(char*)pptr+bytes-begin,MADV_WILLNEED);
 #endif
   }
 }
@@ -61,6 +61,11 @@ namespace embree
   void  os_free   (void* ptr, size_t bytes, bool hugepages);
   void  os_advise (void* ptr, size_t bytes);
 
+  /*! maps a byte range of a file read-only into memory */
+  void* os_map_file (const char* fileName, size_t offset, size_t bytes, void*& mapping, size_t& mappingBytes);
+  void  os_unmap_file (void* mapping, size_t mappingBytes);
+  void  os_prefetch (void* ptr, size_t bytes);
+
   /*! allocator that performs OS allocations */
   template<typename T>
     struct os_allocator
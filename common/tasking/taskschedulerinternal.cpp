@@ -264,6 +264,13 @@ namespace embree
     return threadPool->size();
   }
 
+  dll_export size_t TaskScheduler::activeThreadCount()
+  {
+    Thread* thread = TaskScheduler::thread();
+    if (thread) return thread->scheduler->anyTasksRunning;
+    else        return 0;
+  }
+
   dll_export TaskScheduler* TaskScheduler::instance()
   {
     if (g_instance == NULL) {
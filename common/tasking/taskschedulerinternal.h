@@ -332,6 +332,9 @@ namespace embree
     /* returns the total number of threads */
     dll_export static size_t threadCount();
 
+    /* returns the number of threads currently executing tasks of the task scheduler of the current thread */
+    dll_export static size_t activeThreadCount();
+
   private:
 
     /* returns the thread local task list of this worker thread */
@@ -39,6 +39,9 @@ RTC_API RTCBuffer rtcNewBuffer(RTCDevice device, size_t byteSize);
 /* Creates a new shared buffer. */
 RTC_API RTCBuffer rtcNewSharedBuffer(RTCDevice device, void* ptr, size_t byteSize);
 
+/* Creates a new read-only buffer that maps a byte range of a file. */
+RTC_API RTCBuffer rtcNewBufferFromFile(RTCDevice device, const char* fileName, size_t offset, size_t byteSize);
+
 /* Returns a pointer to the buffer data. */
 RTC_API void* rtcGetBufferData(RTCBuffer buffer);
 
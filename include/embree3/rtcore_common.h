@@ -172,7 +172,8 @@ enum RTCIntersectContextFlags
 {
   RTC_INTERSECT_CONTEXT_FLAG_NONE       = 0,
   RTC_INTERSECT_CONTEXT_FLAG_INCOHERENT = (0 << 0), // optimize for incoherent rays
-  RTC_INTERSECT_CONTEXT_FLAG_COHERENT   = (1 << 0)  // optimize for coherent rays
+  RTC_INTERSECT_CONTEXT_FLAG_COHERENT   = (1 << 0), // optimize for coherent rays
+  RTC_INTERSECT_CONTEXT_FLAG_RAY_CONES  = (1 << 1)  // coneWidth and coneSpread members of the context are valid
 };
 
 /* Arguments for RTCFilterFunctionN */
@@ -198,6 +199,8 @@ struct RTCIntersectContext
   unsigned int instStackSize;                        // Number of instances currently on the stack.
 #endif
   unsigned int instID[RTC_MAX_INSTANCE_LEVEL_COUNT]; // The current stack of instance ids.
+  float coneWidth;                                   // width of the ray cone at the ray origin
+  float coneSpread;                                  // increase of the ray cone width per unit distance along the ray
 };
 
 /* Initializes an intersection context. */
@@ -211,6 +214,8 @@ RTC_FORCEINLINE void rtcInitIntersectContext(struct RTCIntersectContext* context
 #endif
   for (; l < RTC_MAX_INSTANCE_LEVEL_COUNT; ++l)
     context->instID[l] = RTC_INVALID_GEOMETRY_ID;
+  context->coneWidth = 0.0f;
+  context->coneSpread = 0.0f;
 }
 
 /* Point query structure for closest point query */
@@ -255,6 +260,18 @@ struct RTC_ALIGN(64) RTCPointQuery16
 
 struct RTCPointQueryN;
 
+/* Result of a closest point query of rtcClosestPointBatch */
+struct RTCClosestPointHit
+{
+  float p_x;              // x coordinate of the closest point
+  float p_y;              // y coordinate of the closest point
+  float p_z;              // z coordinate of the closest point
+  float distance;         // distance from the query point to the closest point
+  unsigned int primID;    // primitive ID of the closest primitive
+  unsigned int geomID;    // geometry ID of the closest primitive
+  unsigned int instID[RTC_MAX_INSTANCE_LEVEL_COUNT]; // instance ID of the closest primitive
+};
+
 struct RTC_ALIGN(16) RTCPointQueryContext
 {
   // accumulated 4x4 column major matrices from world space to instance space.
@@ -47,7 +47,10 @@ enum RTCDeviceProperty
 
   RTC_DEVICE_PROPERTY_TASKING_SYSTEM        = 128,
   RTC_DEVICE_PROPERTY_JOIN_COMMIT_SUPPORTED = 129,
-  RTC_DEVICE_PROPERTY_PARALLEL_COMMIT_SUPPORTED = 130
+  RTC_DEVICE_PROPERTY_PARALLEL_COMMIT_SUPPORTED = 130,
+
+  RTC_DEVICE_PROPERTY_BLOCK_POOL_SIZE     = 160,
+  RTC_DEVICE_PROPERTY_BLOCK_POOL_MAX_SIZE = 161
 };
 
 /* Gets a device property. */
@@ -55,6 +58,29 @@ RTC_API ssize_t rtcGetDeviceProperty(RTCDevice device, enum RTCDeviceProperty pr
 
 /* Sets a device property. */
 RTC_API void rtcSetDeviceProperty(RTCDevice device, const enum RTCDeviceProperty prop, ssize_t value);
+
+/* Memory categories */
+enum RTCMemoryCategory
+{
+  RTC_MEMORY_CATEGORY_TOTAL              = 0,
+  RTC_MEMORY_CATEGORY_ACCEL_NODES        = 1,
+  RTC_MEMORY_CATEGORY_ACCEL_LEAVES       = 2,
+  RTC_MEMORY_CATEGORY_ACCEL_UNUSED       = 3,
+  RTC_MEMORY_CATEGORY_BUILD_TEMPORARIES  = 4,
+  RTC_MEMORY_CATEGORY_GEOMETRY_BUFFERS   = 5,
+  RTC_MEMORY_CATEGORY_TESSELLATION_CACHE = 6,
+  RTC_MEMORY_CATEGORY_BLOCK_POOL         = 7
+};
+
+/* Memory usage of a category */
+struct RTCMemoryUsage
+{
+  size_t bytes;     // number of bytes currently allocated
+  size_t peakBytes; // maximal number of bytes allocated at any time
+};
+
+/* Gets the memory usage of the device for some category. */
+RTC_API void rtcGetDeviceMemoryUsage(RTCDevice device, enum RTCMemoryCategory category, struct RTCMemoryUsage* usage);
   
 /* Error codes */
 enum RTCError
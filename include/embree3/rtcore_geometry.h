@@ -67,6 +67,14 @@ enum RTCCurveFlags
   RTC_CURVE_FLAG_NEIGHBOR_RIGHT = (1 << 1)  // right segment exists
 };
 
+/* Lattice of 16 bit quantized grid vertices */
+struct RTCVertexQuantization
+{
+  float origin_x, origin_y, origin_z; // origin of the lattice
+  float scale_x, scale_y, scale_z;    // spacing of the lattice
+  int offset_x, offset_y, offset_z;   // lattice coordinate of the vertex buffer origin
+};
+
 /* Arguments for RTCBoundsFunction */
 struct RTCBoundsFunctionArguments
 {
@@ -109,6 +117,12 @@ struct RTCOccludedFunctionNArguments
 /* Occlusion callback function */
 typedef void (*RTCOccludedFunctionN)(const struct RTCOccludedFunctionNArguments* args);
 
+/* Intersection callback function for a batch of primitives, args->primID is the first primitive of the batch */
+typedef void (*RTCIntersectFunctionBatch)(const struct RTCIntersectFunctionNArguments* args, const unsigned int* primIDs, unsigned int numPrimitives);
+
+/* Occlusion callback function for a batch of primitives, args->primID is the first primitive of the batch */
+typedef void (*RTCOccludedFunctionBatch)(const struct RTCOccludedFunctionNArguments* args, const unsigned int* primIDs, unsigned int numPrimitives);
+
 /* Arguments for RTCDisplacementFunctionN */
 struct RTCDisplacementFunctionNArguments
 {
@@ -209,6 +223,12 @@ RTC_API void rtcSetGeometryIntersectFunction(RTCGeometry geometry, RTCIntersectF
 /* Set the occlusion callback function of a user geometry. */
 RTC_API void rtcSetGeometryOccludedFunction(RTCGeometry geometry, RTCOccludedFunctionN occluded);
 
+/* Set the intersect callback function of a user geometry that processes a batch of primitives per invocation. */
+RTC_API void rtcSetGeometryIntersectFunctionBatch(RTCGeometry geometry, RTCIntersectFunctionBatch intersect);
+
+/* Set the occlusion callback function of a user geometry that processes a batch of primitives per invocation. */
+RTC_API void rtcSetGeometryOccludedFunctionBatch(RTCGeometry geometry, RTCOccludedFunctionBatch occluded);
+
 /* Invokes the intersection filter from the intersection callback function. */
 RTC_API void rtcFilterIntersection(const struct RTCIntersectFunctionNArguments* args, const struct RTCFilterFunctionNArguments* filterArgs);
 
@@ -232,6 +252,12 @@ RTC_API void rtcGetGeometryTransform(RTCGeometry geometry, float time, enum RTCF
 /* Sets the uniform tessellation rate of the geometry. */
 RTC_API void rtcSetGeometryTessellationRate(RTCGeometry geometry, float tessellationRate);
 
+/* Sets a ray cone to derive view dependent tessellation levels of the geometry from. */
+RTC_API void rtcSetGeometryTessellationCone(RTCGeometry geometry, float org_x, float org_y, float org_z, float width, float spread);
+
+/* Sets the lattice to decode the 16 bit quantized vertices of a grid geometry. */
+RTC_API void rtcSetGeometryVertexQuantization(RTCGeometry geometry, const struct RTCVertexQuantization* quantization);
+
 /* Sets the number of topologies of a subdivision surface. */
 RTC_API void rtcSetGeometryTopologyCount(RTCGeometry geometry, unsigned int topologyCount);
 
@@ -366,6 +392,9 @@ struct RTCInterpolateNArguments
 /* Interpolates vertex data to an array of u/v locations. */
 RTC_API void rtcInterpolateN(const struct RTCInterpolateNArguments* args);
 
+/* Interpolates vertex data to a large batch of u/v locations, evaluating each primitive once for all its locations. */
+RTC_API void rtcInterpolateBatch(const struct RTCInterpolateNArguments* args);
+
 /* RTCGrid primitive for grid mesh */
 struct RTCGrid
 {
@@ -79,6 +79,9 @@ RTC_API void rtcGetSceneBounds(RTCScene scene, struct RTCBounds* bounds_o);
 /* Returns the linear axis-aligned bounds of the scene. */
 RTC_API void rtcGetSceneLinearBounds(RTCScene scene, struct RTCLinearBounds* bounds_o);
 
+/* Gets the memory usage of the acceleration structures of the scene for some category. */
+RTC_API void rtcGetSceneMemoryUsage(RTCScene scene, enum RTCMemoryCategory category, struct RTCMemoryUsage* usage);
+
 /* Perform a closest point query of the scene. */
 RTC_API bool rtcPointQuery(RTCScene scene, struct RTCPointQuery* query, struct RTCPointQueryContext* context, RTCPointQueryFunction queryFunc, void* userPtr);
 
@@ -91,6 +94,9 @@ RTC_API bool rtcPointQuery8(const int* valid, RTCScene scene, struct RTCPointQue
 /* Perform a closest point query with a packet of 4 points with the scene. */
 RTC_API bool rtcPointQuery16(const int* valid, RTCScene scene, struct RTCPointQuery16* query, struct RTCPointQueryContext* context, RTCPointQueryFunction queryFunc, void** userPtr);
 
+/* Finds the closest triangle or quad mesh point of the scene for an array of query points. */
+RTC_API void rtcClosestPointBatch(RTCScene scene, const struct RTCPointQuery* queries, struct RTCClosestPointHit* hits, size_t N);
+
 /* Intersects a single ray with the scene. */
 RTC_API void rtcIntersect1(RTCScene scene, struct RTCIntersectContext* context, struct RTCRayHit* rayhit);
 
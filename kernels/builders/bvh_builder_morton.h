@@ -5,6 +5,7 @@
 
 #include "../common/builder.h"
 #include "../../common/algorithms/parallel_reduce.h"
+#include "../../common/algorithms/parallel_sort.h"
 
 namespace embree
 {
@@ -20,11 +21,11 @@ namespace embree
       {
         /*! default settings */
         Settings ()
-        : branchingFactor(2), maxDepth(32), minLeafSize(1), maxLeafSize(7), singleThreadThreshold(1024) {}
+        : branchingFactor(2), maxDepth(32), minLeafSize(1), maxLeafSize(7), singleThreadThreshold(1024), mortonCodeBits(32) {}
 
         /*! initialize settings from API settings */
         Settings (const RTCBuildArguments& settings)
-        : branchingFactor(2), maxDepth(32), minLeafSize(1), maxLeafSize(7), singleThreadThreshold(1024)
+        : branchingFactor(2), maxDepth(32), minLeafSize(1), maxLeafSize(7), singleThreadThreshold(1024), mortonCodeBits(32)
         {
           if (RTC_BUILD_ARGUMENTS_HAS(settings,maxBranchingFactor)) branchingFactor = settings.maxBranchingFactor;
           if (RTC_BUILD_ARGUMENTS_HAS(settings,maxDepth          )) maxDepth        = settings.maxDepth;
@@ -34,8 +35,8 @@ namespace embree
           minLeafSize = min(minLeafSize,maxLeafSize);
         }
 
-        Settings (size_t branchingFactor, size_t maxDepth, size_t minLeafSize, size_t maxLeafSize, size_t singleThreadThreshold)
-        : branchingFactor(branchingFactor), maxDepth(maxDepth), minLeafSize(minLeafSize), maxLeafSize(maxLeafSize), singleThreadThreshold(singleThreadThreshold)
+        Settings (size_t branchingFactor, size_t maxDepth, size_t minLeafSize, size_t maxLeafSize, size_t singleThreadThreshold, size_t mortonCodeBits = 32)
+        : branchingFactor(branchingFactor), maxDepth(maxDepth), minLeafSize(minLeafSize), maxLeafSize(maxLeafSize), singleThreadThreshold(singleThreadThreshold), mortonCodeBits(mortonCodeBits)
         {
           minLeafSize = min(minLeafSize,maxLeafSize);
         }
@@ -46,6 +47,7 @@ namespace embree
         size_t minLeafSize;      //!< minimum size of a leaf
         size_t maxLeafSize;      //!< maximum size of a leaf
         size_t singleThreadThreshold; //!< threshold when we switch to single threaded build
+        size_t mortonCodeBits;   //!< 32 bit codes with 10 bits per dimension or 64 bit codes with 21 bits per dimension
       };
 
       /*! Build primitive consisting of morton code and primitive ID. */
@@ -66,6 +68,20 @@ namespace embree
         __forceinline bool operator<(const BuildPrim &m) const { return code < m.code; }
       };
 
+      /*! Build primitive with 64 bit morton code, used by the builder when 64 bit codes are enabled. */
+      struct __aligned(16) BuildPrim64
+      {
+        uint64_t code;         //!< morton code
+        unsigned int index;    //!< i'th primitive
+        unsigned int align;
+
+        /*! interface for radix sort */
+        __forceinline operator uint64_t() const { return code; }
+
+        /*! interface for standard sort */
+        __forceinline bool operator<(const BuildPrim64 &m) const { return code < m.code; }
+      };
+
       /*! maps bounding box to morton code */
       struct MortonCodeMapping
       {
@@ -101,6 +117,40 @@ namespace embree
         }
       };
 
+      /*! maps bounding box to 64 bit morton code */
+      struct MortonCodeMapping64
+      {
+        static const size_t LATTICE_BITS_PER_DIM = 21;
+        static const size_t LATTICE_SIZE_PER_DIM = size_t(1) << LATTICE_BITS_PER_DIM;
+
+        vfloat4 base;
+        vfloat4 scale;
+
+        __forceinline MortonCodeMapping64(const BBox3fa& bounds)
+        {
+          base  = (vfloat4)bounds.lower;
+          const vfloat4 diag  = (vfloat4)bounds.upper - (vfloat4)bounds.lower;
+          scale = select(diag > vfloat4(1E-19f), rcp(diag) * vfloat4(LATTICE_SIZE_PER_DIM * 0.99f),vfloat4(0.0f));
+        }
+
+        __forceinline const vint4 bin (const BBox3fa& box) const
+        {
+          const vfloat4 lower = (vfloat4)box.lower;
+          const vfloat4 upper = (vfloat4)box.upper;
+          const vfloat4 centroid = lower+upper;
+          return vint4((centroid-base)*scale);
+        }
+
+        __forceinline uint64_t code (const BBox3fa& box) const
+        {
+          const vint4 binID = bin(box);
+          const uint64_t x = extract<0>(binID);
+          const uint64_t y = extract<1>(binID);
+          const uint64_t z = extract<2>(binID);
+          return bitInterleave64(x,y,z);
+        }
+      };
+
 #if defined (__AVX2__)
 
       /*! for AVX2 there is a fast scalar bitInterleave */
@@ -202,7 +252,7 @@ namespace embree
           createLeaf(createLeaf),
           calculateBounds(calculateBounds),
           progressMonitor(progressMonitor),
-          morton(nullptr) {}
+          morton(nullptr), morton64(nullptr) {}
 
         ReductionTy createLargeLeaf(size_t depth, const range<unsigned>& current, Allocator alloc)
         {
@@ -261,7 +311,8 @@ namespace embree
         }
 
         /*! recreates morton codes when reaching a region where all codes are identical */
-        __noinline void recreateMortonCodes(const range<unsigned>& current) const
+        template<typename Mapping, typename Prim>
+        __noinline void recreateMortonCodes(Prim* prims, const range<unsigned>& current) const
         {
           /* fast path for small ranges */
           if (likely(current.size() < 1024))
@@ -272,12 +323,12 @@ namespace embree
               centBounds.extend(center2(calculateBounds(morton[i])));
 
             /* recalculate morton codes */
-            MortonCodeMapping mapping(centBounds);
+            Mapping mapping(centBounds);
             for (size_t i=current.begin(); i<current.end(); i++)
-              morton[i].code = mapping.code(calculateBounds(morton[i]));
+              prims[i].code = mapping.code(calculateBounds(morton[i]));
 
             /* sort morton codes */
-            std::sort(morton+current.begin(),morton+current.end());
+            std::sort(prims+current.begin(),prims+current.end());
           }
           else
           {
@@ -292,59 +343,79 @@ namespace embree
                                                        BBox3fa(empty), calculateCentBounds, BBox3fa::merge);
 
             /* recalculate morton codes */
-            MortonCodeMapping mapping(centBounds);
+            Mapping mapping(centBounds);
             parallel_for(current.begin(), current.end(), unsigned(1024), [&] ( const range<unsigned>& r ) {
                 for (size_t i=r.begin(); i<r.end(); i++) {
-                  morton[i].code = mapping.code(calculateBounds(morton[i]));
+                  prims[i].code = mapping.code(calculateBounds(morton[i]));
                 }
               });
 
             /*! sort morton codes */
 #if defined(TASKING_TBB)
-            tbb::parallel_sort(morton+current.begin(),morton+current.end());
+            tbb::parallel_sort(prims+current.begin(),prims+current.end());
 #else
-            radixsort32(morton+current.begin(),current.size());
+            sortMortonCodes(prims+current.begin(),current.size());
 #endif
           }
+
+          /* the primitive order of the 64 bit codes is also the order of the build primitives */
+          if ((void*)prims != (void*)morton) {
+            for (size_t i=current.begin(); i<current.end(); i++)
+              morton[i].index = prims[i].index;
+          }
+        }
+
+        static __forceinline void sortMortonCodes(BuildPrim* prims, size_t N) {
+          radixsort32(prims,N);
+        }
+
+        /* identical 64 bit codes are rare, thus a plain sort suffices */
+        static __forceinline void sortMortonCodes(BuildPrim64* prims, size_t N) {
+          std::sort(prims,prims+N);
         }
 
         __forceinline void split(const range<unsigned>& current, range<unsigned>& left, range<unsigned>& right) const
         {
-          const unsigned int code_start = morton[current.begin()].code;
-          const unsigned int code_end   = morton[current.end()-1].code;
-          unsigned int bitpos = lzcnt(code_start^code_end);
+          if (morton64) split<MortonCodeMapping64>(morton64,current,left,right);
+          else          split<MortonCodeMapping  >(morton  ,current,left,right);
+        }
+
+        template<typename Mapping, typename Prim>
+        __forceinline void split(Prim* prims, const range<unsigned>& current, range<unsigned>& left, range<unsigned>& right) const
+        {
+          typedef decltype(prims->code) Code;
+          Code code_start = prims[current.begin()].code;
+          Code code_end   = prims[current.end()-1].code;
 
           /* if all items mapped to same morton code, then re-create new morton codes for the items */
-          if (unlikely(bitpos == 32))
+          if (unlikely(code_start == code_end))
           {
-            recreateMortonCodes(current);
-            const unsigned int code_start = morton[current.begin()].code;
-            const unsigned int code_end   = morton[current.end()-1].code;
-            bitpos = lzcnt(code_start^code_end);
+            recreateMortonCodes<Mapping>(prims,current);
+            code_start = prims[current.begin()].code;
+            code_end   = prims[current.end()-1].code;
 
             /* if the morton code is still the same, goto fall back split */
-            if (unlikely(bitpos == 32)) {
+            if (unlikely(code_start == code_end)) {
               current.split(left,right);
               return;
             }
           }
 
           /* split the items at the topmost different morton code bit */
-          const unsigned int bitpos_diff = 31-bitpos;
-          const unsigned int bitmask = 1 << bitpos_diff;
+          const Code bitmask = Code(1) << bsr(code_start^code_end);
 
           /* find location where bit differs using binary search */
           unsigned begin = current.begin();
           unsigned end   = current.end();
           while (begin + 1 != end) {
             const unsigned mid = (begin+end)/2;
-            const unsigned bit = morton[mid].code & bitmask;
+            const Code bit = prims[mid].code & bitmask;
             if (bit == 0) begin = mid; else end = mid;
           }
           unsigned center = end;
 #if defined(DEBUG)
-          for (unsigned int i=begin;  i<center; i++) assert((morton[i].code & bitmask) == 0);
-          for (unsigned int i=center; i<end;    i++) assert((morton[i].code & bitmask) == bitmask);
+          for (unsigned int i=begin;  i<center; i++) assert((prims[i].code & bitmask) == 0);
+          for (unsigned int i=center; i<end;    i++) assert((prims[i].code & bitmask) == bitmask);
 #endif
 
           left = make_range(current.begin(),center);
@@ -433,8 +504,11 @@ namespace embree
         /* build function */
         ReductionTy build(BuildPrim* src, BuildPrim* tmp, size_t numPrimitives)
         {
-          /* sort morton codes */
           morton = src;
+          if (mortonCodeBits == 64)
+            return build64(src,numPrimitives);
+          
+          /* sort morton codes */
           radix_sort_u32(src,tmp,numPrimitives,singleThreadThreshold);
 
           /* build BVH */
@@ -443,6 +517,46 @@ namespace embree
           return root;
         }
 
+        /* builds with 64 bit morton codes, the build primitives only provide the primitive indices */
+        ReductionTy build64(BuildPrim* src, size_t numPrimitives)
+        {
+          /* calculate centroid bounds */
+          const BBox3fa centBounds = parallel_reduce(size_t(0), numPrimitives, size_t(1024), BBox3fa(empty), [&] (const range<size_t>& r) {
+              BBox3fa centBounds = empty;
+              for (size_t i=r.begin(); i<r.end(); i++)
+                centBounds.extend(center2(calculateBounds(src[i])));
+              return centBounds;
+            }, BBox3fa::merge);
+
+          /* create 64 bit morton codes */
+          avector<BuildPrim64> codes(numPrimitives);
+          avector<BuildPrim64> codes_tmp(numPrimitives);
+          const MortonCodeMapping64 mapping(centBounds);
+          parallel_for(size_t(0), numPrimitives, size_t(1024), [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) {
+                codes[i].code = mapping.code(calculateBounds(src[i]));
+                codes[i].index = src[i].index;
+              }
+            });
+
+          /* sort morton codes and reorder the build primitives accordingly */
+          radix_sort_u64(codes.data(),codes_tmp.data(),numPrimitives,singleThreadThreshold);
+          parallel_for(size_t(0), numPrimitives, size_t(1024), [&] (const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++) {
+                src[i].code = unsigned(codes[i].code >> 32);
+                src[i].index = codes[i].index;
+              }
+            });
+          codes_tmp.clear();
+
+          /* build BVH */
+          morton64 = codes.data();
+          const ReductionTy root = recurse(1, range<unsigned>(0,(unsigned)numPrimitives), nullptr, true);
+          _mm_mfence(); // to allow non-temporal stores during build
+          morton64 = nullptr;
+          return root;
+        }
+
       public:
         CreateAllocator& createAllocator;
         CreateNodeFunc& createNode;
@@ -453,6 +567,7 @@ namespace embree
 
       public:
         BuildPrim* morton;
+        BuildPrim64* morton64;   //!< 64 bit morton codes in the order of the build primitives if enabled
       };
 
 
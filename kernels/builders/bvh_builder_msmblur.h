@@ -176,6 +176,31 @@ namespace embree
 
     struct BVHBuilderMSMBlur
     {
+      /*! statistics about the temporal splits performed by the builder */
+      struct TemporalSplitStatistics
+      {
+        TemporalSplitStatistics ()
+        : numTemporalSplits(0), numSkippedMotion(0), numSkippedBudget(0), numReplicatedPrims(0), numPrims(0), budget(0) {}
+
+        void print(std::ostream& cout) const
+        {
+          cout << "  temporal splits = " << numTemporalSplits << ", ";
+          cout << "skipped (low motion) = " << numSkippedMotion << ", ";
+          cout << "skipped (budget) = " << numSkippedBudget << std::endl;
+          cout << "  replicated primrefs = " << numReplicatedPrims << " (" << 100.0*double(numReplicatedPrims)/double(max(numPrims,size_t(1))) << "% of " << numPrims << " primrefs";
+          if (budget != size_t(inf)) cout << ", budget = " << budget;
+          cout << ")" << std::endl;
+        }
+
+      public:
+        std::atomic<size_t> numTemporalSplits;  //!< number of temporal splits performed
+        std::atomic<size_t> numSkippedMotion;   //!< number of temporal splits rejected as primitives move too little
+        std::atomic<size_t> numSkippedBudget;   //!< number of temporal splits rejected as replication budget got exhausted
+        std::atomic<size_t> numReplicatedPrims; //!< number of additional primrefs created through temporal splits
+        size_t numPrims;                        //!< number of primrefs the build started with
+        size_t budget;                          //!< maximal number of additional primrefs
+      };
+
       /*! settings for msmblur builder */
       struct Settings
       {
@@ -183,12 +208,13 @@ namespace embree
         Settings ()
         : branchingFactor(2), maxDepth(32), logBlockSize(0), minLeafSize(1), maxLeafSize(8),
           travCost(1.0f), intCost(1.0f), singleLeafTimeSegment(false),
-          singleThreadThreshold(1024) {}
+          singleThreadThreshold(1024), maxTimeSplitReplications(inf), minTimeSplitMotion(0.0f), stats(nullptr) {}
 
 
         Settings (size_t sahBlockSize, size_t minLeafSize, size_t maxLeafSize, float travCost, float intCost, size_t singleThreadThreshold)
         : branchingFactor(2), maxDepth(32), logBlockSize(bsr(sahBlockSize)), minLeafSize(minLeafSize), maxLeafSize(maxLeafSize),
-          travCost(travCost), intCost(intCost), singleThreadThreshold(singleThreadThreshold)
+          travCost(travCost), intCost(intCost), singleThreadThreshold(singleThreadThreshold),
+          maxTimeSplitReplications(inf), minTimeSplitMotion(0.0f), stats(nullptr)
         {
           minLeafSize = min(minLeafSize,maxLeafSize);
         }
@@ -203,6 +229,9 @@ namespace embree
         float intCost;           //!< estimated cost of one primitive intersection
         bool singleLeafTimeSegment; //!< split time to single time range
         size_t singleThreadThreshold; //!< threshold when we switch to single threaded build
+        float maxTimeSplitReplications; //!< temporal splits may create at most maxTimeSplitReplications*N additional primrefs
+        float minTimeSplitMotion;     //!< temporal splits are only considered for subtrees whose average motion magnitude (in [0,1]) exceeds this value
+        TemporalSplitStatistics* stats; //!< optional statistics about the temporal splits performed
       };
 
       struct BuildRecord
@@ -279,10 +308,68 @@ namespace embree
             heuristicObjectSplit(),
             heuristicTemporalSplit(device, recalculatePrimRef),
             recalculatePrimRef(recalculatePrimRef), createAlloc(createAlloc), createNode(createNode), setNode(setNode), createLeaf(createLeaf),
-            progressMonitor(progressMonitor)
+            progressMonitor(progressMonitor), timeSplitBudget(0)
           {
             if (cfg.branchingFactor > MAX_BRANCHING_FACTOR)
               throw_RTCError(RTC_ERROR_UNKNOWN,"bvh_builder: branching factor too large");
+
+            if (cfg.stats == nullptr)
+              cfg.stats = &localStats;
+          }
+
+          /*! calculates the average fraction of the swept primitive bounds not covered by the bounds at the ends of the time range */
+          float motionMagnitude(const SetMB& set)
+          {
+            const PrimRefMB* prims = set.prims->data();
+            auto reduce = [&] (const range<size_t>& r) -> float
+            {
+              float growth = 0.0f;
+              for (size_t i=r.begin(); i<r.end(); i++)
+              {
+                const LBBox3fa& lbounds = prims[i].lbounds;
+                const float areaT = halfArea(merge(lbounds.bounds0,lbounds.bounds1));
+                if (areaT <= 0.0f) continue;
+                growth += 1.0f - 0.5f*(halfArea(lbounds.bounds0)+halfArea(lbounds.bounds1))/areaT;
+              }
+              return growth;
+            };
+            const float growth = parallel_reduce(set.begin(),set.end(),size_t(1024),size_t(4096),0.0f,reduce,[](float a, float b) { return a+b; });
+            return growth/float(max(set.size(),size_t(1)));
+          }
+
+          /*! checks if the adaptive temporal split criteria allow splitting the set in time */
+          bool allowTemporalSplit(const SetMB& set)
+          {
+            /* a temporal split replicates at most all primitives of the set */
+            if (cfg.stats->numReplicatedPrims + set.size() > timeSplitBudget) {
+              cfg.stats->numSkippedBudget++;
+              return false;
+            }
+
+            /* skip temporal splits for subtrees whose primitives move too little in the time range of the subtree */
+            if (cfg.minTimeSplitMotion > 0.0f && motionMagnitude(set) < cfg.minTimeSplitMotion) {
+              cfg.stats->numSkippedMotion++;
+              return false;
+            }
+            return true;
+          }
+
+          /*! reserves budget for replicating all primitives of the set, the unused part is returned when the split is performed */
+          bool reserveTemporalSplit(const SetMB& set)
+          {
+            if (cfg.stats->numReplicatedPrims.fetch_add(set.size()) + set.size() <= timeSplitBudget)
+              return true;
+
+            cfg.stats->numReplicatedPrims -= set.size();
+            cfg.stats->numSkippedBudget++;
+            return false;
+          }
+
+          /*! returns the budget reserved for a temporal split that did not get performed */
+          __forceinline void releaseTemporalSplit(const Split& split, const SetMB& set)
+          {
+            if (split.data == Split::SPLIT_TEMPORAL)
+              cfg.stats->numReplicatedPrims -= set.size();
           }
 
           /*! finds the best split */
@@ -298,21 +385,21 @@ namespace embree
               return object_split;
 
             /* do temporal splits only if the the time range is big enough */
-            if (set.time_range.size() > 1.01f/float(set.max_num_time_segments))
+            if (set.time_range.size() > 1.01f/float(set.max_num_time_segments) && allowTemporalSplit(set))
             {
               const Split temporal_split = heuristicTemporalSplit.find(set,cfg.logBlockSize);
               const float temporal_split_sah = temporal_split.splitSAH();
 
-              /* take temporal split if it improved SAH */
-              if (temporal_split_sah < object_split_sah)
+              /* take temporal split if it improved SAH and fits into the budget */
+              if (temporal_split_sah < object_split_sah && reserveTemporalSplit(set))
                 return temporal_split;
             }
 
             return object_split;
           }
 
-          /*! array partitioning */
-          __forceinline std::unique_ptr<mvector<PrimRefMB>> split(const Split& split, const SetMB& set, SetMB& lset, SetMB& rset)
+          /*! array partitioning, temporal splits returned by find have their budget already reserved */
+          __forceinline std::unique_ptr<mvector<PrimRefMB>> split(const Split& split, const SetMB& set, SetMB& lset, SetMB& rset, bool reserved)
           {
             /* perform object split */
             if (likely(split.data == Split::SPLIT_OBJECT)) {
@@ -320,7 +407,12 @@ namespace embree
             }
             /* perform temporal split */
             else if (likely(split.data == Split::SPLIT_TEMPORAL)) {
-              return heuristicTemporalSplit.split(split,set,lset,rset);
+              std::unique_ptr<mvector<PrimRefMB>> new_vector = heuristicTemporalSplit.split(split,set,lset,rset);
+              const size_t replicated = lset.size()+rset.size()-set.size();
+              cfg.stats->numTemporalSplits++;
+              if (reserved) cfg.stats->numReplicatedPrims -= set.size()-replicated;
+              else          cfg.stats->numReplicatedPrims += replicated;
+              return new_vector;
             }
             /* perform fallback split */
             else if (unlikely(split.data == Split::SPLIT_FALLBACK)) {
@@ -480,7 +572,7 @@ namespace embree
               BuildRecordSplit& brecord = children[bestChild];
               BuildRecordSplit lrecord(current.depth+1);
               BuildRecordSplit rrecord(current.depth+1);
-              std::unique_ptr<mvector<PrimRefMB>> new_vector = split(brecord.split,brecord.prims,lrecord.prims,rrecord.prims);
+              std::unique_ptr<mvector<PrimRefMB>> new_vector = split(brecord.split,brecord.prims,lrecord.prims,rrecord.prims,false);
               hasTimeSplits |= new_vector != nullptr;
 
               /* find new splits */
@@ -536,13 +628,14 @@ namespace embree
 
             /*! create a leaf node when threshold reached or SAH tells us to stop */
             if (current.size() <= cfg.minLeafSize || current.depth+MIN_LARGE_LEAF_LEVELS >= cfg.maxDepth || (current.size() <= cfg.maxLeafSize && leafSAH <= splitSAH)) {
+              releaseTemporalSplit(csplit,current.prims);
               current.prims.deterministic_order();
               return createLargeLeaf(current,alloc);
             }
 
             /*! perform initial split */
             SetMB lprims,rprims;
-            std::unique_ptr<mvector<PrimRefMB>> new_vector = split(csplit,current.prims,lprims,rprims);
+            std::unique_ptr<mvector<PrimRefMB>> new_vector = split(csplit,current.prims,lprims,rprims,true);
             bool hasTimeSplits = new_vector != nullptr;
             NodeRecordMB4D values[MAX_BRANCHING_FACTOR];
             LocalChildList children(current);
@@ -572,7 +665,7 @@ namespace embree
               BuildRecord lrecord(current.depth+1);
               BuildRecord rrecord(current.depth+1);
               Split csplit = find(brecord.prims);
-              std::unique_ptr<mvector<PrimRefMB>> new_vector = split(csplit,brecord.prims,lrecord.prims,rrecord.prims);
+              std::unique_ptr<mvector<PrimRefMB>> new_vector = split(csplit,brecord.prims,lrecord.prims,rrecord.prims,true);
               hasTimeSplits |= new_vector != nullptr;
               children.split(bestChild,lrecord,rrecord,std::move(new_vector));
             }
@@ -629,6 +722,15 @@ namespace embree
           __forceinline const NodeRecordMB4D operator() (mvector<PrimRefMB>& prims, const PrimInfoMB& pinfo)
           {
             const SetMB set(pinfo,&prims);
+
+            /* negative and NaN replication factors disable temporal splits, too large factors do not limit them */
+            const double budget = double(cfg.maxTimeSplitReplications)*double(pinfo.size());
+            if (!(budget > 0.0)) timeSplitBudget = 0;
+            else if (budget >= double(size_t(inf)/2)) timeSplitBudget = size_t(inf);
+            else timeSplitBudget = size_t(budget);
+
+            cfg.stats->numPrims = pinfo.size();
+            cfg.stats->budget = timeSplitBudget;
             auto ret = recurse(BuildRecord(set,1),nullptr,true);
             _mm_mfence(); // to allow non-temporal stores during build
             return ret;
@@ -644,6 +746,8 @@ namespace embree
           const SetNodeFunc setNode;
           const CreateLeafFunc createLeaf;
           const ProgressMonitor progressMonitor;
+          size_t timeSplitBudget;
+          TemporalSplitStatistics localStats;
         };
 
       template<typename NodeRef,
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "heuristic_binning_array_aligned.h"
+#include "heuristic_binning_array_compact.h"
 #include "heuristic_spatial_array.h"
 #include "heuristic_openmerge_array.h"
 
@@ -26,7 +27,113 @@ namespace embree
     {
       static const size_t MAX_BRANCHING_FACTOR = 16;       //!< maximum supported BVH branching factor      
       static const size_t MIN_LARGE_LEAF_LEVELS = 8;       //!< create balanced tree of we are that many levels before the maximum tree depth
-      
+
+      /*! chooses the size of subtrees that get built sequentially from the
+       *  number of primitives not built yet, the number of idle threads,
+       *  and the measured build time of the sequential subtrees built so far */
+      struct SingleThreadThresholdTuner
+      {
+        static const size_t MIN_THRESHOLD = 128;                 //!< never create sequential subtrees smaller than this
+        static const size_t TASKS_PER_THREAD = 4;                //!< number of subtrees per thread for load balancing
+        static const size_t MIN_TASK_NANOSECONDS = 100*1000;     //!< sequential subtrees should amortize the task overhead
+        static const size_t DEFAULT_NANOSECONDS_PER_PRIM_LEVEL = 40; //!< cost estimate until the first subtree got measured
+
+        SingleThreadThresholdTuner (size_t numPrimitives, size_t minThreshold)
+          : minThreshold(max(minThreshold,MIN_THRESHOLD)), numPrims(numPrimitives),
+            numThreads(max(TaskScheduler::threadCount(),size_t(1))),
+            numActiveThreads(min(activeThreadCount(),numThreads)),
+            remaining(numPrimitives), nanoseconds(0), primLevels(0), numSubtrees(0),
+            minChosen(inf), maxChosen(0) {}
+
+        /*! number of threads currently executing tasks, only the internal
+         *  task scheduler tracks this, with TBB, PPL, and GCD all other
+         *  threads are assumed to be idle */
+        static __forceinline size_t activeThreadCount()
+        {
+#if defined(TASKING_INTERNAL)
+          return TaskScheduler::activeThreadCount();
+#else
+          return 1;
+#endif
+        }
+
+        /*! approximate number of tree levels of a subtree */
+        static __forceinline size_t levels(size_t N) {
+          return 1+bsr((N >> 2) | 1);
+        }
+
+        /*! measured nanoseconds per primitive and tree level of the sequential subtrees */
+        __forceinline double nanosecondsPerPrimLevel() const
+        {
+          /* keep the estimate as long as the subtrees built so far were too fast for the clock resolution */
+          const size_t measured = primLevels;
+          const size_t ns = nanoseconds;
+          if (measured == 0 || ns == 0) return double(DEFAULT_NANOSECONDS_PER_PRIM_LEVEL);
+          return max(double(ns)/double(measured),0.1);
+        }
+
+        /*! smallest subtree that amortizes the task overhead */
+        __forceinline size_t grainSize() const
+        {
+          const double c = nanosecondsPerPrimLevel();
+          size_t grain = minThreshold;
+          while (c*double(grain)*double(levels(grain)) < double(MIN_TASK_NANOSECONDS)) grain *= 2;
+          return grain;
+        }
+
+        /*! subtrees of up to this many primitives get built sequentially */
+        size_t threshold()
+        {
+          /* the build may use the threads that were idle at its start and all threads that got idle since then */
+          const size_t active = min(activeThreadCount(),numThreads);
+          const size_t idle = numThreads - min(active,numActiveThreads);
+          const size_t share = remaining / (TASKS_PER_THREAD*(idle+1));
+          const size_t t = max(grainSize(),share);
+          for (size_t m=minChosen; t<m && !minChosen.compare_exchange_weak(m,t);) ;
+          for (size_t m=maxChosen; t>m && !maxChosen.compare_exchange_weak(m,t);) ;
+          return t;
+        }
+
+        /*! builds a subtree sequentially and measures its cost */
+        template<typename Closure>
+        __forceinline auto sequential(size_t N, const Closure& closure) -> decltype(closure())
+        {
+          const double t0 = getSeconds();
+          auto ret = closure();
+          const double t1 = getSeconds();
+          addSubtree(N,t1-t0);
+          return ret;
+        }
+
+        /*! accounts a sequential subtree of N primitives that took the given time to build */
+        void addSubtree(size_t N, double seconds)
+        {
+          nanoseconds += size_t(max(seconds,0.0)*1E9);
+          primLevels += N*levels(N);
+          numSubtrees++;
+          for (size_t r=remaining; !remaining.compare_exchange_weak(r,r-min(N,r));) ;
+        }
+
+        void print(std::ostream& cout) const
+        {
+          cout << "  single thread threshold = [" << (numSubtrees ? minChosen.load() : 0) << ", " << maxChosen << "], ";
+          cout << "threads = " << numThreads << " (" << numThreads-numActiveThreads << " idle at start), ";
+          cout << "sequential subtrees = " << numSubtrees << ", ";
+          cout << "ns per prim and level = " << nanosecondsPerPrimLevel() << std::endl;
+        }
+
+      public:
+        const size_t minThreshold;           //!< lower bound for the threshold, e.g. to limit the thread local allocation overhead
+        const size_t numPrims;               //!< number of primitives of the build
+        const size_t numThreads;             //!< total number of threads
+        const size_t numActiveThreads;       //!< number of threads busy when the build started
+        std::atomic<size_t> remaining;       //!< number of primitives not yet built by some sequential subtree
+        std::atomic<size_t> nanoseconds;     //!< nanoseconds spent in sequential subtrees
+        std::atomic<size_t> primLevels;      //!< sum of primitives times tree levels of sequential subtrees
+        std::atomic<size_t> numSubtrees;     //!< number of sequential subtrees
+        std::atomic<size_t> minChosen;       //!< smallest threshold chosen
+        std::atomic<size_t> maxChosen;       //!< largest threshold chosen
+      };
 
       /*! settings for SAH builder */
       struct Settings
@@ -34,12 +141,12 @@ namespace embree
         /*! default settings */
         Settings ()
         : branchingFactor(2), maxDepth(32), logBlockSize(0), minLeafSize(1), maxLeafSize(7),
-          travCost(1.0f), intCost(1.0f), singleThreadThreshold(1024), primrefarrayalloc(inf) {}
+          travCost(1.0f), intCost(1.0f), singleThreadThreshold(1024), primrefarrayalloc(inf), tuner(nullptr) {}
 
         /*! initialize settings from API settings */
         Settings (const RTCBuildArguments& settings)
         : branchingFactor(2), maxDepth(32), logBlockSize(0), minLeafSize(1), maxLeafSize(7),
-          travCost(1.0f), intCost(1.0f), singleThreadThreshold(1024), primrefarrayalloc(inf)
+          travCost(1.0f), intCost(1.0f), singleThreadThreshold(1024), primrefarrayalloc(inf), tuner(nullptr)
         {
           if (RTC_BUILD_ARGUMENTS_HAS(settings,maxBranchingFactor)) branchingFactor = settings.maxBranchingFactor;
           if (RTC_BUILD_ARGUMENTS_HAS(settings,maxDepth          )) maxDepth        = settings.maxDepth;
@@ -54,7 +161,7 @@ namespace embree
 
         Settings (size_t sahBlockSize, size_t minLeafSize, size_t maxLeafSize, float travCost, float intCost, size_t singleThreadThreshold, size_t primrefarrayalloc = inf)
         : branchingFactor(2), maxDepth(32), logBlockSize(bsr(sahBlockSize)), minLeafSize(minLeafSize), maxLeafSize(maxLeafSize),
-          travCost(travCost), intCost(intCost), singleThreadThreshold(singleThreadThreshold), primrefarrayalloc(primrefarrayalloc)
+          travCost(travCost), intCost(intCost), singleThreadThreshold(singleThreadThreshold), primrefarrayalloc(primrefarrayalloc), tuner(nullptr)
         {
           minLeafSize = min(minLeafSize,maxLeafSize);
         }
@@ -69,6 +176,7 @@ namespace embree
         float intCost;           //!< estimated cost of one primitive intersection
         size_t singleThreadThreshold; //!< threshold when we switch to single threaded build
         size_t primrefarrayalloc;  //!< builder uses prim ref array to allocate nodes and leaves when a subtree of that size is finished
+        SingleThreadThresholdTuner* tuner; //!< optional tuner that chooses the single thread threshold during the build
       };
 
       /*! recursive state of builder */
@@ -225,10 +333,20 @@ namespace embree
             if (!alloc)
               alloc = createAlloc();
 
+            /* subtrees of up to that many primitives get built sequentially */
+            size_t singleThreadThreshold = cfg.singleThreadThreshold;
+            if (cfg.tuner) singleThreadThreshold = toplevel ? cfg.tuner->threshold() : size_t(inf);
+
             /* call memory monitor function to signal progress */
-            if (toplevel && current.size() <= cfg.singleThreadThreshold)
+            if (toplevel && current.size() <= singleThreadThreshold)
+            {
               progressMonitor(current.size());
 
+              /* measure the cost of the sequential subtree to tune the threshold */
+              if (cfg.tuner)
+                return cfg.tuner->sequential(current.size(), [&] { return recurse(current,alloc,false); });
+            }
+
             /*! find best split */
             auto split = heuristic.find(current.prims,cfg.logBlockSize);
 
@@ -296,7 +414,7 @@ namespace embree
             auto node = createNode(children,numChildren,alloc);
 
             /* spawn tasks */
-            if (current.size() > cfg.singleThreadThreshold)
+            if (current.size() > singleThreadThreshold)
             {
               /*! parallel_for is faster than spawing sub-tasks */
               parallel_for(size_t(0), numChildren, [&] (const range<size_t>& r) { // FIXME: no range here
@@ -521,6 +639,65 @@ namespace embree
       }
     };
 
+    /* SAH builder that bins compact primitive references and passes the full primitive references to the leaf creation */
+    struct BVHBuilderBinnedCompactSAH
+    {
+      typedef PrimInfoCompactRange Set;
+      typedef HeuristicArrayBinningCompactSAH<NUM_OBJECT_BINS> Heuristic;
+      typedef GeneralBVHBuilder::BuildRecordT<Set,typename Heuristic::Split> BuildRecord;
+      typedef GeneralBVHBuilder::Settings Settings;
+
+      template<typename ReductionTy, typename UserCreateLeaf>
+      struct CreateLeafCompact
+      {
+        __forceinline CreateLeafCompact (const UserCreateLeaf userCreateLeaf, const PrimRef* prims)
+          : userCreateLeaf(userCreateLeaf), prims(prims) {}
+
+        template<typename Allocator>
+        __noinline ReductionTy operator() (PrimRefCompact* refs, const range<size_t>& range, Allocator alloc) const
+        {
+          /* gather the full primitive references of the leaf */
+          dynamic_large_stack_array(PrimRef,leafPrims,range.size(),64*sizeof(PrimRef));
+          for (size_t i=0; i<range.size(); i++)
+            leafPrims[i] = prims[refs[range.begin()+i].id];
+
+          return userCreateLeaf((PrimRef*)leafPrims,embree::range<size_t>(0,range.size()),alloc);
+        }
+
+        const UserCreateLeaf userCreateLeaf;
+        const PrimRef* prims;
+      };
+
+      /*! special builder that propagates reduction over the tree */
+      template<
+      typename ReductionTy,
+        typename CreateAllocFunc,
+        typename CreateNodeFunc,
+        typename UpdateNodeFunc,
+        typename CreateLeafFunc,
+        typename ProgressMonitor>
+
+        static ReductionTy build(CreateAllocFunc createAlloc,
+                                 CreateNodeFunc createNode, UpdateNodeFunc updateNode,
+                                 const CreateLeafFunc& createLeaf,
+                                 const ProgressMonitor& progressMonitor,
+                                 const PrimRef* prims, PrimRefCompact* refs, const PrimInfo& pinfo,
+                                 const Settings& settings)
+      {
+        Heuristic heuristic(refs,prims);
+        return GeneralBVHBuilder::build<ReductionTy,Heuristic,Set,PrimRefCompact>(
+          heuristic,
+          refs,
+          heuristic.quantize(pinfo),
+          createAlloc,
+          createNode,
+          updateNode,
+          CreateLeafCompact<ReductionTy,CreateLeafFunc>(createLeaf,prims),
+          progressMonitor,
+          settings);
+      }
+    };
+
     /* Spatial SAH builder that operates on an double-buffered array of BuildRecords */
     struct BVHBuilderBinnedFastSpatialSAH
     {
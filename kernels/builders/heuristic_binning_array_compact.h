@@ -0,0 +1,247 @@
+// Copyright 2009-2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "heuristic_binning_array_aligned.h"
+#include "../../common/algorithms/parallel_for.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! A compact primitive reference stores the bounds of the primitive
+     *  quantized to 16 bits relative to the bounds of some subtree and
+     *  the index of the full primitive reference. */
+    struct PrimRefCompact
+    {
+      __forceinline PrimRefCompact () {}
+
+      /*! size for bin heuristic is 1 */
+      __forceinline unsigned size() const {
+        return 1;
+      }
+
+      /*! orders by index of the full primitive reference */
+      __forceinline friend bool operator<(const PrimRefCompact& p0, const PrimRefCompact& p1) {
+        return p0.id < p1.id;
+      }
+
+    public:
+      unsigned short lower[3];
+      unsigned short upper[3];
+      unsigned int id;
+    };
+
+    /*! Linear mapping between the bounds of a subtree and the 16 bit
+     *  quantized bounds of a compact primitive reference. */
+    struct PrimRefCompactFrame
+    {
+      __forceinline PrimRefCompactFrame () {}
+
+      __forceinline PrimRefCompactFrame (const BBox3fa& bounds)
+      {
+        const vfloat4 lower = (vfloat4) bounds.lower;
+        const vfloat4 upper = (vfloat4) bounds.upper;
+        const vfloat4 diag  = upper-lower;
+        ofs = lower;
+        scale = diag*vfloat4(1.0f/65535.0f);
+        rcp_scale = select(diag > vfloat4(zero),vfloat4(65535.0f)/diag,vfloat4(zero));
+        /* dequantized bounds get enlarged by some ulps to stay conservative */
+        err = vfloat4(16.0f*float(ulp))*max(abs(lower),abs(upper));
+      }
+
+      /*! quantizes the bounds of a primitive conservatively */
+      __forceinline PrimRefCompact quantize(const PrimRef& prim, unsigned int id) const
+      {
+        const vint4 l = floori(((vfloat4)prim.lower-ofs)*rcp_scale);
+        const vint4 u = vint4(ceil (((vfloat4)prim.upper-ofs)*rcp_scale));
+        const vint4 ql = min(max(l,vint4(zero)),vint4(65535));
+        const vint4 qu = min(max(u,vint4(zero)),vint4(65535));
+        PrimRefCompact ref;
+        ref.lower[0] = (unsigned short) ql[0]; ref.upper[0] = (unsigned short) qu[0];
+        ref.lower[1] = (unsigned short) ql[1]; ref.upper[1] = (unsigned short) qu[1];
+        ref.lower[2] = (unsigned short) ql[2]; ref.upper[2] = (unsigned short) qu[2];
+        ref.id = id;
+        return ref;
+      }
+
+      /*! returns conservative bounds of a compact primitive reference */
+      __forceinline BBox3fa bounds(const PrimRefCompact& ref) const
+      {
+        const vfloat4 l = vfloat4(vint4(ref.lower[0],ref.lower[1],ref.lower[2],0));
+        const vfloat4 u = vfloat4(vint4(ref.upper[0],ref.upper[1],ref.upper[2],0));
+        return BBox3fa(Vec3fa(madd(l,scale,ofs)-err),Vec3fa(madd(u,scale,ofs)+err));
+      }
+
+      /*! interface used by the binner */
+      __forceinline void binBoundsAndCenter(const PrimRefCompact& ref, BBox3fa& bounds_o, Vec3fa& center_o) const
+      {
+        bounds_o = bounds(ref);
+        center_o = embree::center2(bounds_o);
+      }
+
+    public:
+      vfloat4 ofs,scale,rcp_scale,err;
+    };
+
+    /*! range of compact primitive references together with the frame they are quantized in */
+    struct PrimInfoCompactRange : public PrimInfoRange
+    {
+      __forceinline PrimInfoCompactRange () {
+      }
+
+      __forceinline PrimInfoCompactRange(EmptyTy)
+        : PrimInfoRange(EmptyTy()), local(false) {}
+
+      __forceinline PrimInfoCompactRange (size_t begin, size_t end, const CentGeomBBox3fa& centGeomBounds, const PrimRefCompactFrame& frame, bool local)
+        : PrimInfoRange(begin,end,centGeomBounds), frame(frame), local(local) {}
+
+    public:
+      PrimRefCompactFrame frame; //!< frame the primitive references of this range are quantized in
+      bool local;                //!< true if the frame got calculated for this or some parent subtree that fits into the cache
+    };
+
+    /*! Performs standard object binning on compact primitive references.
+     *  Large subtrees are quantized relative to the root and requantized
+     *  relative to their own bounds once they fit into the L2 cache. */
+    template<size_t BINS>
+      struct HeuristicArrayBinningCompactSAH
+      {
+        typedef BinSplit<BINS> Split;
+        typedef BinInfoT<BINS,PrimRefCompact,BBox3fa> Binner;
+        typedef PrimInfoCompactRange Set;
+
+        static const size_t PARALLEL_THRESHOLD = 3 * 1024;
+        static const size_t PARALLEL_FIND_BLOCK_SIZE = 1024;
+        static const size_t PARALLEL_PARTITION_BLOCK_SIZE = 128;
+
+        /*! requantize subtrees whose compact and full primitive references fit into 1MB */
+        static const size_t REQUANTIZE_THRESHOLD = 16 * 1024;
+
+        __forceinline HeuristicArrayBinningCompactSAH ()
+          : refs(nullptr), prims(nullptr) {}
+
+        /*! remember prim arrays */
+        __forceinline HeuristicArrayBinningCompactSAH (PrimRefCompact* refs, const PrimRef* prims)
+          : refs(refs), prims(prims) {}
+
+        /*! quantizes all primitives relative to the root bounds */
+        PrimInfoCompactRange quantize(const PrimInfo& pinfo)
+        {
+          const PrimRefCompactFrame frame(pinfo.geomBounds);
+          parallel_for(pinfo.begin, pinfo.end, size_t(4096), [&](const range<size_t>& r) {
+              for (size_t i=r.begin(); i<r.end(); i++)
+                refs[i] = frame.quantize(prims[i],unsigned(i));
+            });
+          return PrimInfoCompactRange(pinfo.begin,pinfo.end,pinfo,frame,pinfo.size() <= REQUANTIZE_THRESHOLD);
+        }
+
+        /*! quantizes a subtree relative to its own bounds, also calculates exact bounds */
+        void requantize(PrimInfoCompactRange& set)
+        {
+          CentGeomBBox3fa bounds(empty);
+          for (size_t i=set.begin(); i<set.end(); i++)
+            bounds.extend_center2(prims[refs[i].id]);
+
+          const PrimRefCompactFrame frame(bounds.geomBounds);
+          for (size_t i=set.begin(); i<set.end(); i++)
+            refs[i] = frame.quantize(prims[refs[i].id],refs[i].id);
+
+          new (&set) PrimInfoCompactRange(set.begin(),set.end(),bounds,frame,true);
+        }
+
+        /*! finds the best split */
+        __noinline const Split find(PrimInfoCompactRange& set, const size_t logBlockSize)
+        {
+          if (unlikely(!set.local && set.size() <= REQUANTIZE_THRESHOLD))
+            requantize(set);
+
+          if (likely(set.size() < PARALLEL_THRESHOLD))
+            return find_template<false>(set,logBlockSize);
+          else
+            return find_template<true>(set,logBlockSize);
+        }
+
+        template<bool parallel>
+        __forceinline const Split find_template(const PrimInfoCompactRange& set, const size_t logBlockSize)
+        {
+          Binner binner(empty);
+          const BinMapping<BINS> mapping(set);
+          bin_serial_or_parallel<parallel>(binner,refs,set.begin(),set.end(),PARALLEL_FIND_BLOCK_SIZE,mapping,set.frame);
+          return binner.best(mapping,logBlockSize);
+        }
+
+        /*! array partitioning */
+        __forceinline void split(const Split& split, const PrimInfoCompactRange& set, PrimInfoCompactRange& lset, PrimInfoCompactRange& rset)
+        {
+          if (likely(set.size() < PARALLEL_THRESHOLD))
+            split_template<false>(split,set,lset,rset);
+          else
+            split_template<true>(split,set,lset,rset);
+        }
+
+        template<bool parallel>
+        __forceinline void split_template(const Split& split, const PrimInfoCompactRange& set, PrimInfoCompactRange& lset, PrimInfoCompactRange& rset)
+        {
+          if (!split.valid()) {
+            deterministic_order(set);
+            return splitFallback(set,lset,rset);
+          }
+
+          const size_t begin = set.begin();
+          const size_t end   = set.end();
+          const PrimRefCompactFrame& frame = set.frame;
+          CentGeomBBox3fa local_left(empty);
+          CentGeomBBox3fa local_right(empty);
+          const vint4 vSplitPos(split.pos);
+          const vbool4 vSplitMask(1 << split.dim);
+          auto isLeft = [&] (const PrimRefCompact& ref) {
+            return any(((vint4)split.mapping.bin_unsafe(center2(frame.bounds(ref))) < vSplitPos) & vSplitMask);
+          };
+          auto reduction = [&] (CentGeomBBox3fa& pinfo, const PrimRefCompact& ref) { pinfo.extend(frame.bounds(ref)); };
+
+          size_t center = 0;
+          if (!parallel)
+            center = serial_partitioning(refs,begin,end,local_left,local_right,isLeft,reduction);
+          else
+            center = parallel_partitioning(
+              refs,begin,end,EmptyTy(),local_left,local_right,isLeft,reduction,
+              [] (CentGeomBBox3fa& pinfo0,const CentGeomBBox3fa& pinfo1) { pinfo0.merge(pinfo1); },
+              PARALLEL_PARTITION_BLOCK_SIZE);
+
+          new (&lset) PrimInfoCompactRange(begin,center,local_left,frame,set.local);
+          new (&rset) PrimInfoCompactRange(center,end,local_right,frame,set.local);
+          assert(area(lset.geomBounds) >= 0.0f);
+          assert(area(rset.geomBounds) >= 0.0f);
+        }
+
+        void deterministic_order(const PrimInfoCompactRange& set)
+        {
+          /* required as parallel partition destroys original primitive order */
+          std::sort(&refs[set.begin()],&refs[set.end()]);
+        }
+
+        void splitFallback(const PrimInfoCompactRange& set, PrimInfoCompactRange& lset, PrimInfoCompactRange& rset)
+        {
+          const size_t begin = set.begin();
+          const size_t end   = set.end();
+          const size_t center = (begin + end)/2;
+
+          CentGeomBBox3fa left(empty);
+          for (size_t i=begin; i<center; i++)
+            left.extend(set.frame.bounds(refs[i]));
+          new (&lset) PrimInfoCompactRange(begin,center,left,set.frame,set.local);
+
+          CentGeomBBox3fa right(empty);
+          for (size_t i=center; i<end; i++)
+            right.extend(set.frame.bounds(refs[i]));
+          new (&rset) PrimInfoCompactRange(center,end,right,set.frame,set.local);
+        }
+
+      private:
+        PrimRefCompact* const refs;
+        const PrimRef* const prims;
+      };
+  }
+}
@@ -23,6 +23,9 @@
 namespace embree
 {
   DECLARE_SYMBOL2(Accel::Collider,BVH4ColliderUserGeom);
+  DECLARE_SYMBOL2(Accel::Collider,BVH4ColliderTriangle4);
+  DECLARE_SYMBOL2(Accel::Collider,BVH4ColliderTriangle4v);
+  DECLARE_SYMBOL2(Accel::Collider,BVH4ColliderTriangle4i);
 
   DECLARE_ISA_FUNCTION(VirtualCurveIntersector*,VirtualCurveIntersector4i,void);
   DECLARE_ISA_FUNCTION(VirtualCurveIntersector*,VirtualCurveIntersector8i,void);
@@ -264,6 +267,9 @@ namespace embree
   BVH4Factory::BVH4Factory(int bfeatures, int ifeatures)
   {
     SELECT_SYMBOL_DEFAULT_AVX_AVX2(ifeatures,BVH4ColliderUserGeom);
+    SELECT_SYMBOL_DEFAULT_AVX_AVX2(ifeatures,BVH4ColliderTriangle4);
+    SELECT_SYMBOL_DEFAULT_AVX_AVX2(ifeatures,BVH4ColliderTriangle4v);
+    SELECT_SYMBOL_DEFAULT_AVX_AVX2(ifeatures,BVH4ColliderTriangle4i);
 
     selectBuilders(bfeatures);
     selectIntersectors(ifeatures);
@@ -612,6 +618,7 @@ namespace embree
     intersectors.intersectorN_filter    = BVH4Triangle4IntersectorStreamMoeller();
     intersectors.intersectorN_nofilter  = BVH4Triangle4IntersectorStreamMoellerNoFilter();
 #endif
+    intersectors.collider               = BVH4ColliderTriangle4();
     return intersectors;
   }
 
@@ -627,6 +634,7 @@ namespace embree
     intersectors.intersector16 = BVH4Triangle4vIntersector16HybridPluecker();
     intersectors.intersectorN  = BVH4Triangle4vIntersectorStreamPluecker();
 #endif
+    intersectors.collider      = BVH4ColliderTriangle4v();
     return intersectors;
   }
 
@@ -644,6 +652,7 @@ namespace embree
       intersectors.intersector16 = BVH4Triangle4iIntersector16HybridMoeller();
       intersectors.intersectorN  = BVH4Triangle4iIntersectorStreamMoeller();
 #endif
+      intersectors.collider      = BVH4ColliderTriangle4i();
       return intersectors;
     }
     case IntersectVariant::ROBUST:
@@ -657,6 +666,7 @@ namespace embree
       intersectors.intersector16 = BVH4Triangle4iIntersector16HybridPluecker();
       intersectors.intersectorN  = BVH4Triangle4iIntersectorStreamPluecker();
 #endif
+      intersectors.collider      = BVH4ColliderTriangle4i();
       return intersectors;
     }
     }
@@ -99,6 +99,9 @@ namespace embree
   private:
 
     DEFINE_SYMBOL2(Accel::Collider,BVH4ColliderUserGeom);
+    DEFINE_SYMBOL2(Accel::Collider,BVH4ColliderTriangle4);
+    DEFINE_SYMBOL2(Accel::Collider,BVH4ColliderTriangle4v);
+    DEFINE_SYMBOL2(Accel::Collider,BVH4ColliderTriangle4i);
 
     DEFINE_SYMBOL2(Accel::Intersector1,BVH4OBBVirtualCurveIntersector1);
     DEFINE_SYMBOL2(Accel::Intersector1,BVH4OBBVirtualCurveIntersector1MB);
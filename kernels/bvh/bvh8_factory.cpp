@@ -27,6 +27,9 @@
 namespace embree
 {
   DECLARE_SYMBOL2(Accel::Collider,BVH8ColliderUserGeom);
+  DECLARE_SYMBOL2(Accel::Collider,BVH8ColliderTriangle4);
+  DECLARE_SYMBOL2(Accel::Collider,BVH8ColliderTriangle4v);
+  DECLARE_SYMBOL2(Accel::Collider,BVH8ColliderTriangle4i);
   
   DECLARE_ISA_FUNCTION(VirtualCurveIntersector*,VirtualCurveIntersector8v,void);
   DECLARE_ISA_FUNCTION(VirtualCurveIntersector*,VirtualCurveIntersector8iMB,void);
@@ -244,6 +247,9 @@ namespace embree
   BVH8Factory::BVH8Factory(int bfeatures, int ifeatures)
   {
     SELECT_SYMBOL_INIT_AVX(ifeatures,BVH8ColliderUserGeom);
+    SELECT_SYMBOL_INIT_AVX(ifeatures,BVH8ColliderTriangle4);
+    SELECT_SYMBOL_INIT_AVX(ifeatures,BVH8ColliderTriangle4v);
+    SELECT_SYMBOL_INIT_AVX(ifeatures,BVH8ColliderTriangle4i);
     
     selectBuilders(bfeatures);
     selectIntersectors(ifeatures);
@@ -685,6 +691,7 @@ namespace embree
     intersectors.intersectorN_filter    = BVH8Triangle4IntersectorStreamMoeller();
     intersectors.intersectorN_nofilter  = BVH8Triangle4IntersectorStreamMoellerNoFilter();
 #endif
+    intersectors.collider               = BVH8ColliderTriangle4();
     return intersectors;
   }
 
@@ -706,6 +713,7 @@ namespace embree
     intersectors.intersector16   = BVH8Triangle4vIntersector16HybridPluecker();
     intersectors.intersectorN    = BVH8Triangle4vIntersectorStreamPluecker();
 #endif
+    intersectors.collider        = BVH8ColliderTriangle4v();
     return intersectors;
   }
 
@@ -723,6 +731,7 @@ namespace embree
       intersectors.intersector16 = BVH8Triangle4iIntersector16HybridMoeller();
       intersectors.intersectorN  = BVH8Triangle4iIntersectorStreamMoeller();
 #endif
+      intersectors.collider      = BVH8ColliderTriangle4i();
       return intersectors;
     }
     case IntersectVariant::ROBUST:
@@ -736,6 +745,7 @@ namespace embree
       intersectors.intersector16 = BVH8Triangle4iIntersector16HybridPluecker();
       intersectors.intersectorN  = BVH8Triangle4iIntersectorStreamPluecker();
 #endif
+      intersectors.collider      = BVH8ColliderTriangle4i();
       return intersectors;
     }
     }
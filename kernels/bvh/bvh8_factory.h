@@ -87,6 +87,9 @@ namespace embree
 
   private:
     DEFINE_SYMBOL2(Accel::Collider,BVH8ColliderUserGeom);
+    DEFINE_SYMBOL2(Accel::Collider,BVH8ColliderTriangle4);
+    DEFINE_SYMBOL2(Accel::Collider,BVH8ColliderTriangle4v);
+    DEFINE_SYMBOL2(Accel::Collider,BVH8ColliderTriangle4i);
     
     DEFINE_SYMBOL2(Accel::Intersector1,BVH8OBBVirtualCurveIntersector1);
     DEFINE_SYMBOL2(Accel::Intersector1,BVH8OBBVirtualCurveIntersector1MB);
@@ -20,6 +20,65 @@ namespace embree
         (FastAllocator::Create(allocator),typename BVH::AABBNode::Create2(),typename BVH::AABBNode::Set3(allocator,prims),createLeafFunc,progressFunc,prims,pinfo,settings);
     }
 
+    template<int N>
+    typename BVHN<N>::NodeRef BVHNBuilderVirtual<N>::BVHNBuilderV::buildCompact(FastAllocator* allocator, BuildProgressMonitor& progressFunc, PrimRef* prims, PrimRefCompact* refs, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings)
+    {
+      auto createLeafFunc = [&] (const PrimRef* prims, const range<size_t>& set, const Allocator& alloc) -> NodeRef {
+        return createLeaf(prims,set,alloc);
+      };
+
+      settings.branchingFactor = N;
+      settings.maxDepth = BVH::maxBuildDepthLeaf;
+      return BVHBuilderBinnedCompactSAH::build<NodeRef>
+        (FastAllocator::Create(allocator),typename BVH::AABBNode::Create2(),typename BVH::AABBNode::Set2(),createLeafFunc,progressFunc,prims,refs,pinfo,settings);
+    }
+
+    template<int N>
+    typename BVHN<N>::NodeRef BVHNBuilderVirtual<N>::BVHNBuilderV::buildSingleLeaves(FastAllocator* allocator, BuildProgressMonitor& progressFunc, PrimRef* prims, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings)
+    {
+      typedef BVHBuilderBinnedSAH::Set Set;
+
+      auto createLeafFunc = [&] (const PrimRef* prims, const range<size_t>& set, const Allocator& alloc) -> NodeRef {
+        return createLeaf(prims,set,alloc);
+      };
+
+      /* a leaf of multiple primitives must not contain a primitive that requires a leaf of its own */
+      auto canCreateLeafFunc = [&] (const PrimRef* prims, const Set& set) -> bool
+      {
+        if (set.size() <= 1) return true;
+        for (size_t i=set.begin(); i<set.end(); i++)
+          if (singleLeaf(prims[i])) return false;
+        return true;
+      };
+
+      /* separates the primitives that require a leaf of their own from the others, or halves the set if all of them do */
+      auto canCreateLeafSplitFunc = [&] (PrimRef* prims, const Set& set, Set& lset, Set& rset)
+      {
+        const size_t begin = set.begin();
+        const size_t end   = set.end();
+        CentGeomBBox3fa left(empty);
+        CentGeomBBox3fa right(empty);
+        size_t center = serial_partitioning(prims,begin,end,left,right,
+                                            [&] (const PrimRef& ref) { return singleLeaf(ref); },
+                                            [] (CentGeomBBox3fa& pinfo,const PrimRef& ref) { pinfo.extend_center2(ref); });
+
+        if (center == end)
+        {
+          center = (begin+end)/2;
+          left = CentGeomBBox3fa(empty);
+          right = CentGeomBBox3fa(empty);
+          for (size_t i=begin; i<center; i++) left.extend_center2(prims[i]);
+          for (size_t i=center; i<end; i++) right.extend_center2(prims[i]);
+        }
+        new (&lset) Set(begin,center,left);
+        new (&rset) Set(center,end,right);
+      };
+
+      settings.branchingFactor = N;
+      settings.maxDepth = BVH::maxBuildDepthLeaf;
+      return BVHBuilderBinnedSAH::build<NodeRef>
+        (FastAllocator::Create(allocator),typename BVH::AABBNode::Create2(),typename BVH::AABBNode::Set3(allocator,prims),createLeafFunc,canCreateLeafFunc,canCreateLeafSplitFunc,progressFunc,prims,pinfo,settings);
+    }
 
     template<int N>
     typename BVHN<N>::NodeRef BVHNBuilderQuantizedVirtual<N>::BVHNBuilderV::build(FastAllocator* allocator, BuildProgressMonitor& progressFunc, PrimRef* prims, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings)
@@ -22,7 +22,10 @@ namespace embree
       
         struct BVHNBuilderV {
           NodeRef build(FastAllocator* allocator, BuildProgressMonitor& progress, PrimRef* prims, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings);
+          NodeRef buildCompact(FastAllocator* allocator, BuildProgressMonitor& progress, PrimRef* prims, PrimRefCompact* refs, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings);
+          NodeRef buildSingleLeaves(FastAllocator* allocator, BuildProgressMonitor& progress, PrimRef* prims, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings);
           virtual NodeRef createLeaf (const PrimRef* prims, const range<size_t>& set, const Allocator& alloc) = 0;
+          virtual bool singleLeaf (const PrimRef& prim) { return false; }
         };
 
         template<typename CreateLeafFunc>
@@ -43,6 +46,32 @@ namespace embree
         static NodeRef build(FastAllocator* allocator, CreateLeafFunc createLeaf, BuildProgressMonitor& progress, PrimRef* prims, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings) {
           return BVHNBuilderT<CreateLeafFunc>(createLeaf).build(allocator,progress,prims,pinfo,settings);
         }
+
+        /*! bins compact primitive references, the full primitive references are only read to create the leaves */
+        template<typename CreateLeafFunc>
+        static NodeRef buildCompact(FastAllocator* allocator, CreateLeafFunc createLeaf, BuildProgressMonitor& progress, PrimRef* prims, PrimRefCompact* refs, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings) {
+          return BVHNBuilderT<CreateLeafFunc>(createLeaf).buildCompact(allocator,progress,prims,refs,pinfo,settings);
+        }
+
+        template<typename CreateLeafFunc, typename SingleLeafFunc>
+        struct BVHNBuilderSingleLeavesT : public BVHNBuilderT<CreateLeafFunc>
+        {
+          BVHNBuilderSingleLeavesT (CreateLeafFunc createLeafFunc, SingleLeafFunc singleLeafFunc)
+            : BVHNBuilderT<CreateLeafFunc>(createLeafFunc), singleLeafFunc(singleLeafFunc) {}
+
+          bool singleLeaf (const PrimRef& prim) {
+            return singleLeafFunc(prim);
+          }
+
+        private:
+          SingleLeafFunc singleLeafFunc;
+        };
+
+        /*! primitives for which singleLeaf returns true get a leaf of their own, all others use the leaf sizes of the settings */
+        template<typename CreateLeafFunc, typename SingleLeafFunc>
+        static NodeRef buildSingleLeaves(FastAllocator* allocator, CreateLeafFunc createLeaf, SingleLeafFunc singleLeaf, BuildProgressMonitor& progress, PrimRef* prims, const PrimInfo& pinfo, GeneralBVHBuilder::Settings settings) {
+          return BVHNBuilderSingleLeavesT<CreateLeafFunc,SingleLeafFunc>(createLeaf,singleLeaf).buildSingleLeaves(allocator,progress,prims,pinfo,settings);
+        }
       };
 
     template<int N>
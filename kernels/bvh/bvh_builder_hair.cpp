@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "../builders/bvh_builder_hair.h"
+#include "../builders/bvh_builder_morton.h"
 #include "../builders/primrefgen.h"
 
 #include "../geometry/pointi.h"
@@ -20,14 +21,17 @@ namespace embree
     {
       typedef BVHN<N> BVH;
       typedef typename BVH::NodeRef NodeRef;
+      typedef typename BVH::NodeRecord NodeRecord;
+      typedef typename BVH::AABBNode AABBNode;
 
       BVH* bvh;
       Scene* scene;
       mvector<PrimRef> prims;
       BVHBuilderHair::Settings settings;
+      size_t numMortonPrimitives;
 
       BVHNHairBuilderSAH (BVH* bvh, Scene* scene)
-        : bvh(bvh), scene(scene), prims(scene->device,0) {}
+        : bvh(bvh), scene(scene), prims(scene->device,0), numMortonPrimitives(0) {}
       
       void build() 
       {
@@ -43,12 +47,23 @@ namespace embree
           return;
         }
 
-        double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + "HairBuilderSAH");
+        /* point clouds of low quality scenes get sorted along a Morton curve */
+        const bool morton = scene->quality_flags == RTC_BUILD_QUALITY_LOW &&
+          scene->getNumPrimitives(Geometry::MTY_POINTS,false) == numPrimitives;
+        
+        double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + (morton ? "PointBuilderMorton" : "HairBuilderSAH"));
 
         /* create primref array */
         prims.resize(numPrimitives);
         const PrimInfo pinfo = createPrimRefArray(scene,Geometry::MTY_CURVES,false,prims,scene->progressInterface);
 
+        if (morton) {
+          buildMorton(pinfo);
+          bvh->postBuild(t0);
+          return;
+        }
+        numMortonPrimitives = 0;
+
         /* estimate acceleration structure size */
         const size_t node_bytes = pinfo.size()*sizeof(typename BVH::OBBNode)/(4*N);
         const size_t leaf_bytes = CurvePrimitive::bytes(pinfo.size());
@@ -112,6 +127,90 @@ namespace embree
         bvh->postBuild(t0);
       }
 
+      /* builds a BVH over points only, full leaves are created from consecutive points along a Morton curve */
+      void buildMorton(const PrimInfo& pinfo)
+      {
+        /* primrefs are never shared with the BVH in this mode */
+        settings.finished_range_threshold = inf;
+
+        /* we reset the allocator when the number of points changed, as its first block has to hold the morton codes */
+        const size_t numPrimitives = pinfo.size();
+        if (numPrimitives != numMortonPrimitives) bvh->alloc.clear();
+        numMortonPrimitives = numPrimitives;
+
+        const size_t bytesEstimated = numPrimitives*sizeof(AABBNode)/(4*N) + PointPrimitive::bytes(numPrimitives);
+        const size_t bytesMortonCodes = numPrimitives*sizeof(BVHBuilderMorton::BuildPrim);
+        bvh->alloc.init(bytesMortonCodes,bytesMortonCodes,max(bytesEstimated,bytesMortonCodes)); // the first allocation block is reused to sort the morton codes
+
+        /* create morton code array */
+        mvector<BVHBuilderMorton::BuildPrim> morton(scene->device,numPrimitives);
+        BVHBuilderMorton::BuildPrim* dest = (BVHBuilderMorton::BuildPrim*) bvh->alloc.specialAlloc(bytesMortonCodes);
+        const BVHBuilderMorton::MortonCodeMapping mapping(pinfo.centBounds);
+        parallel_for( size_t(0), numPrimitives, size_t(1024), [&](const range<size_t>& r) -> void {
+            BVHBuilderMorton::MortonCodeGenerator generator(mapping,&morton.data()[r.begin()]);
+            for (size_t j=r.begin(); j<r.end(); j++)
+              generator(prims[j].bounds(),unsigned(j));
+          });
+
+        auto setBounds = [&] (NodeRef ref, const NodeRecord* children, size_t num) -> NodeRecord
+        {
+          AABBNode* node = ref.getAABBNode();
+          BBox3fa res = empty;
+          for (size_t i=0; i<num; i++) {
+            res.extend(children[i].bounds);
+            node->setRef(i,children[i].ref);
+            node->setBounds(i,children[i].bounds);
+          }
+          return NodeRecord(ref,res);
+        };
+
+        /* creates a leaf node, as the intersector steps over leaf blocks with the
+         * size of the curve primitive, points of different types get separate leaves */
+        auto createLeaf = [&] (const range<unsigned>& current, const FastAllocator::CachedAllocator& alloc) -> NodeRecord
+        {
+          PrimRef leafPrims[16]; // large enough for all point leaf sizes
+          const size_t items = current.size();
+          assert(items <= PointPrimitive::max_size() && items <= 16);
+          for (size_t i=0; i<items; i++)
+            leafPrims[i] = prims[morton[current.begin()+i].index];
+          auto type = [&] (const PrimRef& prim) { return scene->get(prim.geomID())->getType(); };
+          std::stable_sort(leafPrims,leafPrims+items,[&] (const PrimRef& a, const PrimRef& b) { return type(a) < type(b); });
+
+          size_t numChildren = 0;
+          NodeRecord children[N];
+          for (size_t i=0, j=0; i<items; i=j)
+          {
+            BBox3fa bounds = empty;
+            for (j=i; j<items && type(leafPrims[j]) == type(leafPrims[i]); j++)
+              bounds.extend(leafPrims[j].bounds());
+            children[numChildren++] = NodeRecord(PointPrimitive::createLeaf(bvh,leafPrims,range<size_t>(i,j),alloc),bounds);
+          }
+          if (numChildren == 1)
+            return children[0];
+
+          return setBounds(typename BVH::AABBNode::Create()(alloc,numChildren),children,numChildren);
+        };
+
+        auto calculateBounds = [&] (const BVHBuilderMorton::BuildPrim& prim) -> BBox3fa {
+          return prims[prim.index].bounds();
+        };
+
+        const BVHBuilderMorton::Settings mortonSettings(N,BVH::maxBuildDepth,PointPrimitive::max_size(),PointPrimitive::max_size(),DEFAULT_SINGLE_THREAD_THRESHOLD,scene->device->morton_code_bits);
+        NodeRecord root = BVHBuilderMorton::build<NodeRecord>(
+          typename BVH::CreateAlloc(bvh),
+          typename BVH::AABBNode::Create(),
+          setBounds,createLeaf,calculateBounds,scene->progressInterface,
+          morton.data(),dest,numPrimitives,mortonSettings);
+
+        bvh->set(root.ref,LBBox3fa(root.bounds),numPrimitives);
+
+        /* clear temporary data for static geometry */
+        if (scene->isStaticAccel()) {
+          prims.clear();
+        }
+        bvh->cleanup();
+      }
+
       void clear() {
         prims.clear();
       }
@@ -408,6 +408,7 @@ namespace embree
         size_t numPrimitivesGen = createMortonCodeArray<Mesh>(mesh,morton,bvh->scene->progressInterface);
 
         /* create BVH */
+        settings.mortonCodeBits = bvh->device->morton_code_bits;
         SetBVHNBounds<N> setBounds(bvh);
         CreateMortonLeaf<N,Primitive> createLeaf(mesh,geomID_,morton.data());
         CalculateMeshBounds<Mesh> calculateBounds(mesh);
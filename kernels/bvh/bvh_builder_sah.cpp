@@ -97,6 +97,7 @@ namespace embree
       unsigned int geomID_ = std::numeric_limits<unsigned int>::max ();
       bool primrefarrayalloc;
       unsigned int numPreviousPrimitives = 0;
+      std::vector<bool> singleLeafGeometries; //!< primitives of these geometries get a leaf of their own, empty if all primitives may share leaves
 
       BVHNBuilderSAH (BVH* bvh, Scene* scene, const size_t sahBlockSize, const float intCost, const size_t minLeafSize, const size_t maxLeafSize,
                       const Geometry::GTypeMask gtype, bool primrefarrayalloc = false)
@@ -134,8 +135,12 @@ namespace embree
         profile(2,PROFILE_RUNS,numPrimitives,[&] (ProfileTimer& timer) {
 #endif
 
+            /* large builds bin compact primrefs, thus the primref array cannot get reused for allocations */
+            const size_t quantizedBinningThreshold = bvh->device->quantized_binning_threshold;
+            const bool quantizedBinning = quantizedBinningThreshold != 0 && numPrimitives >= quantizedBinningThreshold && singleLeafGeometries.empty();
+
             /* create primref array */
-            if (primrefarrayalloc) {
+            if (primrefarrayalloc && !quantizedBinning) {
               settings.primrefarrayalloc = numPrimitives/1000;
               if (settings.primrefarrayalloc < 1000)
                 settings.primrefarrayalloc = inf;
@@ -149,7 +154,9 @@ namespace embree
             const size_t node_bytes = numPrimitives*sizeof(typename BVH::AABBNodeMB)/(4*N);
             const size_t leaf_bytes = size_t(1.2*Primitive::blocks(numPrimitives)*sizeof(Primitive));
             bvh->alloc.init_estimate(node_bytes+leaf_bytes);
-            settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,numPrimitives,node_bytes+leaf_bytes);
+            const size_t singleThreadThreshold = bvh->device->single_thread_threshold;
+            const bool autotune = singleThreadThreshold == 0;
+            settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,autotune ? GeneralBVHBuilder::SingleThreadThresholdTuner::MIN_THRESHOLD : singleThreadThreshold,numPrimitives,node_bytes+leaf_bytes);
             prims.resize(numPrimitives); 
 
             PrimInfo pinfo = mesh ?
@@ -164,10 +171,30 @@ namespace embree
               return;
             }
 
+            /* the tuner chooses the single thread threshold during the build, the allocator constraint is its lower bound */
+            GeneralBVHBuilder::SingleThreadThresholdTuner tuner(pinfo.size(),settings.singleThreadThreshold);
+            settings.tuner = autotune ? &tuner : nullptr;
+
             /* call BVH builder */
-            NodeRef root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeaf<N,Primitive>(bvh),bvh->scene->progressInterface,prims.data(),pinfo,settings);
+            NodeRef root;
+            if (quantizedBinning) {
+              mvector<PrimRefCompact> refs(bvh->device,pinfo.size());
+              root = BVHNBuilderVirtual<N>::buildCompact(&bvh->alloc,CreateLeaf<N,Primitive>(bvh),bvh->scene->progressInterface,prims.data(),refs.data(),pinfo,settings);
+            }
+            else if (!singleLeafGeometries.empty()) {
+              auto singleLeaf = [&] (const PrimRef& prim) -> bool { return singleLeafGeometries[prim.geomID()]; };
+              root = BVHNBuilderVirtual<N>::buildSingleLeaves(&bvh->alloc,CreateLeaf<N,Primitive>(bvh),singleLeaf,bvh->scene->progressInterface,prims.data(),pinfo,settings);
+            }
+            else
+              root = BVHNBuilderVirtual<N>::build(&bvh->alloc,CreateLeaf<N,Primitive>(bvh),bvh->scene->progressInterface,prims.data(),pinfo,settings);
             bvh->set(root,LBBox3fa(pinfo.geomBounds),pinfo.size());
             bvh->layoutLargeNodes(size_t(pinfo.size()*0.005f));
+            settings.tuner = nullptr;
+
+            if (autotune && bvh->device->verbosity(2)) {
+              Lock<MutexSys> lock(g_printMutex);
+              tuner.print(std::cout);
+            }
 
 #if PROFILE
           });
@@ -591,10 +618,55 @@ namespace embree
 
 #if defined(EMBREE_GEOMETRY_USER)
 
+    /*! user geometry builder that chooses the leaf sizes at every build, as geometries and their batch callbacks may change between commits */
+    template<int N>
+    struct BVHNBuilderSAHVirtual : public BVHNBuilderSAH<N,Object>
+    {
+      typedef BVHNBuilderSAH<N,Object> Base;
+
+      BVHNBuilderSAHVirtual (BVHN<N>* bvh, Scene* scene)
+        : Base(bvh,scene,N,1.0f,1,1,UserGeometry::geom_type) {}
+
+      void build()
+      {
+        Scene* scene = this->scene;
+        const int minLeafSizeUser = scene->device->object_accel_min_leaf_size;
+        const int maxLeafSizeUser = scene->device->object_accel_max_leaf_size;
+
+        /* leaves hold a single primitive, unless batch callbacks can process more of them per invocation */
+        std::vector<bool> batched(scene->size(),false);
+        bool anyBatched = false, anyUnbatched = false;
+        for (size_t i=0; i<scene->size(); i++)
+        {
+          Geometry* geom = scene->get(i);
+          if (geom == nullptr || geom->getType() != Geometry::GTY_USER_GEOMETRY || geom->numTimeSteps != 1) continue;
+          const AccelSet::IntersectorN& intersector = ((AccelSet*)geom)->intersectorN;
+          batched[i] = intersector.intersectBatch != nullptr || intersector.occludedBatch != nullptr;
+          anyBatched |= batched[i];
+          anyUnbatched |= !batched[i];
+        }
+
+        size_t minLeafSize = anyBatched ? 4 : 1;
+        size_t maxLeafSize = anyBatched ? 8 : 1;
+        if (minLeafSizeUser > 0) minLeafSize = size_t(minLeafSizeUser);
+        if (maxLeafSizeUser > 0) maxLeafSize = size_t(maxLeafSizeUser);
+        this->settings.maxLeafSize = min(maxLeafSize,Object::max_size()*BVHN<N>::maxLeafBlocks);
+        this->settings.minLeafSize = min(minLeafSize,this->settings.maxLeafSize);
+
+        /* without configured leaf sizes the primitives of geometries without batch callbacks keep leaves of their own */
+        this->singleLeafGeometries.clear();
+        if (anyBatched && anyUnbatched && maxLeafSizeUser <= 0) {
+          this->singleLeafGeometries.resize(batched.size());
+          for (size_t i=0; i<batched.size(); i++)
+            this->singleLeafGeometries[i] = !batched[i];
+        }
+
+        Base::build();
+      }
+    };
+
     Builder* BVH4VirtualSceneBuilderSAH    (void* bvh, Scene* scene, size_t mode) {
-      int minLeafSize = scene->device->object_accel_min_leaf_size;
-      int maxLeafSize = scene->device->object_accel_max_leaf_size;
-      return new BVHNBuilderSAH<4,Object>((BVH4*)bvh,scene,4,1.0f,minLeafSize,maxLeafSize,UserGeometry::geom_type);
+      return new BVHNBuilderSAHVirtual<4>((BVH4*)bvh,scene);
     }
 
     Builder* BVH4VirtualMeshBuilderSAH    (void* bvh, UserGeometry* mesh, unsigned int geomID, size_t mode) {
@@ -603,9 +675,7 @@ namespace embree
 #if defined(__AVX__)
 
     Builder* BVH8VirtualSceneBuilderSAH    (void* bvh, Scene* scene, size_t mode) {
-      int minLeafSize = scene->device->object_accel_min_leaf_size;
-      int maxLeafSize = scene->device->object_accel_max_leaf_size;
-      return new BVHNBuilderSAH<8,Object>((BVH8*)bvh,scene,8,1.0f,minLeafSize,maxLeafSize,UserGeometry::geom_type);
+      return new BVHNBuilderSAHVirtual<8>((BVH8*)bvh,scene);
     }
 
     Builder* BVH8VirtualMeshBuilderSAH    (void* bvh, UserGeometry* mesh, unsigned int geomID, size_t mode) {
@@ -629,6 +699,76 @@ namespace embree
     Builder* BVH8GridMeshBuilderSAH  (void* bvh, GridMesh* mesh, unsigned int geomID, size_t mode) { return new BVHNBuilderSAHGrid<8>((BVH8*)bvh,mesh,geomID,8,1.0f,8,8,mode); }
     Builder* BVH8GridSceneBuilderSAH (void* bvh, Scene* scene, size_t mode)   { return new BVHNBuilderSAHGrid<8>((BVH8*)bvh,scene,8,1.0f,8,8,mode); } // FIXME: check whether cost factors are correct
 #endif
+#endif
+
+#if defined(EMBREE_LOWEST_ISA)
+    struct single_thread_threshold_regression_test : public RegressionTest
+    {
+      typedef GeneralBVHBuilder::SingleThreadThresholdTuner Tuner;
+
+      single_thread_threshold_regression_test(const char* name) : RegressionTest(name) {
+        registerRegressionTest(this);
+      }
+
+      /* checks that the grain size is the smallest power of two multiple of the lower bound that amortizes the task overhead */
+      static bool checkGrainSize(const Tuner& tuner)
+      {
+        const size_t grain = tuner.grainSize();
+        const double ns = tuner.nanosecondsPerPrimLevel();
+        if (grain < tuner.minThreshold) return false;
+        if (ns*double(grain)*double(Tuner::levels(grain)) < double(Tuner::MIN_TASK_NANOSECONDS)) return false;
+        if (grain == tuner.minThreshold) return true;
+        return ns*double(grain/2)*double(Tuner::levels(grain/2)) < double(Tuner::MIN_TASK_NANOSECONDS);
+      }
+
+      /* checks the threshold against the share of the remaining primitives of each idle thread */
+      static bool checkThreshold(Tuner& tuner)
+      {
+        const size_t idle = tuner.numThreads - min(Tuner::activeThreadCount(),tuner.numActiveThreads);
+        const size_t share = tuner.remaining / (Tuner::TASKS_PER_THREAD*(idle+1));
+        return checkGrainSize(tuner) && tuner.threshold() == max(tuner.grainSize(),share);
+      }
+
+      bool run ()
+      {
+        /* large builds start with the default cost estimate and split the primitives over the idle threads */
+        bool passed = true;
+        const size_t N = 1024*1024;
+        Tuner large(N,1024);
+        passed &= large.minThreshold == 1024;
+        passed &= large.nanosecondsPerPrimLevel() == double(Tuner::DEFAULT_NANOSECONDS_PER_PRIM_LEVEL);
+        passed &= checkThreshold(large);
+
+        /* a sequential subtree of 2ms updates the cost estimate and the number of remaining primitives */
+        large.addSubtree(4096,0.002);
+        passed &= large.numSubtrees == 1 && large.remaining == N-4096;
+        passed &= std::abs(large.nanosecondsPerPrimLevel()*double(4096*Tuner::levels(4096)) - 2E6) < 1E3;
+        passed &= checkThreshold(large);
+
+        /* subtrees too fast for the clock resolution keep the default estimate */
+        Tuner fast(N,0);
+        fast.addSubtree(128,0.0);
+        passed &= fast.nanosecondsPerPrimLevel() == double(Tuner::DEFAULT_NANOSECONDS_PER_PRIM_LEVEL);
+
+        /* expensive subtrees of a small build lower the threshold to the minimum, the default estimate would choose 512 */
+        Tuner small(2048,0);
+        passed &= small.minThreshold == Tuner::MIN_THRESHOLD;
+        passed &= small.grainSize() == 512;
+        small.addSubtree(128,0.005);
+        passed &= checkThreshold(small);
+        passed &= small.grainSize() == Tuner::MIN_THRESHOLD;
+        passed &= small.minChosen >= Tuner::MIN_THRESHOLD && small.maxChosen <= 2048;
+
+        /* cheap subtrees raise the grain size until a subtree amortizes the task overhead */
+        Tuner cheap(N,0);
+        cheap.addSubtree(1024,1E-6);
+        passed &= checkGrainSize(cheap);
+        passed &= cheap.grainSize() > 1024;
+        return passed;
+      }
+    };
+
+    single_thread_threshold_regression_test single_thread_threshold_regression("single_thread_threshold_regression_test");
 #endif
   }
 }
@@ -196,6 +196,10 @@ namespace embree
         settings.intCost = intCost;
         settings.singleLeafTimeSegment = Primitive::singleTimeSegment;
         settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
+        settings.maxTimeSplitReplications = scene->device->max_temporal_split_replications;
+        settings.minTimeSplitMotion = scene->device->temporal_split_motion_threshold;
+        BVHBuilderMSMBlur::TemporalSplitStatistics stats;
+        settings.stats = &stats;
         
         /* build hierarchy */
         auto root =
@@ -209,6 +213,11 @@ namespace embree
                                             settings);
 
         bvh->set(root.ref,root.lbounds,pinfo.num_time_segments);
+
+        if (scene->device->verbosity(2)) {
+          Lock<MutexSys> lock(g_printMutex);
+          stats.print(std::cout);
+        }
       }
 
       void clear() {
@@ -632,8 +641,12 @@ namespace embree
         settings.maxLeafSize = maxLeafSize;
         settings.travCost = travCost;
         settings.intCost = intCost;
-        settings.singleLeafTimeSegment = false; 
+        settings.singleLeafTimeSegment = false;
         settings.singleThreadThreshold = bvh->alloc.fixSingleThreadThreshold(N,DEFAULT_SINGLE_THREAD_THRESHOLD,pinfo.size(),node_bytes+leaf_bytes);
+        settings.maxTimeSplitReplications = scene->device->max_temporal_split_replications;
+        settings.minTimeSplitMotion = scene->device->temporal_split_motion_threshold;
+        BVHBuilderMSMBlur::TemporalSplitStatistics stats;
+        settings.stats = &stats;
         
         /* build hierarchy */
         auto root =
@@ -646,6 +659,11 @@ namespace embree
                                             bvh->scene->progressInterface,
                                             settings);
         bvh->set(root.ref,root.lbounds,pinfo.num_time_segments);
+
+        if (scene->device->verbosity(2)) {
+          Lock<MutexSys> lock(g_printMutex);
+          stats.print(std::cout);
+        }
       }
 
       void clear() {
@@ -700,6 +718,145 @@ namespace embree
 #if defined(__AVX__)
     Builder* BVH8GridMBSceneBuilderSAH (void* bvh, Scene* scene, size_t mode) { return new BVHNBuilderMBlurSAHGrid<8>((BVH8*)bvh,scene,8,1.0f,8,8); }
 #endif
+#endif
+
+#if defined(EMBREE_LOWEST_ISA)
+    struct temporal_split_budget_regression_test : public RegressionTest
+    {
+      typedef BVHBuilderMSMBlur Builder;
+      typedef BVHNodeRecordMB4D<size_t> NodeRecordMB4D;
+      static const size_t N = 16*1024;
+      static const unsigned int T = 8;
+
+      temporal_split_budget_regression_test(const char* name) : RegressionTest(name) {
+        registerRegressionTest(this);
+      }
+
+      struct NullMemoryMonitor : public MemoryMonitorInterface {
+        void memoryMonitor(ssize_t bytes, bool post, RTCMemoryCategory category) {}
+      };
+
+      /* small boxes that move half around a circle with different phases, thus all swept bounds overlap,
+       * with numMoving smaller than N the other boxes stand still on a grid far away from the circle */
+      struct CirclingBoxes
+      {
+        CirclingBoxes (size_t numMoving = N)
+          : numMoving(numMoving) {}
+
+        __forceinline BBox3fa bounds(unsigned int primID, size_t itime) const
+        {
+          if (primID >= numMoving) {
+            const Vec3fa center(100.0f+float(primID%128), float(primID/128), 0.0f);
+            return BBox3fa(center-Vec3fa(0.1f),center+Vec3fa(0.1f));
+          }
+          const float phi = float(pi)*(float(itime)/float(T) + 2.0f*float(primID)/float(numMoving));
+          const Vec3fa center(10.0f*cosf(phi), 10.0f*sinf(phi), 0.001f*float(primID%64));
+          return BBox3fa(center-Vec3fa(0.1f),center+Vec3fa(0.1f));
+        }
+
+        __forceinline LBBox3fa linearBounds(const PrimRefMB& prim, const BBox1f time_range) const {
+          return LBBox3fa([&] (size_t itime) { return bounds(prim.primID(),itime); }, time_range, float(T));
+        }
+
+        __forceinline PrimRefMB operator() (const PrimRefMB& prim, const BBox1f time_range) const {
+          const range<int> tbounds = getTimeSegmentRange(time_range, float(T));
+          return PrimRefMB(linearBounds(prim,time_range), tbounds.size(), BBox1f(0.0f,1.0f), T, 0, prim.primID());
+        }
+
+        size_t numMoving;
+      };
+
+      struct CreateAlloc {
+        void* operator() () const { return (void*) this; }
+      };
+
+      struct CreateNode {
+        template<typename BuildRecord> size_t operator() (BuildRecord* children, size_t numChildren, void* alloc, bool hasTimeSplits) const { return 0; }
+      };
+
+      struct SetNode {
+        template<typename BuildRecord, typename ChildRecord> void operator() (const BuildRecord& current, ChildRecord* children, size_t node, NodeRecordMB4D* values, size_t numChildren) const {}
+      };
+
+      /* counts the primitive references that end up in leaves */
+      struct CreateLeaf
+      {
+        CreateLeaf (std::atomic<size_t>* numLeafPrims, const CirclingBoxes& boxes)
+          : numLeafPrims(numLeafPrims), boxes(boxes) {}
+
+        NodeRecordMB4D operator() (const Builder::BuildRecord& current, void* alloc) const {
+          *numLeafPrims += current.prims.size();
+          return NodeRecordMB4D(0,current.prims.linearBounds(boxes),current.prims.time_range);
+        }
+
+        std::atomic<size_t>* numLeafPrims;
+        CirclingBoxes boxes;
+      };
+
+      /* builds the BVH and returns the number of additional primitive references created by temporal splits */
+      static bool build(float maxTimeSplitReplications, float minTimeSplitMotion, size_t& replicated, size_t numMoving = N)
+      {
+        NullMemoryMonitor monitor;
+        CirclingBoxes boxes(numMoving);
+        mvector<PrimRefMB> prims(&monitor,N);
+        PrimInfoMB pinfo(empty);
+        for (unsigned int i=0; i<N; i++) {
+          prims[i] = boxes(PrimRefMB(LBBox3fa(empty),1,BBox1f(0.0f,1.0f),T,0,i),BBox1f(0.0f,1.0f));
+          pinfo.add_primref(prims[i]);
+        }
+
+        Builder::Settings settings;
+        settings.branchingFactor = 4;
+        settings.maxLeafSize = 4;
+        settings.maxTimeSplitReplications = maxTimeSplitReplications;
+        settings.minTimeSplitMotion = minTimeSplitMotion;
+        Builder::TemporalSplitStatistics stats;
+        settings.stats = &stats;
+
+        std::atomic<size_t> numLeafPrims(0);
+        Builder::build<size_t>(prims,pinfo,&monitor,boxes,CreateAlloc(),CreateNode(),SetNode(),CreateLeaf(&numLeafPrims,boxes),[] (size_t) {},settings);
+        replicated = numLeafPrims-N;
+        return numLeafPrims >= N && stats.numReplicatedPrims == replicated;
+      }
+
+      bool run ()
+      {
+        /* without budget the overlapping swept bounds trigger many temporal splits */
+        bool passed = true;
+        size_t unlimited = 0;
+        passed &= build(inf,0.0f,unlimited);
+        passed &= unlimited > N/4;
+
+        /* the budget holds although subtrees get built in parallel */
+        for (float factor : { 0.25f, 0.01f, 0.0f })
+        {
+          size_t replicated = 0;
+          passed &= build(factor,0.0f,replicated);
+          passed &= replicated <= size_t(factor*float(N));
+        }
+
+        /* invalid factors disable temporal splits */
+        for (float factor : { -1.0f, float(nan), float(neg_inf) })
+        {
+          size_t replicated = 0;
+          passed &= build(factor,0.0f,replicated);
+          passed &= replicated == 0;
+        }
+
+        /* the boxes move too little for a motion threshold close to 1 */
+        size_t replicated = 0;
+        passed &= build(inf,0.99f,replicated);
+        passed &= replicated == 0;
+
+        /* few moving boxes in a mostly static scene still get temporal splits, as the motion is measured per subtree */
+        replicated = 0;
+        passed &= build(inf,0.5f,replicated,N/64);
+        passed &= replicated > 0;
+        return passed;
+      }
+    };
+
+    temporal_split_budget_regression_test temporal_split_budget_regression("temporal_split_budget_regression_test");
 #endif
   }
 }
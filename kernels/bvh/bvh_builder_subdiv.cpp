@@ -53,6 +53,22 @@ namespace embree
         return w*h;
       }
 
+      /*! returns the number of bytes the eager leaves of a patch allocate */
+      static size_t getEagerLeafBytes(unsigned pwidth, unsigned pheight)
+      {
+        size_t bytes = 0;
+        for (unsigned y=0; y<pheight-1; y+=SUBGRID-1)
+        {
+          for (unsigned x=0; x<pwidth-1; x+=SUBGRID-1)
+          {
+            const unsigned lwidth  = min(x+SUBGRID-1,pwidth-1)-x+1;
+            const unsigned lheight = min(y+SUBGRID-1,pheight-1)-y+1;
+            bytes += (GridSOA::getAllocationBytes(1,lwidth,lheight)+15) & ~size_t(15);
+          }
+        }
+        return bytes;
+      }
+
       __forceinline static unsigned createEager(SubdivPatch1Base& patch, Scene* scene, SubdivMesh* mesh, unsigned primID, Allocator& alloc, PrimRef* prims)
       {
         unsigned NN = 0;
@@ -86,9 +102,6 @@ namespace embree
  
         double t0 = bvh->preBuild(TOSTRING(isa) "::BVH" + toString(N) + "SubdivPatch1BuilderSAH");
 
-        //bvh->alloc.reset();
-        bvh->alloc.init_estimate(numPrimitives*sizeof(PrimRef));
-
         auto progress = [&] (size_t dn) { bvh->scene->progressMonitor(double(dn)); };
         auto virtualprogress = BuildProgressMonitorFromClosure(progress);
 
@@ -98,10 +111,13 @@ namespace embree
         Scene::Iterator<SubdivMesh> iter(scene);
         pstate.init(iter,size_t(1024));
 
+        /* count the sub patches and eager leaves, and the bytes all leaves will allocate */
+        std::atomic<size_t> leafBytes(0);
         PrimInfo pinfo1 = parallel_for_for_prefix_sum0( pstate, iter, PrimInfo(empty), [&](SubdivMesh* mesh, const range<size_t>& r, size_t k, size_t /*geomID*/) -> PrimInfo
         { 
           size_t p = 0;
           size_t g = 0;
+          size_t bytes = 0;
           for (size_t f=r.begin(); f!=r.end(); ++f) {          
             if (!mesh->valid(f)) continue;
             patch_eval_subdivision(mesh->getHalfEdge(0,f),[&](const Vec2f uv[4], const int subdiv[4], const float edge_level[4], int subPatch)
@@ -109,10 +125,12 @@ namespace embree
               float level[4]; SubdivPatch1Base::computeEdgeLevels(edge_level,subdiv,level);
               Vec2i grid = SubdivPatch1Base::computeGridSize(level);
               size_t num = getNumEagerLeaves(grid.x,grid.y);
+              bytes += getEagerLeafBytes(grid.x,grid.y);
               g+=num;
               p++;
             });
           }
+          leafBytes += bytes;
           return PrimInfo(p,g,empty);
         }, [](const PrimInfo& a, const PrimInfo& b) -> PrimInfo { return PrimInfo(a.begin+b.begin,a.end+b.end,empty); });
         size_t numSubPatches = pinfo1.begin;
@@ -127,6 +145,15 @@ namespace embree
           return;
         }
 
+        /* size the allocator for the tessellated grids and the BVH nodes above them */
+        const size_t nodeBytes = 2*pinfo1.end*sizeof(typename BVH::AABBNode)/N;
+        bvh->alloc.init_estimate(leafBytes+nodeBytes);
+        if (scene->device->verbosity(2)) {
+          Lock<MutexSys> lock(g_printMutex);
+          std::cout << "tessellating " << numSubPatches << " sub patches into " << pinfo1.end << " grids, estimated memory: " 
+                    << 1E-6*double(leafBytes) << " MB grids, " << 1E-6*double(nodeBytes) << " MB nodes" << std::endl;
+        }
+
         PrimInfo pinfo3 = parallel_for_for_prefix_sum1( pstate, iter, PrimInfo(empty), [&](SubdivMesh* mesh, const range<size_t>& r, size_t k, size_t geomID, const PrimInfo& base) -> PrimInfo
         {
           Allocator alloc = bvh->alloc.getCachedAllocator();
@@ -320,6 +347,10 @@ namespace embree
         settings.travCost = 1.0f;
         settings.intCost = 1.0f;
         settings.singleLeafTimeSegment = false;
+        settings.maxTimeSplitReplications = scene->device->max_temporal_split_replications;
+        settings.minTimeSplitMotion = scene->device->temporal_split_motion_threshold;
+        BVHBuilderMSMBlur::TemporalSplitStatistics stats;
+        settings.stats = &stats;
 
         /* build hierarchy */
         auto root =
@@ -333,6 +364,11 @@ namespace embree
                                              settings);
         
         bvh->set(root.ref,root.lbounds,pinfo.num_time_segments);
+
+        if (scene->device->verbosity(2)) {
+          Lock<MutexSys> lock(g_printMutex);
+          stats.print(std::cout);
+        }
       }
 
       void build() 
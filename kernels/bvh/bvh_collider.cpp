@@ -10,7 +10,8 @@ namespace embree
   {
 #define CSTAT(x)
 
-    size_t parallel_depth_threshold = 3;
+    /* node pairs below this combined depth are traversed in parallel, deeper pairs sequentially */
+    static const size_t parallel_depth_threshold = 12;
     CSTAT(std::atomic<size_t> bvh_collide_traversal_steps(0));
     CSTAT(std::atomic<size_t> bvh_collide_leaf_pairs(0));
     CSTAT(std::atomic<size_t> bvh_collide_leaf_iterations(0));
@@ -21,19 +22,6 @@ namespace embree
     CSTAT(std::atomic<size_t> bvh_collide_prim_intersections5(0));
     CSTAT(std::atomic<size_t> bvh_collide_prim_intersections(0));
 
-    struct Collision
-    {
-      __forceinline Collision() {}
-
-      __forceinline Collision (unsigned geomID0, unsigned primID0, unsigned geomID1, unsigned primID1)
-        : geomID0(geomID0), primID0(primID0), geomID1(geomID1), primID1(primID1) {}
-
-      unsigned geomID0;
-      unsigned primID0;
-      unsigned geomID1;
-      unsigned primID1;
-    };
-    
     template<int N>
     __forceinline size_t overlap(const BBox3fa& box0, const typename BVHN<N>::AABBNode& node1)
     {
@@ -108,11 +96,8 @@ namespace embree
     }
     
     template<int N>
-    __forceinline void BVHNColliderUserGeom<N>::processLeaf(NodeRef node0, NodeRef node1)
+    __forceinline void BVHNColliderUserGeom<N>::processLeaf(NodeRef node0, NodeRef node1, CollisionBuffer& collisions)
     {
-      Collision collisions[16];
-      size_t num_collisions = 0;
-
       size_t N0; Object* leaf0 = (Object*) node0.leaf(N0);
       size_t N1; Object* leaf1 = (Object*) node1.leaf(N1);
       for (size_t i=0; i<N0; i++) {
@@ -122,25 +107,40 @@ namespace embree
           const unsigned geomID1 = leaf1[j].geomID();
           const unsigned primID1 = leaf1[j].primID();
           if (this->scene0 == this->scene1 && geomID0 == geomID1 && primID0 == primID1) continue;
-          collisions[num_collisions++] = Collision(geomID0,primID0,geomID1,primID1);
-          if (num_collisions == 16) {
-            this->callback(this->userPtr,(RTCCollision*)&collisions,num_collisions);
-            num_collisions = 0;
+          collisions.add(geomID0,primID0,geomID1,primID1);
+        }
+      }
+    }
+
+    template<int N, typename Primitive>
+    __forceinline void BVHNColliderTriangle<N,Primitive>::processLeaf(NodeRef node0, NodeRef node1, CollisionBuffer& collisions)
+    {
+      size_t N0; Primitive* leaf0 = (Primitive*) node0.leaf(N0);
+      size_t N1; Primitive* leaf1 = (Primitive*) node1.leaf(N1);
+      for (size_t i=0; i<N0; i++) {
+        for (size_t ii=0; ii<leaf0[i].size(); ii++) {
+          const unsigned geomID0 = leaf0[i].geomID(ii);
+          const unsigned primID0 = leaf0[i].primID(ii);
+          for (size_t j=0; j<N1; j++) {
+            for (size_t jj=0; jj<leaf1[j].size(); jj++) {
+              const unsigned geomID1 = leaf1[j].geomID(jj);
+              const unsigned primID1 = leaf1[j].primID(jj);
+              if (intersect_triangle_triangle(this->scene0,geomID0,primID0,this->scene1,geomID1,primID1))
+                collisions.add(geomID0,primID0,geomID1,primID1);
+            }
           }
         }
       }
-      if (num_collisions)
-        this->callback(this->userPtr,(RTCCollision*)&collisions,num_collisions);
     }
 
     template<int N>
-    void BVHNCollider<N>::collide_recurse(NodeRef ref0, const BBox3fa& bounds0, NodeRef ref1, const BBox3fa& bounds1, size_t depth0, size_t depth1)
+    void BVHNCollider<N>::collide_recurse(NodeRef ref0, const BBox3fa& bounds0, NodeRef ref1, const BBox3fa& bounds1, size_t depth0, size_t depth1, CollisionBuffer& collisions)
     {
       CSTAT(bvh_collide_traversal_steps++);
       if (unlikely(ref0.isLeaf())) {
         if (unlikely(ref1.isLeaf())) {
           CSTAT(bvh_collide_leaf_pairs++);
-          processLeaf(ref0,ref1);
+          processLeaf(ref0,ref1,collisions);
           return;
         } else goto recurse_node1;
         
@@ -161,24 +161,22 @@ namespace embree
       recurse_node0:
         AABBNode* node0 = ref0.getAABBNode();
         size_t mask = overlap<N>(bounds1,*node0);
-        //for (size_t m=mask, i=bsf(m); m!=0; m=btc(m,i), i=bsf(m)) {
-        //for (size_t i=0; i<N; i++) {
-#if 0
-        if (depth0 < parallel_depth_threshold) 
+        if (depth0+depth1 < parallel_depth_threshold && (mask & (mask-1)))
         {
+          /* idle threads steal the child tasks, each task collects its own collisions */
           parallel_for(size_t(N), [&] ( size_t i ) {
-              if (mask & ( 1 << i)) {
+              if (mask & (size_t(1) << i)) {
+                CollisionBuffer task_collisions(callback,userPtr);
                 BVHN<N>::prefetch(node0->child(i),BVH_FLAG_ALIGNED_NODE);
-                collide_recurse(node0->child(i),node0->bounds(i),ref1,bounds1,depth0+1,depth1);
+                collide_recurse(node0->child(i),node0->bounds(i),ref1,bounds1,depth0+1,depth1,task_collisions);
               }
             });
         } 
         else
-#endif
         {
           for (size_t m=mask, i=bsf(m); m!=0; m=btc(m,i), i=bsf(m)) {
             BVHN<N>::prefetch(node0->child(i),BVH_FLAG_ALIGNED_NODE);
-            collide_recurse(node0->child(i),node0->bounds(i),ref1,bounds1,depth0+1,depth1);
+            collide_recurse(node0->child(i),node0->bounds(i),ref1,bounds1,depth0+1,depth1,collisions);
           }
         }
         return;
@@ -188,24 +186,21 @@ namespace embree
       recurse_node1:
         AABBNode* node1 = ref1.getAABBNode();
         size_t mask = overlap<N>(bounds0,*node1);
-        //for (size_t m=mask, i=bsf(m); m!=0; m=btc(m,i), i=bsf(m)) {
-        //for (size_t i=0; i<N; i++) {
-#if 0
-        if (depth1 < parallel_depth_threshold) 
+        if (depth0+depth1 < parallel_depth_threshold && (mask & (mask-1)))
         {
           parallel_for(size_t(N), [&] ( size_t i ) {
-              if (mask & ( 1 << i)) {
+              if (mask & (size_t(1) << i)) {
+                CollisionBuffer task_collisions(callback,userPtr);
                 BVHN<N>::prefetch(node1->child(i),BVH_FLAG_ALIGNED_NODE);
-                collide_recurse(ref0,bounds0,node1->child(i),node1->bounds(i),depth0,depth1+1);
+                collide_recurse(ref0,bounds0,node1->child(i),node1->bounds(i),depth0,depth1+1,task_collisions);
               }
             });
         }
         else
-#endif
         {
           for (size_t m=mask, i=bsf(m); m!=0; m=btc(m,i), i=bsf(m)) {
             BVHN<N>::prefetch(node1->child(i),BVH_FLAG_ALIGNED_NODE);
-            collide_recurse(ref0,bounds0,node1->child(i),node1->bounds(i),depth0,depth1+1);
+            collide_recurse(ref0,bounds0,node1->child(i),node1->bounds(i),depth0,depth1+1,collisions);
           }
         }
         return;
@@ -266,9 +261,6 @@ namespace embree
       CSTAT(bvh_collide_prim_intersections4 = 0);
       CSTAT(bvh_collide_prim_intersections5 = 0);
       CSTAT(bvh_collide_prim_intersections = 0);
-#if 0
-      collide_recurse(ref0,bounds0,ref1,bounds1,0,0);
-#else
       const int M = 2048;
       jobvector jobs[2];
       jobs[0].reserve(M);
@@ -299,14 +291,13 @@ namespace embree
         std::swap(source,target);
       }
 
-      /* parallel processing of all jobs */
+      /* parallel processing of all jobs, jobs near the root split further while they are traversed */
       parallel_for(size_t(jobs[source].size()), [&] ( size_t i ) {
           CollideJob& j = jobs[source][i];
-          collide_recurse(j.ref0,j.bounds0,j.ref1,j.bounds1,j.depth0,j.depth1);
+          CollisionBuffer collisions(callback,userPtr);
+          collide_recurse(j.ref0,j.bounds0,j.ref1,j.bounds1,j.depth0,j.depth1,collisions);
         });
-      
-      
-#endif
+
       CSTAT(PRINT(bvh_collide_traversal_steps));
       CSTAT(PRINT(bvh_collide_leaf_pairs));
       CSTAT(PRINT(bvh_collide_leaf_iterations));
@@ -325,6 +316,13 @@ namespace embree
         collide_recurse_entry(bvh0->root,bvh0->bounds.bounds(),bvh1->root,bvh1->bounds.bounds());
     }
 
+    template<int N, typename Primitive>
+    void BVHNColliderTriangle<N,Primitive>::collide(BVH* __restrict__ bvh0, BVH* __restrict__ bvh1, RTCCollideFunc callback, void* userPtr)
+    { 
+      BVHNColliderTriangle<N,Primitive>(bvh0->scene,bvh1->scene,callback,userPtr).
+        collide_recurse_entry(bvh0->root,bvh0->bounds.bounds(),bvh1->root,bvh1->bounds.bounds());
+    }
+
 #if defined (EMBREE_LOWEST_ISA)
     struct collision_regression_test : public RegressionTest
     {
@@ -367,9 +365,15 @@ namespace embree
     ////////////////////////////////////////////////////////////////////////////////
 
     DEFINE_COLLIDER(BVH4ColliderUserGeom,BVHNColliderUserGeom<4>);
+    DEFINE_COLLIDER(BVH4ColliderTriangle4,BVHNColliderTriangle<4 COMMA Triangle4>);
+    DEFINE_COLLIDER(BVH4ColliderTriangle4v,BVHNColliderTriangle<4 COMMA Triangle4v>);
+    DEFINE_COLLIDER(BVH4ColliderTriangle4i,BVHNColliderTriangle<4 COMMA Triangle4i>);
 
 #if defined(__AVX__)
     DEFINE_COLLIDER(BVH8ColliderUserGeom,BVHNColliderUserGeom<8>);
+    DEFINE_COLLIDER(BVH8ColliderTriangle4,BVHNColliderTriangle<8 COMMA Triangle4>);
+    DEFINE_COLLIDER(BVH8ColliderTriangle4v,BVHNColliderTriangle<8 COMMA Triangle4v>);
+    DEFINE_COLLIDER(BVH8ColliderTriangle4i,BVHNColliderTriangle<8 COMMA Triangle4i>);
 #endif
   }
 }
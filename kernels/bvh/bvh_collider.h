@@ -4,13 +4,59 @@
 #pragma once
 
 #include "bvh.h"
+#include "../geometry/triangle.h"
 #include "../geometry/trianglev.h"
+#include "../geometry/trianglei.h"
 #include "../geometry/object.h"
 
 namespace embree
 {
   namespace isa
   {
+    struct Collision
+    {
+      __forceinline Collision() {}
+
+      __forceinline Collision (unsigned geomID0, unsigned primID0, unsigned geomID1, unsigned primID1)
+        : geomID0(geomID0), primID0(primID0), geomID1(geomID1), primID1(primID1) {}
+
+      unsigned geomID0;
+      unsigned primID0;
+      unsigned geomID1;
+      unsigned primID1;
+    };
+
+    /*! collisions found by a single task, handed to the callback in large batches */
+    struct CollisionBuffer
+    {
+      static const size_t max_collisions = 256;
+
+      __forceinline CollisionBuffer (RTCCollideFunc callback, void* userPtr)
+        : callback(callback), userPtr(userPtr), num_collisions(0) {}
+
+      __forceinline ~CollisionBuffer() {
+        flush();
+      }
+
+      __forceinline void add(unsigned geomID0, unsigned primID0, unsigned geomID1, unsigned primID1)
+      {
+        collisions[num_collisions++] = Collision(geomID0,primID0,geomID1,primID1);
+        if (unlikely(num_collisions == max_collisions)) flush();
+      }
+
+      __forceinline void flush()
+      {
+        if (num_collisions) callback(userPtr,(RTCCollision*)collisions,(unsigned int)num_collisions);
+        num_collisions = 0;
+      }
+
+    private:
+      RTCCollideFunc callback;
+      void* userPtr;
+      size_t num_collisions;
+      Collision collisions[max_collisions];
+    };
+
     template<int N>
       class BVHNCollider
     {
@@ -43,8 +89,8 @@ namespace embree
         : scene0(scene0), scene1(scene1), callback(callback), userPtr(userPtr) {}
 
     public:
-      virtual void processLeaf(NodeRef leaf0, NodeRef leaf1) = 0;
-      void collide_recurse(NodeRef node0, const BBox3fa& bounds0, NodeRef node1, const BBox3fa& bounds1, size_t depth0, size_t depth1);
+      virtual void processLeaf(NodeRef leaf0, NodeRef leaf1, CollisionBuffer& collisions) = 0;
+      void collide_recurse(NodeRef node0, const BBox3fa& bounds0, NodeRef node1, const BBox3fa& bounds1, size_t depth0, size_t depth1, CollisionBuffer& collisions);
       void collide_recurse_entry(NodeRef node0, const BBox3fa& bounds0, NodeRef node1, const BBox3fa& bounds1);
     
     protected:
@@ -64,7 +110,22 @@ namespace embree
       __forceinline BVHNColliderUserGeom (Scene* scene0, Scene* scene1, RTCCollideFunc callback, void* userPtr)
         : BVHNCollider<N>(scene0,scene1,callback,userPtr) {}
 
-      virtual void processLeaf(NodeRef leaf0, NodeRef leaf1);
+      virtual void processLeaf(NodeRef leaf0, NodeRef leaf1, CollisionBuffer& collisions);
+    public:
+      static void collide(BVH* __restrict__ bvh0, BVH* __restrict__ bvh1, RTCCollideFunc callback, void* userPtr);
+    };
+
+    template<int N, typename Primitive>
+      class BVHNColliderTriangle : public BVHNCollider<N>
+    {
+      typedef BVHN<N> BVH;
+      typedef typename BVH::NodeRef NodeRef;
+      typedef typename BVH::AABBNode AABBNode;
+
+      __forceinline BVHNColliderTriangle (Scene* scene0, Scene* scene1, RTCCollideFunc callback, void* userPtr)
+        : BVHNCollider<N>(scene0,scene1,callback,userPtr) {}
+
+      virtual void processLeaf(NodeRef leaf0, NodeRef leaf1, CollisionBuffer& collisions);
     public:
       static void collide(BVH* __restrict__ bvh0, BVH* __restrict__ bvh1, RTCCollideFunc callback, void* userPtr);
     };
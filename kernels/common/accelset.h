@@ -37,6 +37,8 @@ namespace embree
   public:
     typedef RTCIntersectFunctionN IntersectFuncN;  
     typedef RTCOccludedFunctionN OccludedFuncN;
+    typedef RTCIntersectFunctionBatch IntersectFuncBatch;
+    typedef RTCOccludedFunctionBatch OccludedFuncBatch;
     typedef void (*ErrorFunc) ();
 
       struct IntersectorN
@@ -50,6 +52,8 @@ namespace embree
         static const char* type;
         IntersectFuncN intersect;
         OccludedFuncN occluded; 
+        IntersectFuncBatch intersectBatch;
+        OccludedFuncBatch occludedBatch;
         const char* name;
       };
       
@@ -148,7 +152,7 @@ namespace embree
       __forceinline void intersect (RayHit& ray, unsigned int geomID, unsigned int primID, IntersectContext* context, ReportIntersectionFunc report) 
       {
         assert(primID < size());
-        assert(intersectorN.intersect);
+        assert(intersectorN.intersect || intersectorN.intersectBatch);
         
         int mask = -1;
         IntersectFunctionNArguments args;
@@ -163,14 +167,15 @@ namespace embree
         args.geometry = this;
         args.report = report;
         
-        intersectorN.intersect(&args);
+        if (likely(intersectorN.intersect)) intersectorN.intersect(&args);
+        else intersectorN.intersectBatch(&args,&primID,1);
       }
 
       /*! Tests if single ray is occluded by the scene. */
       __forceinline void occluded (Ray& ray, unsigned int geomID, unsigned int primID, IntersectContext* context, ReportOcclusionFunc report)
       {
         assert(primID < size());
-        assert(intersectorN.occluded);
+        assert(intersectorN.occluded || intersectorN.occludedBatch);
         
         int mask = -1;
         OccludedFunctionNArguments args;
@@ -185,7 +190,8 @@ namespace embree
         args.geometry = this;
         args.report = report;
         
-        intersectorN.occluded(&args);
+        if (likely(intersectorN.occluded)) intersectorN.occluded(&args);
+        else intersectorN.occludedBatch(&args,&primID,1);
       }
    
       /*! Intersects a packet of K rays with the scene. */
@@ -193,7 +199,7 @@ namespace embree
         __forceinline void intersect (const vbool<K>& valid, RayHitK<K>& ray, unsigned int geomID, unsigned int primID, IntersectContext* context, ReportIntersectionFunc report) 
       {
         assert(primID < size());
-        assert(intersectorN.intersect);
+        assert(intersectorN.intersect || intersectorN.intersectBatch);
         
         vint<K> mask = valid.mask32();
         IntersectFunctionNArguments args;
@@ -208,7 +214,8 @@ namespace embree
         args.geometry = this;
         args.report = report;
          
-        intersectorN.intersect(&args);
+        if (likely(intersectorN.intersect)) intersectorN.intersect(&args);
+        else intersectorN.intersectBatch(&args,&primID,1);
       }
 
       /*! Tests if a packet of K rays is occluded by the scene. */
@@ -216,7 +223,7 @@ namespace embree
         __forceinline void occluded (const vbool<K>& valid, RayK<K>& ray, unsigned int geomID, unsigned int primID, IntersectContext* context, ReportOcclusionFunc report)
       {
         assert(primID < size());
-        assert(intersectorN.occluded);
+        assert(intersectorN.occluded || intersectorN.occludedBatch);
         
         vint<K> mask = valid.mask32();
         OccludedFunctionNArguments args;
@@ -231,7 +238,98 @@ namespace embree
         args.geometry = this;
         args.report = report;
         
-        intersectorN.occluded(&args);
+        if (likely(intersectorN.occluded)) intersectorN.occluded(&args);
+        else intersectorN.occludedBatch(&args,&primID,1);
+      }
+
+      /*! Intersects a single ray with a batch of primitives. */
+      __forceinline void intersect (RayHit& ray, unsigned int geomID, const unsigned int* primIDs, size_t numPrimIDs, IntersectContext* context, ReportIntersectionFunc report) 
+      {
+        assert(numPrimIDs > 0);
+        assert(intersectorN.intersectBatch);
+        
+        int mask = -1;
+        IntersectFunctionNArguments args;
+        args.valid = &mask;
+        args.geometryUserPtr = userPtr;
+        args.context = context->user;
+        args.rayhit = (RTCRayHitN*)&ray;
+        args.N = 1;
+        args.geomID = geomID;
+        args.primID = primIDs[0];
+        args.internal_context = context;
+        args.geometry = this;
+        args.report = report;
+        
+        intersectorN.intersectBatch(&args,primIDs,(unsigned int)numPrimIDs);
+      }
+
+      /*! Tests if single ray is occluded by a batch of primitives. */
+      __forceinline void occluded (Ray& ray, unsigned int geomID, const unsigned int* primIDs, size_t numPrimIDs, IntersectContext* context, ReportOcclusionFunc report)
+      {
+        assert(numPrimIDs > 0);
+        assert(intersectorN.occludedBatch);
+        
+        int mask = -1;
+        OccludedFunctionNArguments args;
+        args.valid = &mask;
+        args.geometryUserPtr = userPtr;
+        args.context = context->user;
+        args.ray = (RTCRayN*)&ray;
+        args.N = 1;
+        args.geomID = geomID;
+        args.primID = primIDs[0];
+        args.internal_context = context;
+        args.geometry = this;
+        args.report = report;
+        
+        intersectorN.occludedBatch(&args,primIDs,(unsigned int)numPrimIDs);
+      }
+
+      /*! Intersects a packet of K rays with a batch of primitives. */
+      template<int K>
+        __forceinline void intersect (const vbool<K>& valid, RayHitK<K>& ray, unsigned int geomID, const unsigned int* primIDs, size_t numPrimIDs, IntersectContext* context, ReportIntersectionFunc report) 
+      {
+        assert(numPrimIDs > 0);
+        assert(intersectorN.intersectBatch);
+        
+        vint<K> mask = valid.mask32();
+        IntersectFunctionNArguments args;
+        args.valid = (int*)&mask;
+        args.geometryUserPtr = userPtr;
+        args.context = context->user;
+        args.rayhit = (RTCRayHitN*)&ray;
+        args.N = K;
+        args.geomID = geomID;
+        args.primID = primIDs[0];
+        args.internal_context = context;
+        args.geometry = this;
+        args.report = report;
+         
+        intersectorN.intersectBatch(&args,primIDs,(unsigned int)numPrimIDs);
+      }
+
+      /*! Tests if a packet of K rays is occluded by a batch of primitives. */
+      template<int K>
+        __forceinline void occluded (const vbool<K>& valid, RayK<K>& ray, unsigned int geomID, const unsigned int* primIDs, size_t numPrimIDs, IntersectContext* context, ReportOcclusionFunc report)
+      {
+        assert(numPrimIDs > 0);
+        assert(intersectorN.occludedBatch);
+        
+        vint<K> mask = valid.mask32();
+        OccludedFunctionNArguments args;
+        args.valid = (int*)&mask;
+        args.geometryUserPtr = userPtr;
+        args.context = context->user;
+        args.ray = (RTCRayN*)&ray;
+        args.N = K;
+        args.geomID = geomID;
+        args.primID = primIDs[0];
+        args.internal_context = context;
+        args.geometry = this;
+        args.report = report;
+        
+        intersectorN.occludedBatch(&args,primIDs,(unsigned int)numPrimIDs);
       }
 
     public:
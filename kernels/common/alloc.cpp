@@ -9,6 +9,119 @@
 
 namespace embree
 {
+  BlockPool::BlockPool (size_t maxBytes, MemoryStatistics* statistics)
+    : bytesPooled(0), maxBytes(maxBytes), statistics(statistics)
+  {
+    for (size_t i=0; i<2; i++)
+      for (size_t j=0; j<NUM_SIZE_CLASSES; j++)
+        lists[i][j].store(nullptr);
+  }
+
+  BlockPool::~BlockPool () {
+    trim(0);
+  }
+
+  void BlockPool::push(std::atomic<Item*>& list, Item* first, Item* last)
+  {
+    Item* head = list.load();
+    do {
+      last->next = head;
+    } while (!list.compare_exchange_weak(head,first));
+  }
+
+  void BlockPool::free(Item* item)
+  {
+    if (item->os_malloc) os_free(item,item->bytes,item->huge_pages);
+    else                 alignedFree(item);
+  }
+
+  BlockPool::PooledBlock BlockPool::acquire(bool os_malloc, size_t bytes)
+  {
+    PooledBlock block;
+    if (bytesPooled.load() == 0)
+      return block;
+
+    /* blocks of the same size class may be too small, all blocks of the next size class are large enough */
+    const size_t sizeClass = bsr(bytes);
+    for (size_t i=sizeClass; i<min(sizeClass+2,NUM_SIZE_CLASSES); i++)
+    {
+      /* detach the whole list, other threads see an empty list meanwhile */
+      Item* items = lists[os_malloc][i].exchange(nullptr);
+      if (items == nullptr) continue;
+
+      /* take the first block that is large enough */
+      Item* found = nullptr;
+      Item* first = nullptr;
+      Item* last = nullptr;
+      for (Item* item = items; item; )
+      {
+        Item* next = item->next;
+        if (found == nullptr && item->bytes >= bytes) found = item;
+        else {
+          item->next = nullptr;
+          if (last) last->next = item; else first = item;
+          last = item;
+        }
+        item = next;
+      }
+
+      /* put the remaining blocks back */
+      if (first) push(lists[os_malloc][i],first,last);
+      if (found == nullptr) continue;
+
+      bytesPooled -= found->bytes;
+      if (statistics) statistics->add(RTC_MEMORY_CATEGORY_BLOCK_POOL,-ssize_t(found->bytes));
+      block.ptr = found;
+      block.bytes = found->bytes;
+      block.huge_pages = found->huge_pages;
+      return block;
+    }
+    return block;
+  }
+
+  bool BlockPool::release(void* ptr, size_t bytes, bool os_malloc, bool huge_pages)
+  {
+    assert(bytes >= sizeof(Item));
+    if (bytesPooled.fetch_add(bytes)+bytes > maxBytes.load()) {
+      bytesPooled -= bytes;
+      return false;
+    }
+
+    Item* item = (Item*) ptr;
+    item->bytes = bytes;
+    item->os_malloc = os_malloc;
+    item->huge_pages = huge_pages;
+    push(list(os_malloc,bytes),item,item);
+    if (statistics) statistics->add(RTC_MEMORY_CATEGORY_BLOCK_POOL,bytes);
+    return true;
+  }
+
+  void BlockPool::trim(size_t maxBytes_i)
+  {
+    maxBytes.store(maxBytes_i);
+
+    /* free the largest blocks first */
+    for (ssize_t i=NUM_SIZE_CLASSES-1; i>=0 && bytesPooled.load() > maxBytes_i; i--)
+    {
+      for (size_t j=0; j<2 && bytesPooled.load() > maxBytes_i; j++)
+      {
+        Item* items = lists[j][i].exchange(nullptr);
+        while (items && bytesPooled.load() > maxBytes_i) {
+          Item* next = items->next;
+          bytesPooled -= items->bytes;
+          if (statistics) statistics->add(RTC_MEMORY_CATEGORY_BLOCK_POOL,-ssize_t(items->bytes));
+          free(items);
+          items = next;
+        }
+        if (items) {
+          Item* last = items;
+          while (last->next) last = last->next;
+          push(lists[j][i],items,last);
+        }
+      }
+    }
+  }
+
   __thread FastAllocator::ThreadLocal2* FastAllocator::thread_local_allocator2 = nullptr;
   SpinLock FastAllocator::s_thread_local_allocators_lock;
   std::vector<std::unique_ptr<FastAllocator::ThreadLocal2>> FastAllocator::s_thread_local_allocators;
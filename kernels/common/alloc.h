@@ -14,7 +14,70 @@
 
 namespace embree
 {
-  class FastAllocator
+  /*! Device wide pool of memory blocks freed by the FastAllocators,
+   *  bucketed by size class and reused by later builds. The lists
+   *  are lock-free, a list is always detached completely when taking
+   *  blocks out, thus popping cannot suffer from the ABA problem. */
+  class BlockPool
+  {
+    static const size_t NUM_SIZE_CLASSES = 64;
+
+    /*! header stored inside each pooled block */
+    struct Item
+    {
+      Item* next;         //!< next block of the same size class
+      size_t bytes;       //!< size of the block in bytes
+      bool os_malloc;     //!< block got allocated using os_malloc
+      bool huge_pages;    //!< block uses huge pages
+    };
+
+  public:
+
+    /*! pooled memory block */
+    struct PooledBlock
+    {
+      __forceinline PooledBlock ()
+        : ptr(nullptr), bytes(0), huge_pages(false) {}
+
+      void* ptr;
+      size_t bytes;
+      bool huge_pages;
+    };
+
+    BlockPool (size_t maxBytes, MemoryStatistics* statistics = nullptr);
+    ~BlockPool ();
+
+    /*! takes a block of at least the specified size out of the pool, returns an empty block if none is found */
+    PooledBlock acquire(bool os_malloc, size_t bytes);
+
+    /*! puts a block into the pool, returns false if this would exceed the maximal pool size */
+    bool release(void* ptr, size_t bytes, bool os_malloc, bool huge_pages);
+
+    /*! sets the maximal pool size and frees blocks until the pool fits */
+    void trim(size_t maxBytes);
+
+    /*! returns the number of bytes in the pool */
+    __forceinline size_t size() const { return bytesPooled.load(); }
+
+    /*! returns the maximal number of bytes in the pool */
+    __forceinline size_t maxSize() const { return maxBytes.load(); }
+
+  private:
+    __forceinline std::atomic<Item*>& list(bool os_malloc, size_t bytes) {
+      return lists[os_malloc][bsr(bytes)];
+    }
+
+    void push(std::atomic<Item*>& list, Item* first, Item* last);
+    static void free(Item* item);
+
+  private:
+    std::atomic<Item*> lists[2][NUM_SIZE_CLASSES];
+    std::atomic<size_t> bytesPooled;
+    std::atomic<size_t> maxBytes;
+    MemoryStatistics* statistics;
+  };
+
+  class FastAllocator : public MemoryMonitorInterface
   {
     /*! maximum supported alignment */
     static const size_t maxAlignment = 64;
@@ -40,7 +103,7 @@ namespace embree
 
       /*! Constructor for usage with ThreadLocalData */
       __forceinline ThreadLocal (ThreadLocal2* parent) 
-	: parent(parent), ptr(nullptr), cur(0), end(0), allocBlockSize(0), bytesUsed(0), bytesWasted(0) {}
+	: parent(parent), ptr(nullptr), cur(0), end(0), allocBlockSize(0), bytesUsed(0), bytesUsedLeaves(0), bytesWasted(0) {}
 
       /*! initialize allocator */
       void init(FastAllocator* alloc) 
@@ -48,6 +111,7 @@ namespace embree
         ptr = nullptr;
 	cur = end = 0;
         bytesUsed = 0;
+        bytesUsedLeaves = 0;
         bytesWasted = 0;
         allocBlockSize = 0;
         if (alloc) allocBlockSize = alloc->defaultBlockSize;
@@ -102,9 +166,20 @@ namespace embree
         return nullptr;
       }
 
+      /* Allocate aligned memory for leaves from the threads memory block. */
+      __forceinline void* malloc_leaf(FastAllocator* alloc, size_t bytes, size_t align = 16)
+      {
+        void* ptr = malloc(alloc,bytes,align);
+        bytesUsedLeaves += bytes; // counted after malloc, as binding to a new allocator clears the counters
+        return ptr;
+      }
+
       
       /*! returns amount of used bytes */
       __forceinline size_t getUsedBytes() const { return bytesUsed; }
+
+      /*! returns amount of used bytes of leaf allocations */
+      __forceinline size_t getUsedLeafBytes() const { return bytesUsedLeaves; }
   
       /*! returns amount of free bytes */
       __forceinline size_t getFreeBytes() const { return end-cur; }
@@ -119,6 +194,7 @@ namespace embree
       size_t end;            //!< end of the memory block
       size_t allocBlockSize; //!< block size for allocations
       size_t bytesUsed;      //!< number of total bytes allocated
+      size_t bytesUsedLeaves;//!< number of bytes allocated for leaves
       size_t bytesWasted;    //!< number of bytes wasted
     };
 
@@ -144,6 +220,7 @@ namespace embree
         //if (alloc.load() == alloc_i) return; // not required as only one thread calls bind
         if (alloc.load()) {
           alloc.load()->bytesUsed   += alloc0.getUsedBytes()   + alloc1.getUsedBytes();
+          alloc.load()->bytesUsedLeaves += alloc0.getUsedLeafBytes() + alloc1.getUsedLeafBytes();
           alloc.load()->bytesFree   += alloc0.getFreeBytes()   + alloc1.getFreeBytes();
           alloc.load()->bytesWasted += alloc0.getWastedBytes() + alloc1.getWastedBytes();
         }
@@ -165,6 +242,7 @@ namespace embree
 #endif
         if (alloc.load() != alloc_i) return; // required as a different thread calls unbind
         alloc.load()->bytesUsed   += alloc0.getUsedBytes()   + alloc1.getUsedBytes();
+        alloc.load()->bytesUsedLeaves += alloc0.getUsedLeafBytes() + alloc1.getUsedLeafBytes();
         alloc.load()->bytesFree   += alloc0.getFreeBytes()   + alloc1.getFreeBytes();
         alloc.load()->bytesWasted += alloc0.getWastedBytes() + alloc1.getWastedBytes();
         alloc0.init(nullptr);
@@ -183,9 +261,10 @@ namespace embree
       ThreadLocal alloc1;
     };
 
-    FastAllocator (Device* device, bool osAllocation) 
-      : device(device), slotMask(0), usedBlocks(nullptr), freeBlocks(nullptr), use_single_mode(false), defaultBlockSize(PAGE_SIZE), estimatedSize(0),
-        growSize(PAGE_SIZE), maxGrowSize(maxAllocationSize), log2_grow_size_scale(0), bytesUsed(0), bytesFree(0), bytesWasted(0), atype(osAllocation ? EMBREE_OS_MALLOC : ALIGNED_MALLOC),
+    FastAllocator (Device* device, bool osAllocation, MemoryStatistics* statistics = nullptr) 
+      : device(device), statistics(statistics), slotMask(0), usedBlocks(nullptr), freeBlocks(nullptr), use_single_mode(false), defaultBlockSize(PAGE_SIZE), estimatedSize(0),
+        growSize(PAGE_SIZE), maxGrowSize(maxAllocationSize), log2_grow_size_scale(0), bytesUsed(0), bytesUsedLeaves(0), bytesFree(0), bytesWasted(0),
+        bytesReportedNodes(0), bytesReportedLeaves(0), atype(osAllocation ? EMBREE_OS_MALLOC : ALIGNED_MALLOC),
         primrefarray(device,0)
     {
       for (size_t i=0; i<MAX_THREAD_USED_BLOCK_SLOTS; i++)
@@ -205,13 +284,29 @@ namespace embree
       return device;
     }
 
+    /*! returns the block pool of the device attached to this allocator */
+    BlockPool* blockPool() const {
+      return device ? device->blockPool.get() : nullptr;
+    }
+
+    /*! invokes the memory monitor of the device and records the bytes in the memory statistics of the scene */
+    void memoryMonitor(ssize_t bytes, bool post, RTCMemoryCategory category)
+    {
+      if (statistics && post) statistics->add(category,bytes);
+      if (device) device->memoryMonitor(bytes,post,category);
+      if (statistics && !post) statistics->add(category,bytes);
+    }
+
     void share(mvector<PrimRef>& primrefarray_i) {
+      moveSharedMemoryStatistics(false);
       primrefarray = std::move(primrefarray_i);
+      moveSharedMemoryStatistics(true);
     }
 
     void unshare(mvector<PrimRef>& primrefarray_o)
     {
       reset(); // this removes blocks that are allocated inside the shared primref array
+      moveSharedMemoryStatistics(false);
       primrefarray_o = std::move(primrefarray);
     }
 
@@ -281,7 +376,7 @@ namespace embree
       }
 
       __forceinline void* malloc1 (size_t bytes, size_t align = 16) const {
-        return talloc1->malloc(alloc,bytes,align);
+        return talloc1->malloc_leaf(alloc,bytes,align);
       }
 
     public:
@@ -416,7 +511,7 @@ namespace embree
       slotMask = MAX_THREAD_USED_BLOCK_SLOTS-1; // FIXME: remove
       if (usedBlocks.load() || freeBlocks.load()) { reset(); return; }
       if (bytesReserve == 0) bytesReserve = bytesAllocate;
-      freeBlocks = Block::create(device,bytesAllocate,bytesReserve,nullptr,atype);
+      freeBlocks = Block::create(this,blockPool(),bytesAllocate,bytesReserve,nullptr,atype);
       estimatedSize = bytesEstimate;
       initGrowSizeAndNumSlots(bytesEstimate,true);
     }
@@ -441,14 +536,18 @@ namespace embree
       /* unbind all thread local allocators */
       for (auto alloc : thread_local_allocators) alloc->unbind(this);
       thread_local_allocators.clear();
+
+      updateMemoryStatistics();
     }
 
     /*! resets the allocator, memory blocks get reused */
     void reset ()
     {
       internal_fix_used_blocks();
+      resetMemoryStatistics();
 
       bytesUsed.store(0);
+      bytesUsedLeaves.store(0);
       bytesFree.store(0);
       bytesWasted.store(0);
 
@@ -479,11 +578,14 @@ namespace embree
     __forceinline void clear()
     {
       cleanup();
+      resetMemoryStatistics();
+      moveSharedMemoryStatistics(false);
       bytesUsed.store(0);
+      bytesUsedLeaves.store(0);
       bytesFree.store(0);
       bytesWasted.store(0);
-      if (usedBlocks.load() != nullptr) usedBlocks.load()->clear_list(device); usedBlocks = nullptr;
-      if (freeBlocks.load() != nullptr) freeBlocks.load()->clear_list(device); freeBlocks = nullptr;
+      if (usedBlocks.load() != nullptr) usedBlocks.load()->clear_list(this,blockPool()); usedBlocks = nullptr;
+      if (freeBlocks.load() != nullptr) freeBlocks.load()->clear_list(this,blockPool()); freeBlocks = nullptr;
       for (size_t i=0; i<MAX_THREAD_USED_BLOCK_SLOTS; i++) {
         threadUsedBlocks[i] = nullptr;
         threadBlocks[i] = nullptr;
@@ -491,6 +593,42 @@ namespace embree
       primrefarray.clear();
     }
 
+    /*! moves the bytes used by the last build from the unused category to the node and leaf categories */
+    void updateMemoryStatistics()
+    {
+      const size_t leaves = min(bytesUsedLeaves.load(),bytesUsed.load());
+      const size_t nodes = bytesUsed.load()-leaves;
+      moveMemoryStatistics(RTC_MEMORY_CATEGORY_ACCEL_UNUSED,RTC_MEMORY_CATEGORY_ACCEL_NODES,ssize_t(nodes)-ssize_t(bytesReportedNodes));
+      moveMemoryStatistics(RTC_MEMORY_CATEGORY_ACCEL_UNUSED,RTC_MEMORY_CATEGORY_ACCEL_LEAVES,ssize_t(leaves)-ssize_t(bytesReportedLeaves));
+      bytesReportedNodes = nodes;
+      bytesReportedLeaves = leaves;
+    }
+
+    /*! moves the bytes of nodes and leaves back to the unused category */
+    void resetMemoryStatistics()
+    {
+      moveMemoryStatistics(RTC_MEMORY_CATEGORY_ACCEL_NODES,RTC_MEMORY_CATEGORY_ACCEL_UNUSED,bytesReportedNodes);
+      moveMemoryStatistics(RTC_MEMORY_CATEGORY_ACCEL_LEAVES,RTC_MEMORY_CATEGORY_ACCEL_UNUSED,bytesReportedLeaves);
+      bytesReportedNodes = bytesReportedLeaves = 0;
+    }
+
+    /*! the shared primref array is build temporary memory of the device but belongs to the acceleration structure while shared */
+    void moveSharedMemoryStatistics(bool share)
+    {
+      const ssize_t bytes = primrefarray.capacity()*sizeof(PrimRef);
+      if (device) {
+        if (share) device->memoryStatistics.move(RTC_MEMORY_CATEGORY_BUILD_TEMPORARIES,RTC_MEMORY_CATEGORY_ACCEL_UNUSED,bytes);
+        else       device->memoryStatistics.move(RTC_MEMORY_CATEGORY_ACCEL_UNUSED,RTC_MEMORY_CATEGORY_BUILD_TEMPORARIES,bytes);
+      }
+      if (statistics) statistics->add(RTC_MEMORY_CATEGORY_ACCEL_UNUSED,share ? bytes : -bytes);
+    }
+
+    void moveMemoryStatistics(RTCMemoryCategory from, RTCMemoryCategory to, ssize_t bytes)
+    {
+      if (device) device->memoryStatistics.move(from,to,bytes);
+      if (statistics) statistics->move(from,to,bytes);
+    }
+
     __forceinline size_t incGrowSizeScale()
     {
       size_t scale = log2_grow_size_scale.fetch_add(1)+1;
@@ -509,7 +647,7 @@ namespace embree
         size_t slot = threadID & slotMask;
 	Block* myUsedBlocks = threadUsedBlocks[slot];
         if (myUsedBlocks) {
-          void* ptr = myUsedBlocks->malloc(device,bytes,align,partial);
+          void* ptr = myUsedBlocks->malloc(this,bytes,align,partial);
           if (ptr) return ptr;
         }
 
@@ -529,7 +667,7 @@ namespace embree
             const size_t alignedBytes = (bytes+(align-1)) & ~(align-1);
             const size_t allocSize = max(min(growSize,maxGrowSize),alignedBytes);
             assert(allocSize >= bytes);
-            threadBlocks[slot] = threadUsedBlocks[slot] = Block::create(device,allocSize,allocSize,threadBlocks[slot],atype); // FIXME: a large allocation might throw away a block here!
+            threadBlocks[slot] = threadUsedBlocks[slot] = Block::create(this,blockPool(),allocSize,allocSize,threadBlocks[slot],atype); // FIXME: a large allocation might throw away a block here!
             // FIXME: a direct allocation should allocate inside the block here, and not in the next loop! a different thread could do some allocation and make the large allocation fail.
           }
           continue;
@@ -553,7 +691,7 @@ namespace embree
 	      freeBlocks = nextFreeBlock;
 	    } else {
               const size_t allocSize = min(growSize*incGrowSizeScale(),maxGrowSize);
-	      usedBlocks = threadUsedBlocks[slot] = Block::create(device,allocSize,allocSize,usedBlocks,atype); // FIXME: a large allocation should get delivered directly, like above!
+	      usedBlocks = threadUsedBlocks[slot] = Block::create(this,blockPool(),allocSize,allocSize,usedBlocks,atype); // FIXME: a large allocation should get delivered directly, like above!
 	    }
           }
         }
@@ -742,7 +880,7 @@ namespace embree
 
     struct Block
     {
-      static Block* create(MemoryMonitorInterface* device, size_t bytesAllocate, size_t bytesReserve, Block* next, AllocationType atype)
+      static Block* create(MemoryMonitorInterface* device, BlockPool* pool, size_t bytesAllocate, size_t bytesReserve, Block* next, AllocationType atype)
       {
         /* We avoid using os_malloc for small blocks as this could
          * cause a risk of fragmenting the virtual address space and
@@ -761,6 +899,30 @@ namespace embree
           bytesReserve  = ((bytesReserve +PAGE_SIZE-1) & ~(PAGE_SIZE-1));
         }
 
+        /* try to reuse a block of the device's block pool, the whole
+         * block is accounted as allocated such that clear_block reports
+         * exactly the bytes the pool accounts when taking it back */
+        if (pool)
+        {
+          const bool os_malloc = atype == EMBREE_OS_MALLOC;
+          const BlockPool::PooledBlock block = pool->acquire(os_malloc,os_malloc ? bytesReserve : bytesAllocate);
+          if (block.ptr)
+          {
+            if (device) {
+              try {
+                device->memoryMonitor(block.bytes,false,RTC_MEMORY_CATEGORY_ACCEL_UNUSED);
+              } catch (...) {
+                if (!pool->release(block.ptr,block.bytes,os_malloc,block.huge_pages)) {
+                  if (os_malloc) os_free(block.ptr,block.bytes,block.huge_pages);
+                  else           alignedFree(block.ptr);
+                }
+                throw;
+              }
+            }
+            return new (block.ptr) Block(atype,block.bytes-sizeof_Header,block.bytes-sizeof_Header,next,0,block.huge_pages);
+          }
+        }
+
         /* either use alignedMalloc or os_malloc */
         void *ptr = nullptr;
         if (atype == ALIGNED_MALLOC)
@@ -769,7 +931,7 @@ namespace embree
           if (bytesAllocate == (2*PAGE_SIZE_2M))
           {
             const size_t alignment = maxAlignment;
-            if (device) device->memoryMonitor(bytesAllocate+alignment,false);
+            if (device) device->memoryMonitor(bytesAllocate+alignment,false,RTC_MEMORY_CATEGORY_ACCEL_UNUSED);
             ptr = alignedMalloc(bytesAllocate,alignment);
 
             /* give hint to transparently convert these pages to 2MB pages */
@@ -783,14 +945,14 @@ namespace embree
           else
           {
             const size_t alignment = maxAlignment;
-            if (device) device->memoryMonitor(bytesAllocate+alignment,false);
+            if (device) device->memoryMonitor(bytesAllocate+alignment,false,RTC_MEMORY_CATEGORY_ACCEL_UNUSED);
             ptr = alignedMalloc(bytesAllocate,alignment);
             return new (ptr) Block(ALIGNED_MALLOC,bytesAllocate-sizeof_Header,bytesAllocate-sizeof_Header,next,alignment);
           }
         }
         else if (atype == EMBREE_OS_MALLOC)
         {
-          if (device) device->memoryMonitor(bytesAllocate,false);
+          if (device) device->memoryMonitor(bytesAllocate,false,RTC_MEMORY_CATEGORY_ACCEL_UNUSED);
           bool huge_pages; ptr = os_malloc(bytesReserve,huge_pages);
           return new (ptr) Block(EMBREE_OS_MALLOC,bytesAllocate-sizeof_Header,bytesReserve-sizeof_Header,next,0,huge_pages);
         }
@@ -816,30 +978,33 @@ namespace embree
         return head;
       }
 
-      void clear_list(MemoryMonitorInterface* device)
+      void clear_list(MemoryMonitorInterface* device, BlockPool* pool)
       {
         Block* block = this;
         while (block) {
           Block* next = block->next;
-          block->clear_block(device);
+          block->clear_block(device,pool);
           block = next;
         }
       }
 
-      void clear_block (MemoryMonitorInterface* device)
+      void clear_block (MemoryMonitorInterface* device, BlockPool* pool)
       {
         const size_t sizeof_Header = offsetof(Block,data[0]);
         const ssize_t sizeof_Alloced = wasted+sizeof_Header+getBlockAllocatedBytes();
 
         if (atype == ALIGNED_MALLOC) {
-          alignedFree(this);
-          if (device) device->memoryMonitor(-sizeof_Alloced,true);
+          size_t sizeof_This = sizeof_Header+reserveEnd;
+          if (!pool || !pool->release(this,sizeof_This,false,false))
+            alignedFree(this);
+          if (device) device->memoryMonitor(-sizeof_Alloced,true,RTC_MEMORY_CATEGORY_ACCEL_UNUSED);
         }
 
         else if (atype == EMBREE_OS_MALLOC) {
          size_t sizeof_This = sizeof_Header+reserveEnd;
-         os_free(this,sizeof_This,huge_pages);
-         if (device) device->memoryMonitor(-sizeof_Alloced,true);
+         if (!pool || !pool->release(this,sizeof_This,true,huge_pages))
+           os_free(this,sizeof_This,huge_pages);
+         if (device) device->memoryMonitor(-sizeof_Alloced,true,RTC_MEMORY_CATEGORY_ACCEL_UNUSED);
         }
 
         else /* if (atype == SHARED) */ {
@@ -858,7 +1023,7 @@ namespace embree
         bytes_in = bytes = min(bytes,reserveEnd-i);
         
 	if (i+bytes > allocEnd) {
-          if (device) device->memoryMonitor(i+bytes-max(i,allocEnd),true);
+          if (device) device->memoryMonitor(i+bytes-max(i,allocEnd),true,RTC_MEMORY_CATEGORY_ACCEL_UNUSED);
         }
 	return &data[i];
       }
@@ -969,6 +1134,7 @@ namespace embree
 
   private:
     Device* device;
+    MemoryStatistics* statistics;      //!< memory statistics of the scene
     SpinLock mutex;
     size_t slotMask;
     std::atomic<Block*> threadUsedBlocks[MAX_THREAD_USED_BLOCK_SLOTS];
@@ -989,8 +1155,11 @@ namespace embree
     size_t maxGrowSize;
     std::atomic<size_t> log2_grow_size_scale; //!< log2 of scaling factor for grow size // FIXME: remove
     std::atomic<size_t> bytesUsed;
+    std::atomic<size_t> bytesUsedLeaves;
     std::atomic<size_t> bytesFree;
     std::atomic<size_t> bytesWasted;
+    size_t bytesReportedNodes;  //!< bytes of nodes recorded in the memory statistics
+    size_t bytesReportedLeaves; //!< bytes of leaves recorded in the memory statistics
     static __thread ThreadLocal2* thread_local_allocator2;
     static SpinLock s_thread_local_allocators_lock;
     static std::vector<std::unique_ptr<ThreadLocal2>> s_thread_local_allocators;
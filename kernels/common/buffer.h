@@ -14,11 +14,11 @@ namespace embree
   public:
     /*! Buffer construction */
     Buffer() 
-      : device(nullptr), ptr(nullptr), numBytes(0), shared(false) {}
+      : device(nullptr), ptr(nullptr), numBytes(0), shared(false), mapping(nullptr), mappingBytes(0) {}
 
     /*! Buffer construction */
     Buffer(Device* device, size_t numBytes_in, void* ptr_in = nullptr)
-      : device(device), numBytes(numBytes_in)
+      : device(device), numBytes(numBytes_in), mapping(nullptr), mappingBytes(0)
     {
       device->refInc();
       
@@ -34,6 +34,18 @@ namespace embree
       }
     }
     
+    /*! Buffer construction from a byte range of a file that gets mapped read-only */
+    Buffer(Device* device, const char* fileName, size_t offset, size_t numBytes_in)
+      : device(device), numBytes(numBytes_in), shared(true), mapping(nullptr), mappingBytes(0)
+    {
+      try {
+        ptr = (char*) os_map_file(fileName,offset,numBytes,mapping,mappingBytes);
+      } catch (std::runtime_error& e) {
+        throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, e.what());
+      }
+      device->refInc();
+    }
+
     /*! Buffer destruction */
     ~Buffer() {
       free();
@@ -78,7 +90,7 @@ namespace embree
     void alloc()
     {
       if (device)
-        device->memoryMonitor(this->bytes(), false);
+        device->memoryMonitor(this->bytes(), false, RTC_MEMORY_CATEGORY_GEOMETRY_BUFFERS);
       size_t b = (this->bytes()+15) & ssize_t(-16);
       ptr = (char*)alignedMalloc(b,16);
     }
@@ -86,10 +98,15 @@ namespace embree
     /*! frees the buffer */
     void free()
     {
+      if (mapping) {
+        os_unmap_file(mapping,mappingBytes);
+        mapping = nullptr;
+        ptr = nullptr;
+      }
       if (shared) return;
       alignedFree(ptr); 
       if (device)
-        device->memoryMonitor(-ssize_t(this->bytes()), true);
+        device->memoryMonitor(-ssize_t(this->bytes()), true, RTC_MEMORY_CATEGORY_GEOMETRY_BUFFERS);
       ptr = nullptr;
     }
     
@@ -119,11 +136,18 @@ namespace embree
       return ptr; 
     }
 
+    /*! starts reading the pages of a range of a file mapped buffer */
+    __forceinline void prefetch(const char* p, size_t bytes) const {
+      if (mapping && bytes) os_prefetch((void*)p,bytes);
+    }
+
   public:
     Device* device;  //!< device to report memory usage to
     char* ptr;       //!< pointer to buffer data
     size_t numBytes; //!< number of bytes in the buffer
     bool shared;     //!< set if memory is shared with application
+    void* mapping;   //!< start of file mapping if buffer is mapped from a file
+    size_t mappingBytes; //!< number of bytes of the file mapping
   };
 
   /*! An untyped contiguous range of a buffer. This class does not own the buffer content. */
@@ -172,6 +196,12 @@ namespace embree
       return num*stride; 
     }
     
+    /*! starts reading the pages of a range of elements if the buffer is mapped from a file */
+    __forceinline void prefetch(const range<size_t>& r) const
+    {
+      if (buffer) buffer->prefetch(ptr_ofs + r.begin()*stride, r.size()*stride);
+    }
+
     /*! returns the buffer stride */
     __forceinline unsigned getStride() const
     {
@@ -0,0 +1,172 @@
+// Copyright 2009-2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "closest_point.h"
+#include "scene.h"
+#include "context.h"
+#include "../../common/algorithms/parallel_for.h"
+#include "../../common/algorithms/parallel_reduce.h"
+#include "../../common/algorithms/parallel_sort.h"
+
+namespace embree
+{
+  /*! state of a single query of the batch, the world space query has to
+   *  be the first member as the callback gets passed a pointer to it */
+  struct ClosestPointQuery
+  {
+    RTCPointQuery query;
+    RTCClosestPointHit* hit;
+    Scene* scene;
+  };
+
+  /*! query point sorted by its Morton code */
+  struct MortonQuery
+  {
+    __forceinline MortonQuery () {}
+
+    __forceinline MortonQuery (unsigned int code, unsigned int index)
+      : code(code), index(index) {}
+
+    __forceinline operator unsigned() const { return code; }
+
+  public:
+    unsigned int code;
+    unsigned int index;
+  };
+
+  template<typename Mesh>
+    __forceinline Vec3fa getVertex(const Mesh* mesh, unsigned int v, int itime, float ftime)
+  {
+    if (mesh->numTimeSteps == 1) return mesh->vertex(v);
+    return lerp(mesh->vertex(v,itime+0),mesh->vertex(v,itime+1),ftime);
+  }
+
+  static bool closestPointFunc(RTCPointQueryFunctionArguments* args)
+  {
+    ClosestPointQuery* state = (ClosestPointQuery*) args->query;
+    RTCPointQueryContext* context = args->context;
+    const Vec3fa q(state->query.x,state->query.y,state->query.z);
+
+    /* lookup the scene the primitive lives in through the instance stack */
+    Scene* scene = state->scene;
+    for (unsigned int l=0; l<context->instStackSize; l++)
+      scene = (Scene*) ((Instance*)scene->get(context->instID[l]))->object;
+
+    Geometry* geom = scene->get(args->geomID);
+    float ftime = 0.0f;
+    const int itime = geom->timeSegment(state->query.time,ftime);
+
+    Vec3fa v[4];
+    size_t numTriangles = 0;
+    if (geom->getType() == Geometry::GTY_TRIANGLE_MESH)
+    {
+      const TriangleMesh* mesh = (const TriangleMesh*) geom;
+      const TriangleMesh::Triangle& tri = mesh->triangle(args->primID);
+      for (size_t i=0; i<3; i++) v[i] = getVertex(mesh,tri.v[i],itime,ftime);
+      numTriangles = 1;
+    }
+    else if (geom->getType() == Geometry::GTY_QUAD_MESH)
+    {
+      const QuadMesh* mesh = (const QuadMesh*) geom;
+      const QuadMesh::Quad& quad = mesh->quad(args->primID);
+      for (size_t i=0; i<4; i++) v[i] = getVertex(mesh,quad.v[i],itime,ftime);
+      numTriangles = 2;
+    }
+    else
+      return false;
+
+    /* transform vertices into world space */
+    if (context->instStackSize > 0)
+    {
+      const AffineSpace3fa inst2world = AffineSpace3fa_load_unaligned((AffineSpace3fa*)context->inst2world[context->instStackSize-1]);
+      for (size_t i=0; i<3+numTriangles-1; i++) v[i] = xfmPoint(inst2world,v[i]);
+    }
+
+    /* quads are split into the triangles (v0,v1,v3) and (v2,v3,v1) */
+    Vec3fa p = closestPointOnTriangle(q,v[0],v[1],v[numTriangles == 1 ? 2 : 3]);
+    float d = distance(q,p);
+    if (numTriangles == 2)
+    {
+      const Vec3fa p1 = closestPointOnTriangle(q,v[2],v[3],v[1]);
+      const float d1 = distance(q,p1);
+      if (d1 < d) { p = p1; d = d1; }
+    }
+
+    if (d >= state->query.radius)
+      return false;
+
+    RTCClosestPointHit* hit = state->hit;
+    hit->p_x = p.x;
+    hit->p_y = p.y;
+    hit->p_z = p.z;
+    hit->distance = d;
+    hit->primID = args->primID;
+    hit->geomID = args->geomID;
+    for (unsigned int l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+      hit->instID[l] = context->instID[l];
+    state->query.radius = d;
+    return true;
+  }
+
+  void closestPointBatch(Scene* scene, const RTCPointQuery* queries, RTCClosestPointHit* hits, size_t N)
+  {
+    /* sort the queries along a Morton curve to make neighbouring queries traverse similar parts of the BVH */
+    const BBox3fa bounds = parallel_reduce(size_t(0), N, size_t(4096), BBox3fa(empty), [&](const range<size_t>& r) -> BBox3fa {
+        BBox3fa b(empty);
+        for (size_t i=r.begin(); i<r.end(); i++) {
+          const Vec3fa q(queries[i].x,queries[i].y,queries[i].z);
+          if (isvalid(q)) b.extend(q);
+        }
+        return b;
+      }, [] (const BBox3fa& a, const BBox3fa& b) { return merge(a,b); });
+
+    const Vec3fa base  = bounds.lower;
+    const Vec3fa diag  = max(bounds.upper-bounds.lower,Vec3fa(1E-19f));
+    const Vec3fa scale = Vec3fa(1023.99f)/diag;
+
+    std::vector<MortonQuery> order0(N), order1(N);
+    parallel_for(size_t(0), N, size_t(4096), [&](const range<size_t>& r) {
+        for (size_t i=r.begin(); i<r.end(); i++)
+        {
+          /* queries with non-finite coordinates go to the end of the order */
+          const Vec3fa q(queries[i].x,queries[i].y,queries[i].z);
+          if (unlikely(!isvalid(q))) {
+            order0[i] = MortonQuery(0xFFFFFFFF,unsigned(i));
+            continue;
+          }
+          const Vec3fa p = (q-base)*scale;
+          const unsigned int x = (unsigned int) clamp(int(p.x),0,1023);
+          const unsigned int y = (unsigned int) clamp(int(p.y),0,1023);
+          const unsigned int z = (unsigned int) clamp(int(p.z),0,1023);
+          order0[i] = MortonQuery(bitInterleave(x,y,z),unsigned(i));
+        }
+      });
+    radix_sort_u32(order0.data(),order1.data(),N);
+
+    /* consecutive queries of the sorted order are processed by the same thread */
+    parallel_for(size_t(0), N, size_t(256), [&](const range<size_t>& r) {
+        RTCPointQueryContext userContext;
+        for (size_t j=r.begin(); j<r.end(); j++)
+        {
+          const unsigned int i = order0[j].index;
+          RTCClosestPointHit& hit = hits[i];
+          hit.p_x = hit.p_y = hit.p_z = 0.0f;
+          hit.distance = inf;
+          hit.primID = RTC_INVALID_GEOMETRY_ID;
+          hit.geomID = RTC_INVALID_GEOMETRY_ID;
+          for (unsigned int l=0; l<RTC_MAX_INSTANCE_LEVEL_COUNT; l++)
+            hit.instID[l] = RTC_INVALID_GEOMETRY_ID;
+
+          ClosestPointQuery state;
+          state.query = queries[i];
+          state.hit = &hit;
+          state.scene = scene;
+
+          rtcInitPointQueryContext(&userContext);
+          PointQueryContext context(scene, (PointQuery*)&state.query,
+            POINT_QUERY_TYPE_SPHERE, closestPointFunc, &userContext, 1.f, nullptr);
+          scene->intersectors.pointQuery((PointQuery*)&state.query, &context);
+        }
+      });
+  }
+}
@@ -0,0 +1,62 @@
+// Copyright 2009-2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "default.h"
+
+namespace embree
+{
+  class Scene;
+
+  /*! calculates the point of the triangle (a,b,c) closest to p */
+  __forceinline Vec3fa closestPointOnTriangle(const Vec3fa& p, const Vec3fa& a, const Vec3fa& b, const Vec3fa& c)
+  {
+    const Vec3fa ab = b - a;
+    const Vec3fa ac = c - a;
+    const Vec3fa ap = p - a;
+
+    const float d1 = dot(ab, ap);
+    const float d2 = dot(ac, ap);
+    if (d1 <= 0.f && d2 <= 0.f) return a;
+
+    const Vec3fa bp = p - b;
+    const float d3 = dot(ab, bp);
+    const float d4 = dot(ac, bp);
+    if (d3 >= 0.f && d4 <= d3) return b;
+
+    const Vec3fa cp = p - c;
+    const float d5 = dot(ab, cp);
+    const float d6 = dot(ac, cp);
+    if (d6 >= 0.f && d5 <= d6) return c;
+
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f)
+    {
+      const float v = d1 / (d1 - d3);
+      return a + v * ab;
+    }
+
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f)
+    {
+      const float v = d2 / (d2 - d6);
+      return a + v * ac;
+    }
+
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f)
+    {
+      const float v = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+      return b + v * (c - b);
+    }
+
+    const float denom = 1.f / (va + vb + vc);
+    const float v = vb * denom;
+    const float w = vc * denom;
+    return a + v * ab + w * ac;
+  }
+
+  /*! finds the closest points on the triangle and quad meshes of the scene for an array of query points */
+  void closestPointBatch(Scene* scene, const RTCPointQuery* queries, RTCClosestPointHit* hits, size_t N);
+}
@@ -28,6 +28,10 @@ namespace embree
     __forceinline bool isIncoherent() const {
       return embree::isIncoherent(user->flags);
     }
+
+    __forceinline bool hasRayCones() const {
+      return embree::hasRayCones(user->flags);
+    }
     
   public:
     Scene* scene;
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "device.h"
+#include "alloc.h"
 #include "../hash.h"
 #include "scene_triangle_mesh.h"
 #include "scene_user_geometry.h"
@@ -33,7 +34,6 @@ namespace embree
   DECLARE_SYMBOL2(RayStreamFilterFuncs,rayStreamFilterFuncs);
 
   static MutexSys g_mutex;
-  static std::map<Device*,size_t> g_cache_size_map;
   static std::map<Device*,size_t> g_num_threads_map;
 
   Device::Device (const char* cfg)
@@ -60,9 +60,15 @@ namespace embree
 #endif
     State::hugepages_success &= os_init(State::hugepages,State::verbosity(3));
     
-    /*! set tessellation cache size */
+    /*! create tessellation cache */
+#if defined(EMBREE_GEOMETRY_SUBDIVISION)
+    tessellationCache = make_unique(new SharedLazyTessellationCache);
+#endif
     setCacheSize( State::tessellation_cache_size );
 
+    /*! create block pool */
+    blockPool = make_unique(new BlockPool(State::block_pool_max_size,&memoryStatistics));
+
     /*! enable some floating point exceptions to catch bugs */
     if (State::float_exceptions)
     {
@@ -102,7 +108,10 @@ namespace embree
 
   Device::~Device ()
   {
-    setCacheSize(0);
+#if defined(EMBREE_GEOMETRY_SUBDIVISION)
+    if (State::verbosity(2))
+      tessellationCache->printStatistics();
+#endif
     exitTaskingSystem();
   }
 
@@ -276,8 +285,10 @@ namespace embree
     device->setDeviceErrorCode(error);
   }
 
-  void Device::memoryMonitor(ssize_t bytes, bool post)
+  void Device::memoryMonitor(ssize_t bytes, bool post, RTCMemoryCategory category)
   {
+    /* memory reported before an allocation is only recorded if the allocation is not cancelled */
+    if (post) memoryStatistics.add(category,bytes);
     if (State::memory_monitor_function && bytes != 0) {
       if (!State::memory_monitor_function(State::memory_monitor_userptr,bytes,post)) {
         if (bytes > 0) { // only throw exception when we allocate memory to never throw inside a destructor
@@ -285,6 +296,7 @@ namespace embree
         }
       }
     }
+    if (!post) memoryStatistics.add(category,bytes);
   }
 
   size_t getMaxNumThreads()
@@ -297,23 +309,12 @@ namespace embree
     return maxNumThreads;
   }
 
-  size_t getMaxCacheSize()
-  {
-    size_t maxCacheSize = 0;
-    for (std::map<Device*,size_t>::iterator i=g_cache_size_map.begin(); i!= g_cache_size_map.end(); i++)
-      maxCacheSize = max(maxCacheSize, (*i).second);
-    return maxCacheSize;
-  }
- 
   void Device::setCacheSize(size_t bytes) 
   {
 #if defined(EMBREE_GEOMETRY_SUBDIVISION)
-    Lock<MutexSys> lock(g_mutex);
-    if (bytes == 0) g_cache_size_map.erase(this);
-    else            g_cache_size_map[this] = bytes;
-    
-    size_t maxCacheSize = getMaxCacheSize();
-    resizeTessellationCache(maxCacheSize);
+    const size_t oldBytes = tessellationCache->getSize();
+    tessellationCache->resize(bytes);
+    memoryStatistics.add(RTC_MEMORY_CATEGORY_TESSELLATION_CACHE,ssize_t(tessellationCache->getSize())-ssize_t(oldBytes));
 #endif
   }
 
@@ -365,6 +366,18 @@ namespace embree
     case 1000003: debug_int3 = val; return;
     }
 
+    /* documented properties */
+    switch (prop)
+    {
+    case RTC_DEVICE_PROPERTY_BLOCK_POOL_MAX_SIZE:
+      if (val < 0) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid block pool size");
+      blockPool->trim(val);
+      return;
+
+    default:
+      break;
+    }
+
     throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "unknown writable property");
   }
 
@@ -396,6 +409,9 @@ namespace embree
     case RTC_DEVICE_PROPERTY_VERSION_PATCH: return RTC_VERSION_PATCH;
     case RTC_DEVICE_PROPERTY_VERSION      : return RTC_VERSION;
 
+    case RTC_DEVICE_PROPERTY_BLOCK_POOL_SIZE    : return blockPool->size();
+    case RTC_DEVICE_PROPERTY_BLOCK_POOL_MAX_SIZE: return blockPool->maxSize();
+
 #if defined(EMBREE_TARGET_SIMD4) && defined(EMBREE_RAY_PACKETS)
     case RTC_DEVICE_PROPERTY_NATIVE_RAY4_SUPPORTED:  return hasISA(SSE2);
 #else
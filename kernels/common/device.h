@@ -11,6 +11,8 @@ namespace embree
 {
   class BVH4Factory;
   class BVH8Factory;
+  class SharedLazyTessellationCache;
+  class BlockPool;
 
   class Device : public State, public MemoryMonitorInterface
   {
@@ -42,10 +44,10 @@ namespace embree
     /*! processes error codes, do not call directly */
     static void process_error(Device* device, RTCError error, const char* str);
 
-    /*! invokes the memory monitor callback */
-    void memoryMonitor(ssize_t bytes, bool post);
+    /*! invokes the memory monitor callback and records the bytes in the memory statistics */
+    void memoryMonitor(ssize_t bytes, bool post, RTCMemoryCategory category);
 
-    /*! sets the size of the software cache. */
+    /*! sets the size of the tessellation cache of this device */
     void setCacheSize(size_t bytes);
 
     /*! sets a property */
@@ -81,5 +83,16 @@ namespace embree
     
     /* ray streams filter */
     RayStreamFilterFuncs rayStreamFilters;
+
+    /* memory usage of this device per category */
+    MemoryStatistics memoryStatistics;
+
+    /* pool of memory blocks freed by the builders of this device */
+    std::unique_ptr<BlockPool> blockPool;
+
+#if defined(EMBREE_GEOMETRY_SUBDIVISION)
+    /* tessellation cache of this device */
+    std::unique_ptr<SharedLazyTessellationCache> tessellationCache;
+#endif
   };
 }
@@ -3,6 +3,7 @@
 
 #include "geometry.h"
 #include "scene.h"
+#include "../../common/algorithms/parallel_for.h"
 
 namespace embree
 {
@@ -155,6 +156,19 @@ namespace embree
   }
 
   void Geometry::interpolateN(const RTCInterpolateNArguments* const args)
+  {
+    if (args->valueCount > 256) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"maximally 256 floating point values can be interpolated per vertex");
+    interpolateRange(args,range<size_t>(0,args->N));
+  }
+
+  void Geometry::interpolateBatch(const RTCInterpolateNArguments* const args)
+  {
+    parallel_for(size_t(0),size_t(args->N),size_t(4096),[&](const range<size_t>& r) {
+        interpolateRange(args,r);
+      });
+  }
+
+  void Geometry::interpolateRange(const RTCInterpolateNArguments* const args, const range<size_t>& r)
   {
     const void* valid_i = args->valid;
     const unsigned* primIDs = args->primIDs;
@@ -170,8 +184,7 @@ namespace embree
     float* ddPdvdv = args->ddPdvdv;
     float* ddPdudv = args->ddPdudv;
     unsigned int valueCount = args->valueCount;
-
-    if (valueCount > 256) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"maximally 256 floating point values can be interpolated per vertex");
+    assert(valueCount <= 256);
     const int* valid = (const int*) valid_i;
  
     __aligned(64) float P_tmp[256];
@@ -187,7 +200,7 @@ namespace embree
     float* ddPdudut = nullptr, *ddPdvdvt = nullptr, *ddPdudvt = nullptr;
     if (ddPdudu) { ddPdudut = ddPdudu_tmp; ddPdvdvt = ddPdvdv_tmp; ddPdudvt = ddPdudv_tmp; }
     
-    for (unsigned int i=0; i<N; i++)
+    for (size_t i=r.begin(); i<r.end(); i++)
     {
       if (valid && !valid[i]) continue;
 
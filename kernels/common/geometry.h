@@ -165,6 +165,7 @@ namespace embree
       GTY_SUBTYPE_FLAT_CURVE = 0,
       GTY_SUBTYPE_ROUND_CURVE = 1,
       GTY_SUBTYPE_ORIENTED_CURVE = 2,
+      GTY_SUBTYPE_TESSELLATED_CURVE = 3, // only used to tag leaves of pre-tessellated round curves
       GTY_SUBTYPE_MASK = 3,
     };
 
@@ -351,6 +352,16 @@ namespace embree
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
 
+    /*! sets the ray cone used to calculate view dependent tessellation levels */
+    virtual void setTessellationCone(const Vec3fa& org, float width, float spread) {
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
+
+    /*! sets the lattice used to decode 16 bit quantized vertices */
+    virtual void setVertexQuantization(const RTCVertexQuantization* quantization) {
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
+
     /*! Set user data pointer. */
     virtual void setUserData(void* ptr);
       
@@ -367,6 +378,15 @@ namespace embree
     /*! interpolates user data to the specified u/v locations */
     virtual void interpolateN(const RTCInterpolateNArguments* const args);
 
+    /*! interpolates user data to a large batch of u/v locations in parallel */
+    virtual void interpolateBatch(const RTCInterpolateNArguments* const args);
+
+  protected:
+    /*! interpolates user data to the u/v locations of the specified range one by one */
+    void interpolateRange(const RTCInterpolateNArguments* const args, const range<size_t>& r);
+
+  public:
+
     /* point query api */
     bool pointQuery(PointQuery* query, PointQueryContext* context);
 
@@ -480,6 +500,16 @@ namespace embree
     virtual void setOccludedFunctionN (RTCOccludedFunctionN occluded) { 
       throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
     }
+
+    /*! Set intersect function for a batch of primitives. */
+    virtual void setIntersectFunctionBatch (RTCIntersectFunctionBatch intersect) { 
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
+    
+    /*! Set occlusion function for a batch of primitives. */
+    virtual void setOccludedFunctionBatch (RTCOccludedFunctionBatch occluded) { 
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"operation not supported for this geometry"); 
+    }
     
     /*! Set point query function. */
     void setPointQueryFunction(RTCPointQueryFunction func);
@@ -7,6 +7,7 @@
 #include "device.h"
 #include "scene.h"
 #include "context.h"
+#include "closest_point.h"
 #include "../../include/embree3/rtcore_ray.h"
 
 #if defined(__aarch64__) && defined(BUILD_IOS)
@@ -101,6 +102,20 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END(device);
   }
 
+  RTC_API void rtcGetDeviceMemoryUsage(RTCDevice hdevice, RTCMemoryCategory category, RTCMemoryUsage* usage)
+  {
+    Device* device = (Device*) hdevice;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcGetDeviceMemoryUsage);
+    RTC_VERIFY_HANDLE(hdevice);
+    RTC_VERIFY_HANDLE(usage);
+    if ((size_t)category > RTC_MEMORY_CATEGORY_BLOCK_POOL)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid memory category");
+    usage->bytes = device->memoryStatistics.get(category);
+    usage->peakBytes = device->memoryStatistics.getPeak(category);
+    RTC_CATCH_END(device);
+  }
+
   RTC_API RTCError rtcGetDeviceError(RTCDevice hdevice)
   {
     Device* device = (Device*) hdevice;
@@ -153,6 +168,19 @@ RTC_NAMESPACE_BEGIN;
     return nullptr;
   }
 
+  RTC_API RTCBuffer rtcNewBufferFromFile(RTCDevice hdevice, const char* fileName, size_t offset, size_t byteSize)
+  {
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcNewBufferFromFile);
+    RTC_VERIFY_HANDLE(hdevice);
+    if (fileName == nullptr)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid file name specified");
+    Buffer* buffer = new Buffer((Device*)hdevice, fileName, offset, byteSize);
+    return (RTCBuffer)buffer->refInc();
+    RTC_CATCH_END((Device*)hdevice);
+    return nullptr;
+  }
+
   RTC_API void* rtcGetBufferData(RTCBuffer hbuffer)
   {
     Buffer* buffer = (Buffer*)hbuffer;
@@ -295,6 +323,20 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(scene);
   }
 
+  RTC_API void rtcGetSceneMemoryUsage(RTCScene hscene, RTCMemoryCategory category, RTCMemoryUsage* usage)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcGetSceneMemoryUsage);
+    RTC_VERIFY_HANDLE(hscene);
+    RTC_VERIFY_HANDLE(usage);
+    if ((size_t)category > RTC_MEMORY_CATEGORY_BLOCK_POOL)
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid memory category");
+    usage->bytes = scene->memoryStatistics.get(category);
+    usage->peakBytes = scene->memoryStatistics.getPeak(category);
+    RTC_CATCH_END2(scene);
+  }
+
   RTC_API void rtcGetSceneLinearBounds(RTCScene hscene, RTCLinearBounds* bounds_o)
   {
     Scene* scene = (Scene*) hscene;
@@ -339,8 +381,15 @@ RTC_NAMESPACE_BEGIN;
     if (scene0->device != scene1->device) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scenes are from different devices");
     auto nUserPrims0 = scene0->getNumPrimitives (Geometry::MTY_USER_GEOMETRY, false);
     auto nUserPrims1 = scene1->getNumPrimitives (Geometry::MTY_USER_GEOMETRY, false);
-    if (scene0->numPrimitives() != nUserPrims0 && scene1->numPrimitives() != nUserPrims1) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scenes must only contain user geometries with a single timestep");
+    auto nTriangles0 = scene0->getNumPrimitives (Geometry::MTY_TRIANGLE_MESH, false);
+    auto nTriangles1 = scene1->getNumPrimitives (Geometry::MTY_TRIANGLE_MESH, false);
+    if ((scene0->numPrimitives() != nUserPrims0 && scene0->numPrimitives() != nTriangles0) ||
+        (scene1->numPrimitives() != nUserPrims1 && scene1->numPrimitives() != nTriangles1))
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scenes must only contain user geometries or triangle meshes with a single timestep");
 #endif
+    if (scene0->numPrimitives() == 0 || scene1->numPrimitives() == 0) return;
+    if (!scene0->intersectors.collider.collide || scene0->intersectors.collider.collide != scene1->intersectors.collider.collide)
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scenes cannot be collided with each other");
     scene0->intersectors.collide(scene0,scene1,callback,userPtr);
     RTC_CATCH_END(scene0->device);
   }
@@ -392,6 +441,19 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2_FALSE(scene);
   }
   
+  RTC_API void rtcClosestPointBatch(RTCScene hscene, const RTCPointQuery* queries, RTCClosestPointHit* hits, size_t N)
+  {
+    Scene* scene = (Scene*) hscene;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcClosestPointBatch);
+    RTC_VERIFY_HANDLE(hscene);
+    if (scene->isModified()) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"scene got not committed");
+    if (N && (!queries || !hits)) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid query or hit array");
+    if (((size_t)queries) & 0x0F) throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "queries not aligned to 16 bytes");
+    closestPointBatch(scene,queries,hits,N);
+    RTC_CATCH_END2(scene);
+  }
+  
   RTC_API bool rtcPointQuery4 (const int* valid, RTCScene hscene, RTCPointQuery4* query, struct RTCPointQueryContext* userContext, RTCPointQueryFunction queryFunc, void** userPtrN)
   {
     Scene* scene = (Scene*) hscene;
@@ -1523,6 +1585,26 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcSetGeometryTessellationCone (RTCGeometry hgeometry, float org_x, float org_y, float org_z, float width, float spread)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryTessellationCone);
+    RTC_VERIFY_HANDLE(hgeometry);
+    geometry->setTessellationCone(Vec3fa(org_x,org_y,org_z),width,spread);
+    RTC_CATCH_END2(geometry);
+  }
+
+  RTC_API void rtcSetGeometryVertexQuantization (RTCGeometry hgeometry, const RTCVertexQuantization* quantization)
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryVertexQuantization);
+    RTC_VERIFY_HANDLE(hgeometry);
+    geometry->setVertexQuantization(quantization);
+    RTC_CATCH_END2(geometry);
+  }
+
   RTC_API void rtcSetGeometryUserData (RTCGeometry hgeometry, void* ptr) 
   {
     Geometry* geometry = (Geometry*) hgeometry;
@@ -1644,6 +1726,26 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcSetGeometryIntersectFunctionBatch (RTCGeometry hgeometry, RTCIntersectFunctionBatch intersect) 
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryIntersectFunctionBatch);
+    RTC_VERIFY_HANDLE(hgeometry);
+    geometry->setIntersectFunctionBatch(intersect);
+    RTC_CATCH_END2(geometry);
+  }
+
+  RTC_API void rtcSetGeometryOccludedFunctionBatch (RTCGeometry hgeometry, RTCOccludedFunctionBatch occluded) 
+  {
+    Geometry* geometry = (Geometry*) hgeometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcSetGeometryOccludedFunctionBatch);
+    RTC_VERIFY_HANDLE(hgeometry);
+    geometry->setOccludedFunctionBatch(occluded);
+    RTC_CATCH_END2(geometry);
+  }
+
   RTC_API void rtcSetGeometryIntersectFilterFunction (RTCGeometry hgeometry, RTCFilterFunctionN filter) 
   {
     Geometry* geometry = (Geometry*) hgeometry;
@@ -1688,6 +1790,17 @@ RTC_NAMESPACE_BEGIN;
     RTC_CATCH_END2(geometry);
   }
 
+  RTC_API void rtcInterpolateBatch(const RTCInterpolateNArguments* const args)
+  {
+    Geometry* geometry = (Geometry*) args->geometry;
+    RTC_CATCH_BEGIN;
+    RTC_TRACE(rtcInterpolateBatch);
+    RTC_VERIFY_HANDLE(args->geometry);
+    if (args->valueCount > 256) throw_RTCError(RTC_ERROR_INVALID_OPERATION,"maximally 256 floating point values can be interpolated per vertex");
+    geometry->interpolateBatch(args);
+    RTC_CATCH_END2(geometry);
+  }
+
   RTC_API void rtcCommitGeometry (RTCGeometry hgeometry)
   {
     Geometry* geometry = (Geometry*) hgeometry;
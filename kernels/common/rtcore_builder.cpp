@@ -24,7 +24,12 @@ namespace embree
         device->refInc();
       }
 
-      ~BVH() {
+      ~BVH()
+      {
+        /* free the BVH memory while the device and its block pool are still alive */
+        allocator.clear();
+        morton_src.clear();
+        morton_tmp.clear();
         device->refDec();
       }
 
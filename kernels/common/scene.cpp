@@ -55,6 +55,8 @@ namespace embree
 #elif defined(TASKING_GCD)
       // Not Needed
 #endif
+    /* free the acceleration structures while the device and its block pool are still alive */
+    accels_init();
     device->refDec();
   }
 
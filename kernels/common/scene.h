@@ -283,6 +283,7 @@ namespace embree
     
   public:
     Device* device;
+    MemoryStatistics memoryStatistics; //!< memory usage of the acceleration structures of the scene
 
     /* these are to detect if we need to recreate the acceleration structures */
     bool flags_modified;
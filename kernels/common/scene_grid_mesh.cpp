@@ -9,9 +9,11 @@ namespace embree
 #if defined(EMBREE_LOWEST_ISA)
 
   GridMesh::GridMesh (Device* device)
-    : Geometry(device,GTY_GRID_MESH,0,1)
+    : Geometry(device,GTY_GRID_MESH,0,1),
+      quantized(false), quantOrigin(zero), quantScale(one)
   {
     vertices.resize(numTimeSteps);
+    quantOffset[0] = quantOffset[1] = quantOffset[2] = 0;
   }
 
   void GridMesh::setMask (unsigned mask) 
@@ -34,13 +36,15 @@ namespace embree
   
   void GridMesh::setBuffer(RTCBufferType type, unsigned int slot, RTCFormat format, const Ref<Buffer>& buffer, size_t offset, size_t stride, unsigned int num)
   {
-    /* verify that all accesses are 4 bytes aligned */
-    if (((size_t(buffer->getPtr()) + offset) & 0x3) || (stride & 0x3)) 
-      throw_RTCError(RTC_ERROR_INVALID_OPERATION, "data must be 4 bytes aligned");
+    /* verify that all accesses are 4 bytes aligned, quantized vertices only have to be 2 bytes aligned */
+    const bool quantizedVertices = type == RTC_BUFFER_TYPE_VERTEX && format == RTC_FORMAT_USHORT3;
+    const size_t alignMask = quantizedVertices ? 0x1 : 0x3;
+    if (((size_t(buffer->getPtr()) + offset) & alignMask) || (stride & alignMask)) 
+      throw_RTCError(RTC_ERROR_INVALID_OPERATION, quantizedVertices ? "data must be 2 bytes aligned" : "data must be 4 bytes aligned");
 
     if (type == RTC_BUFFER_TYPE_VERTEX)
     {
-      if (format != RTC_FORMAT_FLOAT3)
+      if (format != RTC_FORMAT_FLOAT3 && format != RTC_FORMAT_USHORT3)
         throw_RTCError(RTC_ERROR_INVALID_OPERATION, "invalid vertex buffer format");
 
       /* if buffer is larger than 16GB the premultiplied index optimization does not work */
@@ -51,8 +55,9 @@ namespace embree
         throw_RTCError(RTC_ERROR_INVALID_ARGUMENT, "invalid vertex buffer slot");
 
       vertices[slot].set(buffer, offset, stride, num, format);
-      vertices[slot].checkPadding16();
+      if (!quantizedVertices) vertices[slot].checkPadding16();
       vertices0 = vertices[0];
+      quantized = vertices0.getFormat() == RTC_FORMAT_USHORT3;
     }
     else if (type == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE)
     {
@@ -141,9 +146,33 @@ namespace embree
       if (vertices[t].getStride() != vertices[0].getStride())
         throw_RTCError(RTC_ERROR_INVALID_OPERATION,"stride of vertex buffers have to be identical for each time step");
 
+    /* verify that format of all time steps are identical */
+    for (unsigned int t=0; t<numTimeSteps; t++)
+      if (vertices[t].getFormat() != vertices[0].getFormat())
+        throw_RTCError(RTC_ERROR_INVALID_OPERATION,"format of vertex buffers have to be identical for each time step");
+
     Geometry::commit();
   }
   
+  void GridMesh::setVertexQuantization(const RTCVertexQuantization* quantization)
+  {
+    if (quantization)
+    {
+      quantOrigin = Vec3fa(quantization->origin_x,quantization->origin_y,quantization->origin_z);
+      quantScale  = Vec3fa(quantization->scale_x, quantization->scale_y, quantization->scale_z);
+      quantOffset[0] = quantization->offset_x;
+      quantOffset[1] = quantization->offset_y;
+      quantOffset[2] = quantization->offset_z;
+    }
+    else
+    {
+      quantOrigin = Vec3fa(zero);
+      quantScale  = Vec3fa(one);
+      quantOffset[0] = quantOffset[1] = quantOffset[2] = 0;
+    }
+    Geometry::update();
+  }
+
   void GridMesh::addElementsToCount (GeometryCounts & counts) const 
   {
     if (numTimeSteps == 1) counts.numGrids += numPrimitives;
@@ -164,9 +193,9 @@ namespace embree
         return false;
 
     /*! verify vertices */
-    for (const auto& buffer : vertices)
-      for (size_t i=0; i<buffer.size(); i++)
-	if (!isvalid(buffer[i])) 
+    for (size_t t=0; t<vertices.size(); t++)
+      for (size_t i=0; i<vertices[t].size(); i++)
+	if (!isvalid(vertex(i,t))) 
 	  return false;
 
     return true;
@@ -199,6 +228,7 @@ namespace embree
       src    = vertices[bufferSlot].getPtr();
       stride = vertices[bufferSlot].getStride();
     }
+    const bool decode = quantized && bufferType == RTC_BUFFER_TYPE_VERTEX;
 
     const Grid& grid = grids[primID];
     const int grid_width  = grid.resX-1;
@@ -217,10 +247,14 @@ namespace embree
       const unsigned int idx1 = grid.startVtxID + (iv+1)*grid.lineVtxOffset + iu;
       
       const vbool4 valid = vint4((int)i)+vint4(step) < vint4(int(valueCount));
-      const vfloat4 p0 = vfloat4::loadu(valid,(float*)&src[(idx0+0)*stride+ofs]);
-      const vfloat4 p1 = vfloat4::loadu(valid,(float*)&src[(idx0+1)*stride+ofs]);
-      const vfloat4 p2 = vfloat4::loadu(valid,(float*)&src[(idx1+1)*stride+ofs]);
-      const vfloat4 p3 = vfloat4::loadu(valid,(float*)&src[(idx1+0)*stride+ofs]);
+      auto load = [&] (const unsigned int idx) -> vfloat4 {
+        if (unlikely(decode)) return select(valid,vfloat4(decodeVertex(&src[idx*stride])),vfloat4(zero));
+        return vfloat4::loadu(valid,(float*)&src[idx*stride+ofs]);
+      };
+      const vfloat4 p0 = load(idx0+0);
+      const vfloat4 p1 = load(idx0+1);
+      const vfloat4 p2 = load(idx1+1);
+      const vfloat4 p3 = load(idx1+0);
       const vbool4 left = u+v <= 1.0f;
       const vfloat4 Q0 = select(left,p0,p2);
       const vfloat4 Q1 = select(left,p1,p3);
@@ -55,6 +55,7 @@ namespace embree
     void commit();
     bool verify();
     void interpolate(const RTCInterpolateArguments* const args);
+    void setVertexQuantization(const RTCVertexQuantization* quantization);
     void addElementsToCount (GeometryCounts & counts) const;
 
     __forceinline unsigned int getNumSubGrids(const size_t gridID)
@@ -80,8 +81,18 @@ namespace embree
       return grids[i];
     }
 
+    /*! decodes a vertex stored as 16 bit lattice coordinates, vertices
+     *  at the same lattice point always decode to the same position */
+    __forceinline const Vec3fa decodeVertex(const char* ptr) const
+    {
+      const unsigned short* q = (const unsigned short*) ptr;
+      const Vec3fa k(vint4(quantOffset[0]+q[0],quantOffset[1]+q[1],quantOffset[2]+q[2],0));
+      return quantOrigin + quantScale*k;
+    }
+
     /*! returns i'th vertex of the first time step  */
     __forceinline const Vec3fa vertex(size_t i) const { // FIXME: check if this does a unaligned load
+      if (unlikely(quantized)) return decodeVertex(vertices0.getPtr(i));
       return vertices0[i];
     }
 
@@ -92,6 +103,7 @@ namespace embree
 
     /*! returns i'th vertex of itime'th timestep */
     __forceinline const Vec3fa vertex(size_t i, size_t itime) const {
+      if (unlikely(quantized)) return decodeVertex(vertices[itime].getPtr(i));
       return vertices[itime][i];
     }
 
@@ -100,6 +112,18 @@ namespace embree
       return vertices[itime].getPtr(i);
     }
 
+    /*! loads i'th vertex of the first time step with an unaligned load */
+    __forceinline const vfloat4 loadVertex(size_t i) const {
+      if (unlikely(quantized)) return vfloat4(decodeVertex(vertexPtr(i)));
+      return vfloat4::loadu(vertexPtr(i));
+    }
+
+    /*! loads i'th vertex of itime'th timestep with an unaligned load */
+    __forceinline const vfloat4 loadVertex(size_t i, size_t itime) const {
+      if (unlikely(quantized)) return vfloat4(decodeVertex(vertexPtr(i,itime)));
+      return vfloat4::loadu(vertexPtr(i,itime));
+    }
+
     /*! returns i'th vertex of the first timestep */
     __forceinline size_t grid_vertex_index(const Grid& g, size_t x, size_t y) const {
       assert(x < (size_t)g.resX);
@@ -200,6 +224,11 @@ namespace embree
     BufferView<Vec3fa> vertices0;        //!< fast access to first vertex buffer
     vector<BufferView<Vec3fa>> vertices; //!< vertex array for each timestep
     vector<RawBufferView> vertexAttribs; //!< vertex attributes
+
+    bool quantized;       //!< vertices are stored as RTC_FORMAT_USHORT3 lattice coordinates
+    Vec3fa quantOrigin;   //!< origin of the quantization lattice
+    Vec3fa quantScale;    //!< spacing of the quantization lattice
+    int quantOffset[3];   //!< lattice coordinate of the vertex buffer origin
   };
 
   namespace isa
@@ -21,6 +21,9 @@ namespace embree
     : Geometry(device,GTY_SUBDIV_MESH,0,1), 
       displFunc(nullptr),
       tessellationRate(2.0f),
+      tessellationConeOrg(zero),
+      tessellationConeWidth(0.0f),
+      tessellationConeSpread(0.0f),
       numHalfEdges(0),
       faceStartEdge(device,0),
       halfEdgeFace(device,0),
@@ -359,6 +362,33 @@ namespace embree
     levels.setModified();
   }
 
+  void SubdivMesh::setTessellationCone(const Vec3fa& org, float width, float spread)
+  {
+    if (!(width >= 0.0f) || !(spread >= 0.0f))
+      throw_RTCError(RTC_ERROR_INVALID_ARGUMENT,"invalid tessellation cone");
+    
+    tessellationConeOrg = org;
+    tessellationConeWidth = width;
+    tessellationConeSpread = spread;
+    levels.setModified();
+  }
+
+  float SubdivMesh::getConeEdgeLevel(const unsigned int v0, const unsigned int v1) const
+  {
+    if (v0 >= numVertices() || v1 >= numVertices())
+      return 1.0f;
+
+    /* tessellationRate segments per cone footprint at the edge center */
+    const Vec3fa p0 = vertices[0][v0];
+    const Vec3fa p1 = vertices[0][v1];
+    const float dist = length(0.5f*(p0+p1)-tessellationConeOrg);
+    const float footprint = max(tessellationConeWidth+tessellationConeSpread*dist,float(min_rcp_input));
+    const float level = clamp(tessellationRate*length(p1-p0)/footprint,1.0f,4096.0f);
+
+    /* quantize to powers of two, thus small camera movements do not change the tessellation */
+    return clamp(std::exp2(std::ceil(std::log2(level))),1.0f,4096.0f);
+  }
+
   __forceinline uint64_t pair64(unsigned int x, unsigned int y) 
   {
     if (x<y) std::swap(x,y);
@@ -366,7 +396,7 @@ namespace embree
   }
 
   SubdivMesh::Topology::Topology(SubdivMesh* mesh)
-    : mesh(mesh), subdiv_mode(RTC_SUBDIVISION_MODE_SMOOTH_BOUNDARY), halfEdges(mesh->device,0)
+    : mesh(mesh), subdiv_mode(RTC_SUBDIVISION_MODE_SMOOTH_BOUNDARY), halfEdges(mesh->device,0), nonManifold(false)
   {
   }
   
@@ -410,6 +440,7 @@ namespace embree
     /* allocate temporary array */
     halfEdges0.resize(numEdges);
     halfEdges1.resize(numEdges);
+    oppositeHalfEdges.resize(numEdges);
 
     /* create all half edges */
     parallel_for( size_t(0), numFaces, blockSize, [&](const range<size_t>& r) 
@@ -440,14 +471,13 @@ namespace embree
 	  edge->opposite_half_edge_ofs = 0;
 	  edge->edge_crease_weight     = mesh->edgeCreaseMap.lookup(key0,0.0f);
 	  edge->vertex_crease_weight   = mesh->vertexCreaseMap.lookup(startVertex0,0.0f);
-	  edge->edge_level             = mesh->getEdgeLevel(e+de);
+	  edge->edge_level             = mesh->getEdgeLevel(e+de,startVertex0,endVertex0);
           edge->patch_type             = HalfEdge::COMPLEX_PATCH; // type gets updated below
           edge->vertex_type            = HalfEdge::REGULAR_VERTEX;
 
-          if (unlikely(mesh->holeSet.lookup(unsigned(f)))) 
-	    halfEdges1[e+de] = SubdivMesh::KeyHalfEdge(std::numeric_limits<uint64_t>::max(),edge);
-	  else
-	    halfEdges1[e+de] = SubdivMesh::KeyHalfEdge(key,edge);
+          /* hole faces are sorted with their neighbors, but skipped when linking */
+          halfEdges1[e+de] = SubdivMesh::KeyHalfEdge(key,edge);
+          oppositeHalfEdges[e+de] = 0;
 	}
       }
     });
@@ -455,7 +485,12 @@ namespace embree
     /* sort half edges to find adjacent edges */
     radix_sort_u64(halfEdges1.data(),halfEdges0.data(),numHalfEdges);
 
+    auto isHole = [&] (const HalfEdge* edge) {
+      return mesh->holeSet.lookup(mesh->halfEdgeFace[edge-halfEdges.data()]);
+    };
+
     /* link all adjacent pairs of edges */
+    std::atomic<bool> anyNonManifold(false);
     parallel_for( size_t(0), numHalfEdges, blockSize, [&](const range<size_t>& r) 
     {
       /* skip if start of adjacent edges was not in our range */
@@ -469,45 +504,70 @@ namespace embree
       while (e<r.end())
       {
 	const uint64_t key = halfEdges1[e].key;
-	if (key == std::numeric_limits<uint64_t>::max()) break;
 	size_t N=1; while (e+N<numHalfEdges && halfEdges1[e+N].key == key) N++;
 
+        /* remember the adjacency without holes, such that holes can get updated without sorting */
+        if (N == 2 && halfEdges1[e+0].edge->next()->vtx_index == halfEdges1[e+1].edge->vtx_index)
+        {
+          oppositeHalfEdges[halfEdges1[e+0].edge-halfEdges.data()] = int(halfEdges1[e+1].edge-halfEdges1[e+0].edge);
+          oppositeHalfEdges[halfEdges1[e+1].edge-halfEdges.data()] = int(halfEdges1[e+0].edge-halfEdges1[e+1].edge);
+        }
+        else if (N > 2)
+          anyNonManifold = true;
+
+        /* gather all edges of faces that are not holes */
+        HalfEdge* local[2]; std::vector<HalfEdge*> large;
+        HalfEdge** edges = local;
+        if (N > 2) { large.resize(N); edges = large.data(); }
+        size_t M = 0;
+        for (size_t i=0; i<N; i++)
+          if (!isHole(halfEdges1[e+i].edge)) edges[M++] = halfEdges1[e+i].edge;
+
         /* border edges are identified by not having an opposite edge set */
-	if (N == 1) {
-          halfEdges1[e].edge->edge_crease_weight = float(inf);
+	if (M == 1) {
+          edges[0]->edge_crease_weight = float(inf);
 	}
 
         /* standard edge shared between two faces */
-        else if (N == 2)
+        else if (M == 2)
         {
           /* create edge crease if winding order mismatches between neighboring patches */
-          if (halfEdges1[e+0].edge->next()->vtx_index != halfEdges1[e+1].edge->vtx_index)
+          if (edges[0]->next()->vtx_index != edges[1]->vtx_index)
           {
-            halfEdges1[e+0].edge->edge_crease_weight = float(inf);
-            halfEdges1[e+1].edge->edge_crease_weight = float(inf);
+            edges[0]->edge_crease_weight = float(inf);
+            edges[1]->edge_crease_weight = float(inf);
           }
           /* otherwise mark edges as opposites of each other */
           else {
-            halfEdges1[e+0].edge->setOpposite(halfEdges1[e+1].edge);
-            halfEdges1[e+1].edge->setOpposite(halfEdges1[e+0].edge);
+            edges[0]->setOpposite(edges[1]);
+            edges[1]->setOpposite(edges[0]);
           }
 	}
 
         /* non-manifold geometry is handled by keeping vertices fixed during subdivision */
-        else {
-	  for (size_t i=0; i<N; i++) {
-	    halfEdges1[e+i].edge->vertex_crease_weight = inf;
-            halfEdges1[e+i].edge->vertex_type = HalfEdge::NON_MANIFOLD_EDGE_VERTEX;
-            halfEdges1[e+i].edge->edge_crease_weight = inf;
-
-	    halfEdges1[e+i].edge->next()->vertex_crease_weight = inf;
-            halfEdges1[e+i].edge->next()->vertex_type = HalfEdge::NON_MANIFOLD_EDGE_VERTEX;
-            halfEdges1[e+i].edge->next()->edge_crease_weight = inf;
+        else if (M > 2) {
+	  for (size_t i=0; i<M; i++) {
+	    edges[i]->vertex_crease_weight = inf;
+            edges[i]->vertex_type = HalfEdge::NON_MANIFOLD_EDGE_VERTEX;
+            edges[i]->edge_crease_weight = inf;
+
+	    edges[i]->next()->vertex_crease_weight = inf;
+            edges[i]->next()->vertex_type = HalfEdge::NON_MANIFOLD_EDGE_VERTEX;
+            edges[i]->next()->edge_crease_weight = inf;
 	  }
 	}
 	e+=N;
       }
     });
+    nonManifold = anyNonManifold;
+
+    calculatePatchTypes();
+  }
+
+  void SubdivMesh::Topology::calculatePatchTypes()
+  {
+    const size_t blockSize = 4096;
+    const size_t numFaces = mesh->numFaces();
 
     /* set subdivision mode and calculate patch types */
     parallel_for( size_t(0), numFaces, blockSize, [&](const range<size_t>& r) 
@@ -562,7 +622,7 @@ namespace embree
     /* calculate which data to update */
     const bool updateEdgeCreases   = mesh->topology[0].vertexIndices.isLocalModified() || mesh->edge_creases.isLocalModified()   || mesh->edge_crease_weights.isLocalModified();
     const bool updateVertexCreases = mesh->topology[0].vertexIndices.isLocalModified() || mesh->vertex_creases.isLocalModified() || mesh->vertex_crease_weights.isLocalModified(); 
-    const bool updateLevels = mesh->levels.isLocalModified();
+    const bool updateLevels = mesh->levels.isLocalModified() || (mesh->hasTessellationCone() && mesh->vertices[0].isLocalModified());
 
     /* parallel loop over all half edges */
     parallel_for( size_t(0), mesh->numHalfEdges, size_t(4096), [&](const range<size_t>& r) 
@@ -572,7 +632,7 @@ namespace embree
 	HalfEdge& edge = halfEdges[i];
 
 	if (updateLevels)
-	  edge.edge_level = mesh->getEdgeLevel(i); 
+	  edge.edge_level = mesh->getEdgeLevel(i,halfEdgesGeom[i].vtx_index,halfEdgesGeom[i].getEndVertexIndex());
         
 	if (updateEdgeCreases) {
 	  if (edge.hasOpposite()) // leave weight at inf for borders
@@ -581,30 +641,39 @@ namespace embree
         
         /* we only use user specified vertex_crease_weight if the vertex is manifold */
         if (updateVertexCreases && edge.vertex_type != HalfEdge::NON_MANIFOLD_EDGE_VERTEX) 
-        {
 	  edge.vertex_crease_weight = mesh->vertexCreaseMap.lookup(halfEdgesGeom[i].vtx_index,0.0f);
+      }
+    });
 
-          /* pin corner vertices when requested by user */
-          if (subdiv_mode == RTC_SUBDIVISION_MODE_PIN_CORNERS && edge.isCorner())
-            edge.vertex_crease_weight = float(inf);
-          
-          /* pin all border vertices when requested by user */
-          else if (subdiv_mode == RTC_SUBDIVISION_MODE_PIN_BOUNDARY && edge.vertexHasBorder()) 
-            edge.vertex_crease_weight = float(inf);
+    /* patch types depend on the creases of neighboring edges, thus have to get updated after all creases are set */
+    if (updateEdgeCreases || updateVertexCreases)
+      calculatePatchTypes();
+  }
 
-          /* pin every vertex when requested by user */
-          else if (subdiv_mode == RTC_SUBDIVISION_MODE_PIN_ALL) {
-            edge.edge_crease_weight = float(inf);
-            edge.vertex_crease_weight = float(inf);
-          }
-        }
+  void SubdivMesh::Topology::updateHoles()
+  {
+    /* we always use the geometry topology to lookup creases */
+    mvector<HalfEdge>& halfEdgesGeom = mesh->topology[0].halfEdges;
 
-        /* update patch type */
-        if (updateEdgeCreases || updateVertexCreases) {
-          edge.patch_type = edge.patchType();
-        }
+    /* relink all half edges using the adjacency calculated without holes */
+    parallel_for( size_t(0), mesh->numHalfEdges, size_t(4096), [&](const range<size_t>& r) 
+    {
+      for (size_t i=r.begin(); i!=r.end(); i++)
+      {
+	HalfEdge& edge = halfEdges[i];
+        const int ofs = oppositeHalfEdges[i];
+        const bool hole = mesh->holeSet.lookup(mesh->halfEdgeFace[i]);
+        const bool linked = !hole && ofs != 0 && !mesh->holeSet.lookup(mesh->halfEdgeFace[i+ofs]);
+        const float edge_crease_weight = mesh->edgeCreaseMap.lookup((uint64_t)halfEdgesGeom[i].getEdge(),0.0f);
+
+        /* edges of hole faces are not linked, other edges without opposite are borders */
+        edge.opposite_half_edge_ofs = linked ? ofs : 0;
+        edge.edge_crease_weight = (hole || linked) ? edge_crease_weight : float(inf);
+        edge.vertex_crease_weight = mesh->vertexCreaseMap.lookup(halfEdgesGeom[i].vtx_index,0.0f);
       }
     });
+
+    calculatePatchTypes();
   }
 
   void SubdivMesh::Topology::initializeHalfEdgeStructures ()
@@ -620,7 +689,10 @@ namespace embree
     bool recalculate = false;
     recalculate |= vertexIndices.isLocalModified(); 
     recalculate |= mesh->faceVertices.isLocalModified();
-    recalculate |= mesh->holes.isLocalModified();
+
+    /* holes can get updated without sorting for manifold meshes */
+    const bool updateHoles = mesh->holes.isLocalModified();
+    recalculate |= updateHoles && (nonManifold || oppositeHalfEdges.size() != mesh->numHalfEdges);
 
     /* check if we can simply update the half edges */
     bool update = false;
@@ -630,10 +702,14 @@ namespace embree
     update |= mesh->vertex_creases.isLocalModified();
     update |= mesh->vertex_crease_weights.isLocalModified(); 
     update |= mesh->levels.isLocalModified();
+    update |= mesh->hasTessellationCone() && mesh->vertices[0].isLocalModified(); // edge levels depend on vertex positions
 
     /* now either recalculate or update the half edges */
     if (recalculate) calculateHalfEdges();
-    else if (update) updateHalfEdges();
+    else {
+      if (updateHoles) this->updateHoles();
+      if (update) updateHalfEdges();
+    }
    
     /* cleanup some state for static scenes */
     /* if (mesh->scene_ == nullptr || mesh->scene_->isStaticAccel()) 
@@ -686,9 +762,12 @@ namespace embree
 
       /* calculate face of each half edge */
       halfEdgeFace.resize(numHalfEdges);
-      for (size_t f=0, h=0; f<numFaces(); f++)
-        for (size_t e=0; e<faceVertices[f]; e++)
-          halfEdgeFace[h++] = (unsigned int) f;
+      parallel_for( size_t(0), numFaces(), size_t(4096), [&](const range<size_t>& r)
+      {
+        for (size_t f=r.begin(); f<r.end(); f++)
+          for (size_t e=0; e<faceVertices[f]; e++)
+            halfEdgeFace[faceStartEdge[f]+e] = (unsigned int) f;
+      });
     }
     
     /* create set with all vertex creases */
@@ -865,7 +944,7 @@ namespace embree
       for (unsigned int i=0; i<valueCount; i+=4)
       {
         vfloat4 Pt, dPdut, dPdvt, ddPdudut, ddPdvdvt, ddPdudvt;
-        isa::PatchEval<vfloat4,vfloat4>(baseEntry->at(interpolationSlot(primID,i/4,stride)),commitCounter,
+        isa::PatchEval<vfloat4,vfloat4>(*device->tessellationCache,baseEntry->at(interpolationSlot(primID,i/4,stride)),commitCounter,
                                         topo->getHalfEdge(primID),src+i*sizeof(float),stride,u,v,
                                         has_P ? &Pt : nullptr, 
                                         has_dP ? &dPdut : nullptr, 
@@ -952,7 +1031,7 @@ namespace embree
                          for (unsigned int j=0; j<valueCount; j+=4) 
                          {
                            const size_t M = min(4u,valueCount-j);
-                           isa::PatchEvalSimd<vbool4,vint4,vfloat4,vfloat4>(baseEntry->at(interpolationSlot(primID,j/4,stride)),commitCounter,
+                           isa::PatchEvalSimd<vbool4,vint4,vfloat4,vfloat4>(*device->tessellationCache,baseEntry->at(interpolationSlot(primID,j/4,stride)),commitCounter,
                                                                             topo->getHalfEdge(primID),src+j*sizeof(float),stride,valid1,uu,vv,
                                                                             P ? P+j*N+i : nullptr,
                                                                             dPdu ? dPdu+j*N+i : nullptr,
@@ -965,5 +1044,129 @@ namespace embree
                        });
       }
     }
+
+    void SubdivMeshISA::interpolateBatch(const RTCInterpolateNArguments* const args)
+    {
+      const void* valid_i = args->valid;
+      const unsigned* primIDs = args->primIDs;
+      const float* u = args->u;
+      const float* v = args->v;
+      unsigned int N = args->N;
+      RTCBufferType bufferType = args->bufferType;
+      unsigned int bufferSlot = args->bufferSlot;
+      float* P = args->P;
+      float* dPdu = args->dPdu;
+      float* dPdv = args->dPdv;
+      float* ddPdudu = args->ddPdudu;
+      float* ddPdvdv = args->ddPdvdv;
+      float* ddPdudv = args->ddPdudv;
+      unsigned int valueCount = args->valueCount;
+    
+      /* calculate base pointer and stride */
+      assert((bufferType == RTC_BUFFER_TYPE_VERTEX && bufferSlot < RTC_MAX_TIME_STEP_COUNT) ||
+             (bufferType == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE && bufferSlot < RTC_MAX_USER_VERTEX_BUFFERS));
+      const char* src = nullptr; 
+      size_t stride = 0;
+      std::vector<SharedLazyTessellationCache::CacheEntry>* baseEntry = nullptr;
+      Topology* topo = nullptr;
+      if (bufferType == RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE) {
+        assert(bufferSlot < vertexAttribs.size());
+        src    = vertexAttribs[bufferSlot].getPtr();
+        stride = vertexAttribs[bufferSlot].getStride();
+        baseEntry = &vertex_attrib_buffer_tags[bufferSlot];
+        int topologyID = vertexAttribs[bufferSlot].userData;
+        topo = &topology[topologyID];
+      } else {
+        assert(bufferSlot < numTimeSteps);
+        src    = vertices[bufferSlot].getPtr();
+        stride = vertices[bufferSlot].getStride();
+        baseEntry = &vertex_buffer_tags[bufferSlot];
+        topo = &topology[0];
+      }
+      
+      const int* valid = (const int*) valid_i;
+
+      /* sort the samples by primitive, invalid samples get moved to the end */
+      const unsigned int invalidID = unsigned(-1);
+      std::vector<KeySample> samples0(N), samples1(N);
+      parallel_for(size_t(0), size_t(N), size_t(4096), [&](const range<size_t>& r) {
+          for (size_t i=r.begin(); i<r.end(); i++) {
+            const bool isValid = !valid || valid[i] == -1;
+            samples0[i] = KeySample(isValid ? primIDs[i] : invalidID, unsigned(i));
+          }
+        });
+      radix_sort_u32(samples0.data(),samples1.data(),N);
+
+      /* evaluates all samples of the primitive starting at sample b, the patch is looked up only once per group of 4 values */
+      auto evalPrimitive = [&] (const size_t b, const size_t e)
+      {
+        const unsigned int primID = samples0[b].primID;
+        const size_t numGroups = (e-b+3)/4;
+
+        for (unsigned int j=0; j<valueCount; j+=4)
+        {
+          const size_t M = min(4u,valueCount-j);
+          __aligned(16) float P_tmp[4*4], dPdu_tmp[4*4], dPdv_tmp[4*4], ddPdudu_tmp[4*4], ddPdvdv_tmp[4*4], ddPdudv_tmp[4*4];
+          
+          auto load = [&] (const size_t g, vbool4& valid1, vfloat4& uu, vfloat4& vv)
+          {
+            const size_t n = min(size_t(4),e-b-4*g);
+            valid1 = vint4(step) < vint4(int(n));
+            uu = vv = vfloat4(zero);
+            for (size_t l=0; l<n; l++) {
+              const unsigned int index = samples0[b+4*g+l].index;
+              uu[l] = u[index];
+              vv[l] = v[index];
+            }
+          };
+
+          auto flush = [&] (const size_t g, const vbool4& valid1)
+          {
+            const size_t n = min(size_t(4),e-b-4*g);
+            for (size_t l=0; l<n; l++)
+            {
+              const size_t i = samples0[b+4*g+l].index;
+              for (size_t k=0; k<M; k++) {
+                if (P) P[(j+k)*N+i] = P_tmp[4*k+l];
+                if (dPdu) {
+                  dPdu[(j+k)*N+i] = dPdu_tmp[4*k+l];
+                  dPdv[(j+k)*N+i] = dPdv_tmp[4*k+l];
+                }
+                if (ddPdudu) {
+                  ddPdudu[(j+k)*N+i] = ddPdudu_tmp[4*k+l];
+                  ddPdvdv[(j+k)*N+i] = ddPdvdv_tmp[4*k+l];
+                  ddPdudv[(j+k)*N+i] = ddPdudv_tmp[4*k+l];
+                }
+              }
+            }
+          };
+          
+          isa::PatchEvalSimd<vbool4,vint4,vfloat4,vfloat4>(*device->tessellationCache,baseEntry->at(interpolationSlot(primID,j/4,stride)),commitCounter,
+                                                           topo->getHalfEdge(primID),src+j*sizeof(float),stride,numGroups,load,flush,
+                                                           P ? P_tmp : nullptr,
+                                                           dPdu ? dPdu_tmp : nullptr,
+                                                           dPdu ? dPdv_tmp : nullptr,
+                                                           ddPdudu ? ddPdudu_tmp : nullptr,
+                                                           ddPdudu ? ddPdvdv_tmp : nullptr,
+                                                           ddPdudu ? ddPdudv_tmp : nullptr,
+                                                           4,M);
+        }
+      };
+
+      /* each task evaluates the primitives whose first sample lies inside its range */
+      parallel_for(size_t(0), size_t(N), size_t(1024), [&](const range<size_t>& r) 
+      {
+        for (size_t b=r.begin(); b<r.end(); b++)
+        {
+          const unsigned int primID = samples0[b].primID;
+          if (primID == invalidID) break;
+          if (b > 0 && samples0[b-1].primID == primID) continue;
+          size_t e = b+1;
+          while (e < N && samples0[e].primID == primID) e++;
+          evalPrimitive(b,e);
+          b = e-1;
+        }
+      });
+    }
   }
 }
@@ -61,6 +61,7 @@ namespace embree
     void* getBuffer(RTCBufferType type, unsigned int slot);
     void updateBuffer(RTCBufferType type, unsigned int slot);
     void setTessellationRate(float N);
+    void setTessellationCone(const Vec3fa& org, float width, float spread);
     bool verify();
     void commit();
     void addElementsToCount (GeometryCounts & counts) const;
@@ -123,6 +124,21 @@ namespace embree
       else return clamp(tessellationRate,1.0f,4096.0f); // FIXME: do we want to limit edge level?
     }
 
+    /* returns tessellation level of the i'th edge going from vertex v0 to vertex v1 */
+    __forceinline float getEdgeLevel(const size_t i, const unsigned int v0, const unsigned int v1) const
+    {
+      if (hasTessellationCone()) return getConeEdgeLevel(v0,v1);
+      else return getEdgeLevel(i);
+    }
+
+    /* returns true if edge levels are derived from the tessellation cone */
+    __forceinline bool hasTessellationCone() const {
+      return tessellationConeWidth > 0.0f || tessellationConeSpread > 0.0f;
+    }
+
+    /* calculates the tessellation level of an edge from the cone footprint at the edge */
+    float getConeEdgeLevel(const unsigned int v0, const unsigned int v1) const;
+
   public:
     RTCDisplacementFunctionN displFunc;    //!< displacement function
 
@@ -136,7 +152,7 @@ namespace embree
     public:
 
       /*! Default topology construction */
-      Topology () : halfEdges(nullptr,0) {}
+      Topology () : halfEdges(nullptr,0), nonManifold(false) {}
 
       /*! Topology initialization */
       Topology (SubdivMesh* mesh);
@@ -149,7 +165,9 @@ namespace embree
           subdiv_mode(std::move(other.subdiv_mode)),
           halfEdges(std::move(other.halfEdges)),
           halfEdges0(std::move(other.halfEdges0)),
-          halfEdges1(std::move(other.halfEdges1)) {}
+          halfEdges1(std::move(other.halfEdges1)),
+          oppositeHalfEdges(std::move(other.oppositeHalfEdges)),
+          nonManifold(other.nonManifold) {}
       
       Topology& operator= (Topology&& other) // FIXME: this is only required to workaround compilation issues under Windows
       {
@@ -159,6 +177,8 @@ namespace embree
         halfEdges = std::move(other.halfEdges);
         halfEdges0 = std::move(other.halfEdges0);
         halfEdges1 = std::move(other.halfEdges1);
+        oppositeHalfEdges = std::move(other.oppositeHalfEdges);
+        nonManifold = other.nonManifold;
         return *this;
       }
 
@@ -191,6 +211,12 @@ namespace embree
       
       /*! updates half edges when recalculation is not necessary */
       void updateHalfEdges();
+
+      /*! relinks half edges when only the holes changed */
+      void updateHoles();
+
+      /*! pins creases as requested by the subdivision mode and calculates the patch types */
+      void calculatePatchTypes();
       
       /*! user input data */
     public:
@@ -221,6 +247,10 @@ namespace embree
       /*! two arrays used to sort the half edges */
       std::vector<KeyHalfEdge> halfEdges0;
       std::vector<KeyHalfEdge> halfEdges1;
+
+      /*! offsets to the opposite half edges ignoring holes, used to update holes without sorting */
+      std::vector<int> oppositeHalfEdges;
+      bool nonManifold;
     };
 
     /*! returns the start half edge for topology t and face f */
@@ -256,6 +286,11 @@ namespace embree
     BufferView<float> levels;
     float tessellationRate;  // constant rate that is used when levels is not set
 
+    /*! ray cone to derive view dependent edge levels from, disabled if width and spread are zero */
+    Vec3fa tessellationConeOrg;
+    float tessellationConeWidth;
+    float tessellationConeSpread;
+
     /*! buffer that marks specific faces as holes */
     BufferView<unsigned> holes;
 
@@ -319,6 +354,23 @@ namespace embree
 
       void interpolate(const RTCInterpolateArguments* const args);
       void interpolateN(const RTCInterpolateNArguments* const args);
+      void interpolateBatch(const RTCInterpolateNArguments* const args);
+
+      /*! structure used to sort the samples of a batch interpolation using radix sort by their primitive */
+      struct KeySample
+      {
+        KeySample() {}
+
+        KeySample (unsigned int primID, unsigned int index)
+        : primID(primID), index(index) {}
+
+        __forceinline operator uint32_t() const {
+          return primID;
+        }
+
+        unsigned int primID;
+        unsigned int index;
+      };
     };
   }
 
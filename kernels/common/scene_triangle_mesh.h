@@ -188,6 +188,16 @@ namespace embree
       return true;
     }
 
+    /*! starts reading file mapped buffers before the triangles of the range are accessed */
+    __forceinline void prefetchBuffers(const range<size_t>& r) const
+    {
+      triangles.prefetch(r);
+      if (r.begin() == 0) {
+        for (const auto& buffer : vertices)
+          buffer.prefetch(range<size_t>(0,buffer.size()));
+      }
+    }
+
     /*! get fast access to first vertex buffer */
     __forceinline float * getCompactVertexArray () const {
       return (float*) vertices0.getPtr();
@@ -229,6 +239,7 @@ namespace embree
       PrimInfo createPrimRefArray(mvector<PrimRef>& prims, const range<size_t>& r, size_t k, unsigned int geomID) const
       {
         PrimInfo pinfo(empty);
+        prefetchBuffers(r);
         for (size_t j=r.begin(); j<r.end(); j++)
         {
           BBox3fa bounds = empty;
@@ -243,6 +254,7 @@ namespace embree
       PrimInfo createPrimRefArrayMB(mvector<PrimRef>& prims, size_t itime, const range<size_t>& r, size_t k, unsigned int geomID) const
       {
         PrimInfo pinfo(empty);
+        prefetchBuffers(r);
         for (size_t j=r.begin(); j<r.end(); j++)
         {
           BBox3fa bounds = empty;
@@ -19,6 +19,8 @@ namespace embree
     virtual void setBoundsFunction (RTCBoundsFunction bounds, void* userPtr);
     virtual void setIntersectFunctionN (RTCIntersectFunctionN intersect);
     virtual void setOccludedFunctionN (RTCOccludedFunctionN occluded);
+    virtual void setIntersectFunctionBatch (RTCIntersectFunctionBatch intersect);
+    virtual void setOccludedFunctionBatch (RTCOccludedFunctionBatch occluded);
     virtual void build() {}
     virtual void addElementsToCount (GeometryCounts & counts) const;
   };
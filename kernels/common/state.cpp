@@ -66,6 +66,8 @@ namespace embree
     hair_accel = "default";
     hair_builder = "default";
     hair_traverser = "default";
+    hair_pretessellate = false;
+    hair_pretessellate_segments = 3;
 
     hair_accel_mb = "default";
     hair_builder_mb = "default";
@@ -73,8 +75,8 @@ namespace embree
 
     object_accel = "default";
     object_builder = "default";
-    object_accel_min_leaf_size = 1;
-    object_accel_max_leaf_size = 1;
+    object_accel_min_leaf_size = 0;
+    object_accel_max_leaf_size = 0;
 
     object_accel_mb = "default";
     object_builder_mb = "default";
@@ -83,8 +85,14 @@ namespace embree
 
     max_spatial_split_replications = 1.2f;
     useSpatialPreSplits = false;
+    max_temporal_split_replications = inf;
+    temporal_split_motion_threshold = 0.0f;
+    quantized_binning_threshold = 0;
+    single_thread_threshold = 0;
+    morton_code_bits = 32;
 
     tessellation_cache_size = 128*1024*1024;
+    block_pool_max_size = 0;
 
     subdiv_accel = "default";
     subdiv_accel_mb = "default";
@@ -335,6 +343,10 @@ namespace embree
         hair_builder = cin->get().Identifier();
       else if (tok == Token::Id("hair_traverser") && cin->trySymbol("="))
         hair_traverser = cin->get().Identifier();
+      else if (tok == Token::Id("hair_pretessellate") && cin->trySymbol("="))
+        hair_pretessellate = cin->get().Int();
+      else if (tok == Token::Id("hair_pretessellate_segments") && cin->trySymbol("="))
+        hair_pretessellate_segments = clamp(cin->get().Int(),1,64);
 
       else if (tok == Token::Id("hair_accel_mb") && cin->trySymbol("="))
         hair_accel_mb = cin->get().Identifier();
@@ -415,6 +427,20 @@ namespace embree
       else if (tok == Token::Id("max_spatial_split_replications") && cin->trySymbol("="))
         max_spatial_split_replications = cin->get().Float();
 
+      else if (tok == Token::Id("max_temporal_split_replications") && cin->trySymbol("="))
+        max_temporal_split_replications = cin->get().Float();
+      else if (tok == Token::Id("temporal_split_motion_threshold") && cin->trySymbol("="))
+        temporal_split_motion_threshold = cin->get().Float();
+      else if (tok == Token::Id("quantized_binning_threshold") && cin->trySymbol("="))
+        quantized_binning_threshold = cin->get().Int();
+      else if (tok == Token::Id("single_thread_threshold") && cin->trySymbol("=")) {
+        Token value = cin->get();
+        if (value == Token::Id("auto")) single_thread_threshold = 0;
+        else single_thread_threshold = value.Int();
+      }
+      else if (tok == Token::Id("morton_code_bits") && cin->trySymbol("="))
+        morton_code_bits = cin->get().Int() == 64 ? 64 : 32;
+
       else if (tok == Token::Id("presplits") && cin->trySymbol("="))
         useSpatialPreSplits = cin->get().Int() != 0 ? true : false;
 
@@ -422,6 +448,8 @@ namespace embree
         tessellation_cache_size = size_t(cin->get().Float()*1024.0f*1024.0f);
       else if (tok == Token::Id("cache_size") && cin->trySymbol("="))
         tessellation_cache_size = size_t(cin->get().Float()*1024.0f*1024.0f);
+      else if (tok == Token::Id("block_pool_max_size") && cin->trySymbol("="))
+        block_pool_max_size = size_t(cin->get().Float()*1024.0f*1024.0f);
 
       else if (tok == Token::Id("alloc_main_block_size") && cin->trySymbol("="))
         alloc_main_block_size = cin->get().Int();
@@ -462,7 +490,15 @@ namespace embree
 
     std::cout << "  verbosity          = " << verbose << std::endl;
     std::cout << "  cache_size         = " << float(tessellation_cache_size)*1E-6 << " MB" << std::endl;
+    std::cout << "  block_pool_max_size = " << float(block_pool_max_size)*1E-6 << " MB" << std::endl;
     std::cout << "  max_spatial_split_replications = " << max_spatial_split_replications << std::endl;
+    std::cout << "  max_temporal_split_replications = " << max_temporal_split_replications << std::endl;
+    std::cout << "  temporal_split_motion_threshold = " << temporal_split_motion_threshold << std::endl;
+    std::cout << "  quantized_binning_threshold = " << quantized_binning_threshold << std::endl;
+    std::cout << "  single_thread_threshold = ";
+    if (single_thread_threshold == 0) std::cout << "auto" << std::endl;
+    else std::cout << single_thread_threshold << std::endl;
+    std::cout << "  morton_code_bits = " << morton_code_bits << std::endl;
     
     std::cout << "triangles:" << std::endl;
     std::cout << "  accel              = " << tri_accel << std::endl;
@@ -498,6 +534,8 @@ namespace embree
     std::cout << "  accel              = " << hair_accel << std::endl;
     std::cout << "  builder            = " << hair_builder << std::endl;
     std::cout << "  traverser          = " << hair_traverser << std::endl;
+    std::cout << "  pretessellate      = " << hair_pretessellate << std::endl;
+    std::cout << "  pretess. segments  = " << hair_pretessellate_segments << std::endl;
 
     std::cout << "motion blur hair:" << std::endl;
     std::cout << "  accel              = " << hair_accel_mb << std::endl;
@@ -74,6 +74,8 @@ namespace embree
     std::string hair_accel;                //!< hair acceleration structure to use
     std::string hair_builder;              //!< builder to use for hair
     std::string hair_traverser;            //!< traverser to use for hair
+    bool hair_pretessellate;               //!< bakes round curves into round linear segments at build time
+    int hair_pretessellate_segments;       //!< number of round linear segments per pre-tessellated curve
 
   public:
     std::string hair_accel_mb;             //!< acceleration structure to use for motion blur hair
@@ -83,8 +85,8 @@ namespace embree
   public:
     std::string object_accel;               //!< acceleration structure for user geometries
     std::string object_builder;             //!< builder for user geometries
-    int object_accel_min_leaf_size;         //!< minimum leaf size for object acceleration structure
-    int object_accel_max_leaf_size;         //!< maximum leaf size for object acceleration structure
+    int object_accel_min_leaf_size;         //!< minimum leaf size for object acceleration structure, 0 selects it automatically
+    int object_accel_max_leaf_size;         //!< maximum leaf size for object acceleration structure, 0 selects it automatically
 
   public:
     std::string object_accel_mb;            //!< acceleration structure for user geometries
@@ -105,7 +107,13 @@ namespace embree
   public:
     float max_spatial_split_replications;  //!< maximally replications*N many primitives in accel for spatial splits
     bool useSpatialPreSplits;              //!< use spatial pre-splits instead of the full spatial split builder
-    size_t tessellation_cache_size;        //!< size of the shared tessellation cache 
+    float max_temporal_split_replications; //!< motion blur builders create at most replications*N additional primitives through temporal splits
+    float temporal_split_motion_threshold; //!< minimal average motion magnitude of the primitives of a subtree to consider temporal splits
+    size_t quantized_binning_threshold;    //!< SAH builds of at least that many primitives bin 16 bit quantized primrefs, 0 disables them
+    size_t single_thread_threshold;        //!< subtrees up to that size get built sequentially by the SAH builder, 0 chooses the threshold during the build
+    size_t morton_code_bits;               //!< number of bits of the morton codes of the morton builders, 32 or 64
+    size_t tessellation_cache_size;        //!< size of the tessellation cache of the device
+    size_t block_pool_max_size;            //!< maximal size of the pool of freed builder memory blocks of the device
 
   public:
     size_t instancing_open_min;            //!< instancing opens tree to minimally that number of subtrees
@@ -7,7 +7,60 @@ namespace embree
 {
   /*! invokes the memory monitor callback */
   struct MemoryMonitorInterface {
-    virtual void memoryMonitor(ssize_t bytes, bool post) = 0;
+    virtual void memoryMonitor(ssize_t bytes, bool post, RTCMemoryCategory category) = 0;
+  };
+
+  /*! tracks current and peak number of bytes per memory category */
+  class MemoryStatistics
+  {
+    static const size_t NUM_CATEGORIES = RTC_MEMORY_CATEGORY_BLOCK_POOL+1;
+
+  public:
+    MemoryStatistics ()
+    {
+      for (size_t i=0; i<NUM_CATEGORIES; i++) {
+        bytes[i].store(0);
+        peakBytes[i].store(0);
+      }
+    }
+
+    /*! adds bytes to a category and the total */
+    __forceinline void add(RTCMemoryCategory category, ssize_t bytes_in)
+    {
+      if (bytes_in == 0) return;
+      add_internal(category,bytes_in);
+      add_internal(RTC_MEMORY_CATEGORY_TOTAL,bytes_in);
+    }
+
+    /*! moves bytes from one category to another, the total stays the same */
+    __forceinline void move(RTCMemoryCategory from, RTCMemoryCategory to, ssize_t bytes_in)
+    {
+      if (bytes_in == 0) return;
+      add_internal(to,bytes_in);
+      add_internal(from,-bytes_in);
+    }
+
+    __forceinline size_t get(RTCMemoryCategory category) const {
+      assert(bytes[category].load() >= 0);
+      return size_t(bytes[category].load());
+    }
+
+    __forceinline size_t getPeak(RTCMemoryCategory category) const {
+      return peakBytes[category].load();
+    }
+
+  private:
+    __forceinline void add_internal(RTCMemoryCategory category, ssize_t bytes_in)
+    {
+      const ssize_t cur = bytes[category].fetch_add(bytes_in)+bytes_in;
+      if (bytes_in < 0) return;
+      size_t peak = peakBytes[category].load();
+      while (ssize_t(peak) < cur && !peakBytes[category].compare_exchange_weak(peak,size_t(cur)));
+    }
+
+  private:
+    std::atomic<ssize_t> bytes[NUM_CATEGORIES];
+    std::atomic<size_t> peakBytes[NUM_CATEGORIES];
   };
 
   /*! allocator that performs aligned monitored allocations */
@@ -29,7 +82,7 @@ namespace embree
       {
         if (n) {
           assert(device);
-          device->memoryMonitor(n*sizeof(T),false);
+          device->memoryMonitor(n*sizeof(T),false,RTC_MEMORY_CATEGORY_BUILD_TEMPORARIES);
         }
         if (n*sizeof(value_type) >= 14 * PAGE_SIZE_2M)
         {
@@ -53,7 +106,7 @@ namespace embree
 
         if (n) {
           assert(device);
-          device->memoryMonitor(-ssize_t(n)*sizeof(T),true);
+          device->memoryMonitor(-ssize_t(n)*sizeof(T),true,RTC_MEMORY_CATEGORY_BUILD_TEMPORARIES);
         }
       }
 
@@ -4,6 +4,9 @@
 #pragma once
 
 #include "curveNi.h"
+#include "../subdiv/bezier_curve.h"
+#include "../subdiv/bspline_curve.h"
+#include "../subdiv/catmullrom_curve.h"
 
 namespace embree
 {
@@ -61,6 +64,30 @@ namespace embree
       }
     }
 
+    /*! evaluates a round curve at 4 equidistant locations, the
+     *  intersector interpolates the end points of the round linear
+     *  segments that represent the curve from these points */
+    template<typename NativeCurve3fa>
+    __forceinline void tessellate(size_t N)
+    {
+      for (size_t i=0; i<N; i++)
+      {
+        const NativeCurve3fa curve(Vec3fa::loadu(&this->vertices(i,N)[0]),
+                                   Vec3fa::loadu(&this->vertices(i,N)[1]),
+                                   Vec3fa::loadu(&this->vertices(i,N)[2]),
+                                   Vec3fa::loadu(&this->vertices(i,N)[3]));
+        const Vec3fa p0 = curve.eval(0.0f/3.0f);
+        const Vec3fa p1 = curve.eval(1.0f/3.0f);
+        const Vec3fa p2 = curve.eval(2.0f/3.0f);
+        const Vec3fa p3 = curve.eval(3.0f/3.0f);
+        Vec3fa::storeu(&this->vertices(i,N)[0],p0);
+        Vec3fa::storeu(&this->vertices(i,N)[1],p1);
+        Vec3fa::storeu(&this->vertices(i,N)[2],p2);
+        Vec3fa::storeu(&this->vertices(i,N)[3],p3);
+      }
+      this->ty = (uint8_t) ((this->ty & Geometry::GTY_BASIS_MASK) | Geometry::GTY_SUBTYPE_TESSELLATED_CURVE);
+    }
+
     template<typename BVH, typename Allocator>
       __forceinline static typename BVH::NodeRef createLeaf (BVH* bvh, const PrimRef* prims, const range<size_t>& set, const Allocator& alloc)
     {
@@ -76,6 +103,10 @@ namespace embree
         return CurveNi<M>::createLeaf(bvh,prims,set,alloc);
       }
       
+      /* optionally bake round curves into round linear segments */
+      Geometry::GType basis = bvh->scene->get(geomID)->getCurveBasis();
+      bool pretessellate = bvh->scene->device->hair_pretessellate && bvh->scene->get(geomID)->getCurveType() == Geometry::GTY_SUBTYPE_ROUND_CURVE;
+      
       size_t start = set.begin();
       size_t items = CurveNv::blocks(set.size());
       size_t numbytes = CurveNv::bytes(set.size());
@@ -83,6 +114,15 @@ namespace embree
       for (size_t i=0; i<items; i++) {
         accel[i].CurveNv<M>::fill(prims,start,set.end(),bvh->scene);
         accel[i].CurveNi<M>::fill(prims,start,set.end(),bvh->scene);
+        if (pretessellate) {
+          const size_t N = accel[i].N;
+          switch (basis) {
+          case Geometry::GTY_BASIS_BEZIER     : accel[i].template tessellate<BezierCurve3fa>(N); break;
+          case Geometry::GTY_BASIS_BSPLINE    : accel[i].template tessellate<BSplineCurve3fa>(N); break;
+          case Geometry::GTY_BASIS_CATMULL_ROM: accel[i].template tessellate<CatmullRomCurve3fa>(N); break;
+          default: break;
+          }
+        }
       }
       return bvh->encodeLeaf((char*)accel,items);
     };
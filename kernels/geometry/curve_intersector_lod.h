@@ -0,0 +1,65 @@
+// Copyright 2009-2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "curve_intersector_precalculations.h"
+#include "curve_intersector_ribbon.h"
+#include "curve_intersector_sweep.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Checks if the curve is thinner than the footprint of the ray
+     *  cone at the distance of the curve. Such curves are intersected
+     *  as flat ribbons instead of the more expensive round sweep. */
+    template<typename NativeCurve3fa>
+    __forceinline bool curveBelowRayCone(const IntersectContext* context, const Vec3fa& ray_org, const Vec3fa& ray_dir,
+                                         const Vec3fa& v0, const Vec3fa& v1, const Vec3fa& v2, const Vec3fa& v3)
+    {
+      if (likely(!context->hasRayCones()))
+        return false;
+
+      const NativeCurve3fa curve(v0,v1,v2,v3);
+      const float radius = curve.bounds().upper.w;
+      const float dist = max(0.0f,dot(curve.center()-ray_org,ray_dir)*rsqrt(dot(ray_dir,ray_dir)));
+      const float footprint = context->user->coneWidth + dist*context->user->coneSpread;
+      return 2.0f*radius < footprint;
+    }
+
+    template<typename NativeCurve3fa, typename RibbonEpilog>
+    struct LODCurve1Intersector1
+    {
+      template<typename GeometryT, typename Epilog>
+      __forceinline bool intersect(const CurvePrecalculations1& pre, Ray& ray,
+                                   const GeometryT* geom, const unsigned int primID,
+                                   const Vec3fa& v0, const Vec3fa& v1, const Vec3fa& v2, const Vec3fa& v3,
+                                   const Epilog& epilog)
+      {
+        if (curveBelowRayCone<NativeCurve3fa>(epilog.context,ray.org,ray.dir,v0,v1,v2,v3))
+          return RibbonCurve1Intersector1<NativeCurve3fa>().intersect(pre,ray,geom,primID,v0,v1,v2,v3,RibbonEpilog(epilog.ray,epilog.context,epilog.geomID,epilog.primID));
+        else
+          return SweepCurve1Intersector1<NativeCurve3fa>().intersect(pre,ray,geom,primID,v0,v1,v2,v3,epilog);
+      }
+    };
+
+    template<typename NativeCurve3fa, int K, typename RibbonEpilog>
+    struct LODCurve1IntersectorK
+    {
+      template<typename GeometryT, typename Epilog>
+      __forceinline bool intersect(const CurvePrecalculationsK<K>& pre, RayK<K>& ray, size_t k,
+                                   const GeometryT* geom, const unsigned int primID,
+                                   const Vec3fa& v0, const Vec3fa& v1, const Vec3fa& v2, const Vec3fa& v3,
+                                   const Epilog& epilog)
+      {
+        const Vec3fa ray_org(ray.org.x[k],ray.org.y[k],ray.org.z[k]);
+        const Vec3fa ray_dir(ray.dir.x[k],ray.dir.y[k],ray.dir.z[k]);
+        if (curveBelowRayCone<NativeCurve3fa>(epilog.context,ray_org,ray_dir,v0,v1,v2,v3))
+          return RibbonCurve1IntersectorK<NativeCurve3fa,K>().intersect(pre,ray,k,geom,primID,v0,v1,v2,v3,RibbonEpilog(epilog.ray,k,epilog.context,epilog.geomID,epilog.primID));
+        else
+          return SweepCurve1IntersectorK<NativeCurve3fa,K>().intersect(pre,ray,k,geom,primID,v0,v1,v2,v3,epilog);
+      }
+    };
+  }
+}
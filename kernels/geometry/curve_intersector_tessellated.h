@@ -0,0 +1,111 @@
+// Copyright 2009-2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "curve_intersector_precalculations.h"
+#include "roundline_intersector.h"
+
+namespace embree
+{
+  namespace isa
+  {
+    /*! Intersects round curves that got baked at build time into the 4
+     *  curve points at u = 0, 1/3, 2/3 and 1. These points determine the
+     *  cubic curve, which gets approximated by a configurable number of
+     *  round linear segments whose end points are interpolated from the
+     *  stored points. For the default of 3 segments these are the stored
+     *  points, thus no basis conversion or curve subdivision is required
+     *  at intersection time. */
+    template<int M>
+    struct TessellatedCurve
+    {
+      /* maps the u coordinate of a segment to the u coordinate of the curve */
+      template<typename Epilog>
+      struct SegmentEpilog
+      {
+        const Epilog& epilog;
+        const int first;
+        const float rcpSegments;
+        __forceinline SegmentEpilog(const Epilog& epilog, int first, float rcpSegments)
+          : epilog(epilog), first(first), rcpSegments(rcpSegments) {}
+
+        __forceinline bool operator() (const vbool<M>& valid, RoundLineIntersectorHitM<M>& hit) const
+        {
+          hit.vu = (vfloat<M>(first) + vfloat<M>(step) + hit.vu) * vfloat<M>(rcpSegments);
+          return epilog(valid,hit);
+        }
+      };
+
+      /* evaluates the cubic through the 4 stored points at u = k/segments, points before the start and after the end of the curve are set to inf */
+      static __forceinline Vec4vf<M> eval(const vint<M>& k, int segments, const Vec3fa& v0, const Vec3fa& v1, const Vec3fa& v2, const Vec3fa& v3)
+      {
+        const vfloat<M> t = vfloat<M>(3*k)/vfloat<M>(float(segments));
+        const vfloat<M> t1 = t-1.0f, t2 = t-2.0f, t3 = t-3.0f;
+        const vfloat<M> w0 = -t1*t2*t3*vfloat<M>(1.0f/6.0f);
+        const vfloat<M> w1 =  t *t2*t3*vfloat<M>(0.5f);
+        const vfloat<M> w2 = -t *t1*t3*vfloat<M>(0.5f);
+        const vfloat<M> w3 =  t *t1*t2*vfloat<M>(1.0f/6.0f);
+        const Vec4vf<M> p = w0*Vec4vf<M>(v0) + w1*Vec4vf<M>(v1) + w2*Vec4vf<M>(v2) + w3*Vec4vf<M>(v3);
+        const vbool<M> outside = (k < vint<M>(0)) | (k > vint<M>(segments));
+        const vfloat<M> vinf(inf);
+        return Vec4vf<M>(select(outside,vinf,p.x),select(outside,vinf,p.y),select(outside,vinf,p.z),select(outside,vinf,p.w));
+      }
+
+      /* gathers the segments [first,first+M) and their neighbors into SIMD lanes */
+      static __forceinline vbool<M> gather(Vec4vf<M>& p0, Vec4vf<M>& p1, Vec4vf<M>& pL, Vec4vf<M>& pR, int first, int segments,
+                                           const Vec3fa& v0, const Vec3fa& v1, const Vec3fa& v2, const Vec3fa& v3)
+      {
+        const vint<M> k = vint<M>(first) + vint<M>(step);
+        pL = eval(k-1,segments,v0,v1,v2,v3);
+        p0 = eval(k+0,segments,v0,v1,v2,v3);
+        p1 = eval(k+1,segments,v0,v1,v2,v3);
+        pR = eval(k+2,segments,v0,v1,v2,v3);
+        return k < vint<M>(segments);
+      }
+    };
+
+    struct TessellatedCurve1Intersector1
+    {
+      template<typename GeometryT, typename Epilog>
+      __forceinline bool intersect(const CurvePrecalculations1& pre, Ray& ray,
+                                   const GeometryT* geom, const unsigned int primID,
+                                   const Vec3fa& v0, const Vec3fa& v1, const Vec3fa& v2, const Vec3fa& v3,
+                                   const Epilog& epilog)
+      {
+        typedef typename TessellatedCurve<VSIZEX>::template SegmentEpilog<Epilog> SegmentEpilog;
+        const int segments = geom->device->hair_pretessellate_segments;
+        bool ishit = false;
+        for (int first=0; first<segments; first+=VSIZEX)
+        {
+          Vec4vf<VSIZEX> p0,p1,pL,pR;
+          const vbool<VSIZEX> valid = TessellatedCurve<VSIZEX>::gather(p0,p1,pL,pR,first,segments,v0,v1,v2,v3);
+          ishit |= RoundLinearCurveIntersector1<VSIZEX>::intersect(valid,ray,pre,p0,p1,pL,pR,SegmentEpilog(epilog,first,1.0f/float(segments)));
+        }
+        return ishit;
+      }
+    };
+
+    template<int K>
+    struct TessellatedCurve1IntersectorK
+    {
+      template<typename GeometryT, typename Epilog>
+      __forceinline bool intersect(const CurvePrecalculationsK<K>& pre, RayK<K>& ray, size_t k,
+                                   const GeometryT* geom, const unsigned int primID,
+                                   const Vec3fa& v0, const Vec3fa& v1, const Vec3fa& v2, const Vec3fa& v3,
+                                   const Epilog& epilog)
+      {
+        typedef typename TessellatedCurve<VSIZEX>::template SegmentEpilog<Epilog> SegmentEpilog;
+        const int segments = geom->device->hair_pretessellate_segments;
+        bool ishit = false;
+        for (int first=0; first<segments; first+=VSIZEX)
+        {
+          Vec4vf<VSIZEX> p0,p1,pL,pR;
+          const vbool<VSIZEX> valid = TessellatedCurve<VSIZEX>::gather(p0,p1,pL,pR,first,segments,v0,v1,v2,v3);
+          ishit |= RoundLinearCurveIntersectorK<VSIZEX,K>::intersect(valid,ray,k,pre,p0,p1,pL,pR,SegmentEpilog(epilog,first,1.0f/float(segments)));
+        }
+        return ishit;
+      }
+    };
+  }
+}
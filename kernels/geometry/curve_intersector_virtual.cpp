@@ -50,6 +50,9 @@ namespace embree
       function_local_static_prim.vtbl[Geometry::GTY_ROUND_CATMULL_ROM_CURVE] = CurveNiIntersectors <CatmullRomCurve3fa,4>();
       function_local_static_prim.vtbl[Geometry::GTY_FLAT_CATMULL_ROM_CURVE ] = RibbonNiIntersectors<CatmullRomCurve3fa,4>();
       function_local_static_prim.vtbl[Geometry::GTY_ORIENTED_CATMULL_ROM_CURVE] = OrientedCurveNiIntersectors<CatmullRomCurve3fa,4>();
+      function_local_static_prim.vtbl[Geometry::GTY_BASIS_BEZIER      | Geometry::GTY_SUBTYPE_TESSELLATED_CURVE] = TessellatedCurveNvIntersectors<4>();
+      function_local_static_prim.vtbl[Geometry::GTY_BASIS_BSPLINE     | Geometry::GTY_SUBTYPE_TESSELLATED_CURVE] = TessellatedCurveNvIntersectors<4>();
+      function_local_static_prim.vtbl[Geometry::GTY_BASIS_CATMULL_ROM | Geometry::GTY_SUBTYPE_TESSELLATED_CURVE] = TessellatedCurveNvIntersectors<4>();
       return &function_local_static_prim;
     }
 
@@ -23,6 +23,37 @@ namespace embree
               const unsigned x0, const unsigned x1, const unsigned y0, const unsigned y1, const unsigned swidth, const unsigned sheight,
               const SubdivMesh* const geom, const size_t totalBvhBytes, const size_t gridBytes, BBox3fa* bounds_o = nullptr);
 
+      /*! returns the size of the BVH over a subgrid in bytes */
+      static __forceinline size_t getSubgridBVHBytes(const unsigned time_steps, const unsigned width, const unsigned height)
+      {
+        const GridRange range(0,width-1,0,height-1);
+        if (time_steps == 1) 
+          return getBVHBytes(range,sizeof(BVH4::AABBNode),0);
+        
+        size_t bvhBytes = (time_steps-1)*getBVHBytes(range,sizeof(BVH4::AABBNodeMB),0);
+        bvhBytes += getTemporalBVHBytes(make_range(0,int(time_steps-1)),sizeof(BVH4::AABBNodeMB4D));
+        return bvhBytes;
+      }
+
+      /*! returns the size of the grid vertex data of one time step in bytes */
+      static __forceinline size_t getSubgridGridBytes(const unsigned width, const unsigned height) {
+        return 4*size_t(width)*size_t(height)*sizeof(float);
+      }
+
+      /*! returns the number of bytes a subgrid of the specified size allocates */
+      static __forceinline size_t getAllocationBytes(const unsigned time_steps, const unsigned width, const unsigned height, const size_t bvhBytes)
+      {
+        size_t rootBytes = time_steps*sizeof(BVH4::NodeRef);
+#if !defined(__X86_64__) && !defined(__aarch64__)
+        rootBytes += 4; // We read 2 elements behind the grid. As we store at least 8 root bytes after the grid we are fine in 64 bit mode. But in 32 bit mode we have to do additional padding.
+#endif
+        return offsetof(GridSOA,data)+bvhBytes+time_steps*getSubgridGridBytes(width,height)+rootBytes;
+      }
+
+      static __forceinline size_t getAllocationBytes(const unsigned time_steps, const unsigned width, const unsigned height) {
+        return getAllocationBytes(time_steps,width,height,getSubgridBVHBytes(time_steps,width,height));
+      }
+
       /*! Subgrid creation */
       template<typename Allocator>
         static GridSOA* create(const SubdivPatch1Base* patches, const unsigned time_steps,
@@ -31,20 +62,9 @@ namespace embree
       {
         const unsigned width = x1-x0+1;  
         const unsigned height = y1-y0+1; 
-        const GridRange range(0,width-1,0,height-1);
-        size_t bvhBytes = 0;
-        if (time_steps == 1) 
-          bvhBytes = getBVHBytes(range,sizeof(BVH4::AABBNode),0);
-        else {
-          bvhBytes = (time_steps-1)*getBVHBytes(range,sizeof(BVH4::AABBNodeMB),0);
-          bvhBytes += getTemporalBVHBytes(make_range(0,int(time_steps-1)),sizeof(BVH4::AABBNodeMB4D));
-        }
-        const size_t gridBytes = 4*size_t(width)*size_t(height)*sizeof(float);  
-        size_t rootBytes = time_steps*sizeof(BVH4::NodeRef);
-#if !defined(__X86_64__) && !defined(__aarch64__)
-        rootBytes += 4; // We read 2 elements behind the grid. As we store at least 8 root bytes after the grid we are fine in 64 bit mode. But in 32 bit mode we have to do additional padding.
-#endif
-        void* data = alloc(offsetof(GridSOA,data)+bvhBytes+time_steps*gridBytes+rootBytes);
+        const size_t bvhBytes = getSubgridBVHBytes(time_steps,width,height);
+        const size_t gridBytes = getSubgridGridBytes(width,height);
+        void* data = alloc(getAllocationBytes(time_steps,width,height,bvhBytes));
         assert(data);
         return new (data) GridSOA(patches,time_steps,x0,x1,y0,y1,patches->grid_u_res,patches->grid_v_res,scene->get<SubdivMesh>(patches->geomID()),bvhBytes,gridBytes,bounds_o);
       }
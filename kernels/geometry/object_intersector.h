@@ -4,12 +4,26 @@
 #pragma once
 
 #include "object.h"
+#include "intersector_iterators.h"
 #include "../common/ray.h"
 
 namespace embree
 {
   namespace isa
   {
+    /*! maximal number of primitives passed to a batch callback of a user geometry */
+    static const size_t MAX_OBJECT_BATCH_SIZE = 32;
+
+    /*! gathers the primIDs of consecutive objects of the same geometry as the first object */
+    __forceinline size_t gatherObjectBatch(const Object* prim, size_t num, unsigned int* primIDs)
+    {
+      const unsigned int geomID = prim[0].geomID();
+      size_t n = 0;
+      for (; n<min(num,MAX_OBJECT_BATCH_SIZE) && prim[n].geomID() == geomID; n++)
+        primIDs[n] = prim[n].primID();
+      return n;
+    }
+
     template<bool mblur>
     struct ObjectIntersector1
     {
@@ -47,6 +61,29 @@ namespace embree
         accel->occluded(ray,prim.geomID(),prim.primID(),context,&reportOcclusion1);
         return ray.tfar < 0.0f;
       }
+
+      static __forceinline void intersectBatch(const Precalculations& pre, RayHit& ray, IntersectContext* context, AccelSet* accel, unsigned int geomID, const unsigned int* primIDs, size_t numPrimIDs)
+      {
+        /* perform ray mask test */
+#if defined(EMBREE_RAY_MASK)
+        if ((ray.mask & accel->mask) == 0) 
+          return;
+#endif
+
+        accel->intersect(ray,geomID,primIDs,numPrimIDs,context,reportIntersection1);
+      }
+
+      static __forceinline bool occludedBatch(const Precalculations& pre, Ray& ray, IntersectContext* context, AccelSet* accel, unsigned int geomID, const unsigned int* primIDs, size_t numPrimIDs)
+      {
+        /* perform ray mask test */
+#if defined(EMBREE_RAY_MASK)
+        if ((ray.mask & accel->mask) == 0) 
+          return false;
+#endif
+
+        accel->occluded(ray,geomID,primIDs,numPrimIDs,context,&reportOcclusion1);
+        return ray.tfar < 0.0f;
+      }
       
       static __forceinline bool pointQuery(PointQuery* query, PointQueryContext* context, const Primitive& prim)
       {
@@ -105,6 +142,31 @@ namespace embree
         accel->occluded(valid,ray,prim.geomID(),prim.primID(),context,&reportOcclusion1);
         return ray.tfar < 0.0f;
       }
+
+      static __forceinline void intersectBatch(const vbool<K>& valid_i, const Precalculations& pre, RayHitK<K>& ray, IntersectContext* context, AccelSet* accel, unsigned int geomID, const unsigned int* primIDs, size_t numPrimIDs)
+      {
+        vbool<K> valid = valid_i;
+        
+        /* perform ray mask test */
+#if defined(EMBREE_RAY_MASK)
+        valid &= (ray.mask & accel->mask) != 0;
+        if (none(valid)) return;
+#endif
+        accel->intersect(valid,ray,geomID,primIDs,numPrimIDs,context,&reportIntersection1);
+      }
+
+      static __forceinline vbool<K> occludedBatch(const vbool<K>& valid_i, const Precalculations& pre, RayK<K>& ray, IntersectContext* context, AccelSet* accel, unsigned int geomID, const unsigned int* primIDs, size_t numPrimIDs)
+      {
+        vbool<K> valid = valid_i;
+        
+        /* perform ray mask test */
+#if defined(EMBREE_RAY_MASK)
+        valid &= (ray.mask & accel->mask) != 0;
+        if (none(valid)) return false;
+#endif
+        accel->occluded(valid,ray,geomID,primIDs,numPrimIDs,context,&reportOcclusion1);
+        return ray.tfar < 0.0f;
+      }
       
       static __forceinline void intersect(Precalculations& pre, RayHitK<K>& ray, size_t k, IntersectContext* context, const Primitive& prim) {
         intersect(vbool<K>(1<<int(k)),pre,ray,context,prim);
@@ -116,6 +178,138 @@ namespace embree
       }
     };
 
+    /*! Intersects the objects of a leaf. Consecutive objects of a user
+     *  geometry with batch callbacks are passed to a single callback
+     *  invocation. */
+    template<bool mblur>
+    struct ObjectArrayIntersector1 : public ArrayIntersector1<ObjectIntersector1<mblur>>
+    {
+      typedef ObjectIntersector1<mblur> Intersector;
+      typedef typename Intersector::Primitive Primitive;
+      typedef typename Intersector::Precalculations Precalculations;
+
+      template<int N, int Nx, bool robust>
+      static __forceinline void intersect(const Accel::Intersectors* This, Precalculations& pre, RayHit& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,Nx,robust> &tray, size_t& lazy_node)
+      {
+        for (size_t i=0; i<num; )
+        {
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          if (likely(!accel->intersectorN.intersectBatch)) {
+            Intersector::intersect(pre,ray,context,prim[i++]);
+            continue;
+          }
+          unsigned int primIDs[MAX_OBJECT_BATCH_SIZE];
+          const size_t n = gatherObjectBatch(&prim[i],num-i,primIDs);
+          Intersector::intersectBatch(pre,ray,context,accel,prim[i].geomID(),primIDs,n);
+          i += n;
+        }
+      }
+
+      template<int N, int Nx, bool robust>
+      static __forceinline bool occluded(const Accel::Intersectors* This, Precalculations& pre, Ray& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,Nx,robust> &tray, size_t& lazy_node)
+      {
+        for (size_t i=0; i<num; )
+        {
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          if (likely(!accel->intersectorN.occludedBatch)) {
+            if (Intersector::occluded(pre,ray,context,prim[i++]))
+              return true;
+            continue;
+          }
+          unsigned int primIDs[MAX_OBJECT_BATCH_SIZE];
+          const size_t n = gatherObjectBatch(&prim[i],num-i,primIDs);
+          if (Intersector::occludedBatch(pre,ray,context,accel,prim[i].geomID(),primIDs,n))
+            return true;
+          i += n;
+        }
+        return false;
+      }
+    };
+
+    template<int K, bool mblur>
+    struct ObjectArrayIntersectorK : public ArrayIntersectorK_1<K,ObjectIntersectorK<K,mblur>>
+    {
+      typedef ObjectIntersectorK<K,mblur> Intersector;
+      typedef typename Intersector::Primitive Primitive;
+      typedef typename Intersector::Precalculations Precalculations;
+
+      template<bool robust>
+      static __forceinline void intersect(const vbool<K>& valid, const Accel::Intersectors* This, Precalculations& pre, RayHitK<K>& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRayK<K, robust> &tray, size_t& lazy_node)
+      {
+        for (size_t i=0; i<num; )
+        {
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          if (likely(!accel->intersectorN.intersectBatch)) {
+            Intersector::intersect(valid,pre,ray,context,prim[i++]);
+            continue;
+          }
+          unsigned int primIDs[MAX_OBJECT_BATCH_SIZE];
+          const size_t n = gatherObjectBatch(&prim[i],num-i,primIDs);
+          Intersector::intersectBatch(valid,pre,ray,context,accel,prim[i].geomID(),primIDs,n);
+          i += n;
+        }
+      }
+
+      template<bool robust>
+      static __forceinline vbool<K> occluded(const vbool<K>& valid, const Accel::Intersectors* This, Precalculations& pre, RayK<K>& ray, IntersectContext* context, const Primitive* prim, size_t num, const TravRayK<K, robust> &tray, size_t& lazy_node)
+      {
+        vbool<K> valid0 = valid;
+        for (size_t i=0; i<num; )
+        {
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          if (likely(!accel->intersectorN.occludedBatch)) {
+            valid0 &= !Intersector::occluded(valid0,pre,ray,context,prim[i++]);
+          }
+          else {
+            unsigned int primIDs[MAX_OBJECT_BATCH_SIZE];
+            const size_t n = gatherObjectBatch(&prim[i],num-i,primIDs);
+            valid0 &= !Intersector::occludedBatch(valid0,pre,ray,context,accel,prim[i].geomID(),primIDs,n);
+            i += n;
+          }
+          if (none(valid0)) break;
+        }
+        return !valid0;
+      }
+
+      template<int N, int Nx, bool robust>
+      static __forceinline void intersect(const Accel::Intersectors* This, Precalculations& pre, RayHitK<K>& ray, size_t k, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,Nx,robust> &tray, size_t& lazy_node)
+      {
+        for (size_t i=0; i<num; )
+        {
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          if (likely(!accel->intersectorN.intersectBatch)) {
+            Intersector::intersect(pre,ray,k,context,prim[i++]);
+            continue;
+          }
+          unsigned int primIDs[MAX_OBJECT_BATCH_SIZE];
+          const size_t n = gatherObjectBatch(&prim[i],num-i,primIDs);
+          Intersector::intersectBatch(vbool<K>(1<<int(k)),pre,ray,context,accel,prim[i].geomID(),primIDs,n);
+          i += n;
+        }
+      }
+
+      template<int N, int Nx, bool robust>
+      static __forceinline bool occluded(const Accel::Intersectors* This, Precalculations& pre, RayK<K>& ray, size_t k, IntersectContext* context, const Primitive* prim, size_t num, const TravRay<N,Nx,robust> &tray, size_t& lazy_node)
+      {
+        for (size_t i=0; i<num; )
+        {
+          AccelSet* accel = (AccelSet*) context->scene->get(prim[i].geomID());
+          if (likely(!accel->intersectorN.occludedBatch)) {
+            if (Intersector::occluded(pre,ray,k,context,prim[i++]))
+              return true;
+            continue;
+          }
+          unsigned int primIDs[MAX_OBJECT_BATCH_SIZE];
+          const size_t n = gatherObjectBatch(&prim[i],num-i,primIDs);
+          Intersector::occludedBatch(vbool<K>(1<<int(k)),pre,ray,context,accel,prim[i].geomID(),primIDs,n);
+          if (ray.tfar[k] < 0.0f)
+            return true;
+          i += n;
+        }
+        return false;
+      }
+    };
+
     typedef ObjectIntersectorK<4,false>  ObjectIntersector4;
     typedef ObjectIntersectorK<8,false>  ObjectIntersector8;
     typedef ObjectIntersectorK<16,false> ObjectIntersector16;
@@ -61,30 +61,30 @@ namespace embree
           /* first quad always valid */
           const size_t vtxID00 = g.startVtxID + x() + y() * g.lineVtxOffset;
           const size_t vtxID01 = vtxID00 + 1;
-          const vfloat4 vtx00  = vfloat4::loadu(mesh->vertexPtr(vtxID00));
-          const vfloat4 vtx01  = vfloat4::loadu(mesh->vertexPtr(vtxID01));
+          const vfloat4 vtx00  = mesh->loadVertex(vtxID00);
+          const vfloat4 vtx01  = mesh->loadVertex(vtxID01);
           const size_t vtxID10 = vtxID00 + g.lineVtxOffset;
           const size_t vtxID11 = vtxID01 + g.lineVtxOffset;
-          const vfloat4 vtx10  = vfloat4::loadu(mesh->vertexPtr(vtxID10));
-          const vfloat4 vtx11  = vfloat4::loadu(mesh->vertexPtr(vtxID11));
+          const vfloat4 vtx10  = mesh->loadVertex(vtxID10);
+          const vfloat4 vtx11  = mesh->loadVertex(vtxID11);
 
           /* deltaX => vtx02, vtx12 */
           const size_t deltaX  = invalid3x3X() ? 0 : 1;
           const size_t vtxID02 = vtxID01 + deltaX;       
-          const vfloat4 vtx02  = vfloat4::loadu(mesh->vertexPtr(vtxID02));
+          const vfloat4 vtx02  = mesh->loadVertex(vtxID02);
           const size_t vtxID12 = vtxID11 + deltaX;       
-          const vfloat4 vtx12  = vfloat4::loadu(mesh->vertexPtr(vtxID12));
+          const vfloat4 vtx12  = mesh->loadVertex(vtxID12);
 
           /* deltaY => vtx20, vtx21 */
           const size_t deltaY  = invalid3x3Y() ? 0 : g.lineVtxOffset;
           const size_t vtxID20 = vtxID10 + deltaY;
           const size_t vtxID21 = vtxID11 + deltaY;
-          const vfloat4 vtx20  = vfloat4::loadu(mesh->vertexPtr(vtxID20));
-          const vfloat4 vtx21  = vfloat4::loadu(mesh->vertexPtr(vtxID21));
+          const vfloat4 vtx20  = mesh->loadVertex(vtxID20);
+          const vfloat4 vtx21  = mesh->loadVertex(vtxID21);
 
           /* deltaX/deltaY => vtx22 */
           const size_t vtxID22 = vtxID11 + deltaX + deltaY;       
-          const vfloat4 vtx22  = vfloat4::loadu(mesh->vertexPtr(vtxID22));
+          const vfloat4 vtx22  = mesh->loadVertex(vtxID22);
 
           transpose(vtx00,vtx01,vtx11,vtx10,p0.x,p0.y,p0.z);
           transpose(vtx01,vtx02,vtx12,vtx11,p1.x,p1.y,p1.z);
@@ -95,8 +95,8 @@ namespace embree
         template<typename T>
         __forceinline vfloat4 getVertexMB(const GridMesh* const mesh, const size_t offset, const size_t itime, const float ftime) const
         {
-          const T v0 = T::loadu(mesh->vertexPtr(offset,itime+0));
-          const T v1 = T::loadu(mesh->vertexPtr(offset,itime+1));
+          const T v0 = T(mesh->loadVertex(offset,itime+0));
+          const T v1 = T(mesh->loadVertex(offset,itime+1));
           return lerp(v0,v1,ftime);
         }
 
@@ -181,30 +181,30 @@ namespace embree
           /* first quad always valid */
           const size_t vtxID00 = g.startVtxID + x() + y() * g.lineVtxOffset;
           const size_t vtxID01 = vtxID00 + 1;
-          const Vec3fa vtx00  = Vec3fa::loadu(mesh->vertexPtr(vtxID00));
-          const Vec3fa vtx01  = Vec3fa::loadu(mesh->vertexPtr(vtxID01));
+          const Vec3fa vtx00  = Vec3fa(mesh->loadVertex(vtxID00));
+          const Vec3fa vtx01  = Vec3fa(mesh->loadVertex(vtxID01));
           const size_t vtxID10 = vtxID00 + g.lineVtxOffset;
           const size_t vtxID11 = vtxID01 + g.lineVtxOffset;
-          const Vec3fa vtx10  = Vec3fa::loadu(mesh->vertexPtr(vtxID10));
-          const Vec3fa vtx11  = Vec3fa::loadu(mesh->vertexPtr(vtxID11));
+          const Vec3fa vtx10  = Vec3fa(mesh->loadVertex(vtxID10));
+          const Vec3fa vtx11  = Vec3fa(mesh->loadVertex(vtxID11));
 
           /* deltaX => vtx02, vtx12 */
           const size_t deltaX  = invalid3x3X() ? 0 : 1;
           const size_t vtxID02 = vtxID01 + deltaX;       
-          const Vec3fa vtx02  = Vec3fa::loadu(mesh->vertexPtr(vtxID02));
+          const Vec3fa vtx02  = Vec3fa(mesh->loadVertex(vtxID02));
           const size_t vtxID12 = vtxID11 + deltaX;       
-          const Vec3fa vtx12  = Vec3fa::loadu(mesh->vertexPtr(vtxID12));
+          const Vec3fa vtx12  = Vec3fa(mesh->loadVertex(vtxID12));
 
           /* deltaY => vtx20, vtx21 */
           const size_t deltaY  = invalid3x3Y() ? 0 : g.lineVtxOffset;
           const size_t vtxID20 = vtxID10 + deltaY;
           const size_t vtxID21 = vtxID11 + deltaY;
-          const Vec3fa vtx20  = Vec3fa::loadu(mesh->vertexPtr(vtxID20));
-          const Vec3fa vtx21  = Vec3fa::loadu(mesh->vertexPtr(vtxID21));
+          const Vec3fa vtx20  = Vec3fa(mesh->loadVertex(vtxID20));
+          const Vec3fa vtx21  = Vec3fa(mesh->loadVertex(vtxID21));
 
           /* deltaX/deltaY => vtx22 */
           const size_t vtxID22 = vtxID11 + deltaX + deltaY;       
-          const Vec3fa vtx22  = Vec3fa::loadu(mesh->vertexPtr(vtxID22));
+          const Vec3fa vtx22  = Vec3fa(mesh->loadVertex(vtxID22));
 
           vtx[ 0] = vtx00; vtx[ 1] = vtx01; vtx[ 2] = vtx11; vtx[ 3] = vtx10;
           vtx[ 4] = vtx01; vtx[ 5] = vtx02; vtx[ 6] = vtx12; vtx[ 7] = vtx11;
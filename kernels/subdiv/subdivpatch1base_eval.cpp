@@ -174,39 +174,64 @@ namespace embree
         if (unlikely(patch.needsStitching()))
           stitchUVGrid(patch.level,swidth,sheight,x0,y0,dwidth,dheight,grid_u,grid_v);
       
+        /* normals are only required for displacement */
+        const bool displ = geom->displFunc;
+        const unsigned N = displ ? M : 0;
+        dynamic_large_stack_array(float,grid_Ng_x,N,32*32*sizeof(float));
+        dynamic_large_stack_array(float,grid_Ng_y,N,32*32*sizeof(float));
+        dynamic_large_stack_array(float,grid_Ng_z,N,32*32*sizeof(float));
+
         /* iterates over all grid points */
         for (unsigned i=0; i<grid_size_simd_blocks; i++)
         {
           const vfloatx u = vfloatx::load(&grid_u[i*VSIZEX]);
           const vfloatx v = vfloatx::load(&grid_v[i*VSIZEX]);
-          Vec3vfx vtx = patchEval(patch,u,v);
+          const Vec3vfx vtx = patchEval(patch,u,v);
         
-          /* evaluate displacement function */
-          if (unlikely(geom->displFunc != nullptr))
+          if (unlikely(displ))
           {
             const Vec3vfx normal = normalize_safe(patchNormal(patch, u, v));
-            RTCDisplacementFunctionNArguments args;
-            args.geometryUserPtr = geom->userPtr;
-            args.geometry = (RTCGeometry)geom;
-            //args.geomID = patch.geomID();
-            args.primID = patch.primID();
-            args.timeStep = patch.time();
-            args.u = &u[0];
-            args.v = &v[0];
-            args.Ng_x = &normal.x[0];
-            args.Ng_y = &normal.y[0];
-            args.Ng_z = &normal.z[0];
-            args.P_x = &vtx.x[0];
-            args.P_y = &vtx.y[0];
-            args.P_z = &vtx.z[0];
-            args.N = VSIZEX;
-            geom->displFunc(&args);
+            vfloatx::store(&grid_Ng_x[i*VSIZEX],normal.x);
+            vfloatx::store(&grid_Ng_y[i*VSIZEX],normal.y);
+            vfloatx::store(&grid_Ng_z[i*VSIZEX],normal.z);
           }
 
           vfloatx::store(&grid_x[i*VSIZEX],vtx.x);
           vfloatx::store(&grid_y[i*VSIZEX],vtx.y);
           vfloatx::store(&grid_z[i*VSIZEX],vtx.z);
         }
+
+        /* call displacement shader once for the entire grid */
+        if (unlikely(displ))
+        {
+          RTCDisplacementFunctionNArguments args;
+          args.geometryUserPtr = geom->userPtr;
+          args.geometry = (RTCGeometry)geom;
+          //args.geomID = patch.geomID();
+          args.primID = patch.primID();
+          args.timeStep = patch.time();
+          args.u = grid_u;
+          args.v = grid_v;
+          args.Ng_x = grid_Ng_x;
+          args.Ng_y = grid_Ng_y;
+          args.Ng_z = grid_Ng_z;
+          args.P_x = grid_x;
+          args.P_y = grid_y;
+          args.P_z = grid_z;
+          args.N = dwidth*dheight;
+          geom->displFunc(&args);
+
+          /* set last elements in x,y,z array to last displaced point */
+          const float last_x = grid_x[dwidth*dheight-1];
+          const float last_y = grid_y[dwidth*dheight-1];
+          const float last_z = grid_z[dwidth*dheight-1];
+          for (unsigned i=dwidth*dheight;i<grid_size_simd_blocks*VSIZEX;i++)
+          {
+            grid_x[i] = last_x;
+            grid_y[i] = last_y;
+            grid_z[i] = last_z;
+          }
+        }
       }
     }
 
@@ -8,27 +8,19 @@
 
 namespace embree
 {
-  SharedLazyTessellationCache SharedLazyTessellationCache::sharedLazyTessellationCache;
+  __thread SharedLazyTessellationCache::ThreadCacheSlot SharedLazyTessellationCache::t_slots[NUM_THREAD_CACHE_SLOTS];
+  __thread size_t SharedLazyTessellationCache::t_next_slot = 0;
+  __thread size_t SharedLazyTessellationCache::t_threadID = 0;
 
-  __thread ThreadWorkState* SharedLazyTessellationCache::init_t_state = nullptr;
-  ThreadWorkState* SharedLazyTessellationCache::current_t_state = nullptr;
+  /* cache IDs are never reused, thus thread slots of destroyed caches never match */
+  static std::atomic<size_t> g_next_cache_id(1);
 
-  void resizeTessellationCache(size_t new_size)
-  {    
-    if (new_size >= SharedLazyTessellationCache::MAX_TESSELLATION_CACHE_SIZE)
-      new_size = SharedLazyTessellationCache::MAX_TESSELLATION_CACHE_SIZE;
-    if (SharedLazyTessellationCache::sharedLazyTessellationCache.getSize() != new_size) 
-      SharedLazyTessellationCache::sharedLazyTessellationCache.realloc(new_size);    
-  }
+  /* thread IDs identify the work states of a thread, 0 marks threads without ID */
+  static std::atomic<size_t> g_next_thread_id(1);
 
-  void resetTessellationCache()
-  {
-    //SharedLazyTessellationCache::sharedLazyTessellationCache.addCurrentIndex(SharedLazyTessellationCache::NUM_CACHE_SEGMENTS);
-    SharedLazyTessellationCache::sharedLazyTessellationCache.reset();
-  }
-  
   SharedLazyTessellationCache::SharedLazyTessellationCache()
   {
+    cacheID = g_next_cache_id++;
     size = 0;
     data = nullptr;
     hugepages = false;
@@ -36,15 +28,14 @@ namespace embree
     localTime              = NUM_CACHE_SEGMENTS;
     next_block             = 0;
     numRenderThreads       = 0;
+    evictions              = 0;
 #if FORCE_SIMPLE_FLUSH == 1
     switch_block_threshold = maxBlocks;
 #else
     switch_block_threshold = maxBlocks/NUM_CACHE_SEGMENTS;
 #endif
     threadWorkState     = new ThreadWorkState[NUM_PREALLOC_THREAD_WORK_STATES];
-
-    //reset_state.reset();
-    //linkedlist_mtx.reset();
+    current_t_state     = nullptr;
   }
 
   SharedLazyTessellationCache::~SharedLazyTessellationCache() 
@@ -57,19 +48,38 @@ namespace embree
     }
 
     delete[] threadWorkState;
+    if (data) os_free(data,size,hugepages);
   }
 
-  void SharedLazyTessellationCache::getNextRenderThreadWorkState() 
+  ThreadWorkState* SharedLazyTessellationCache::getThreadWorkState() 
   {
-    const size_t id = numRenderThreads.fetch_add(1); 
-    if (id >= NUM_PREALLOC_THREAD_WORK_STATES) init_t_state = new ThreadWorkState(true);
-    else                                       init_t_state = &threadWorkState[id];
-    
-    /* critical section for updating link list with new thread state */
+    if (t_threadID == 0)
+      t_threadID = g_next_thread_id++;
+
+    /* a thread that uses more caches than it has slots for reuses its work state of this cache */
     linkedlist_mtx.lock();
-    init_t_state->next = current_t_state;
-    current_t_state = init_t_state;
+    ThreadWorkState* t_state = current_t_state;
+    while (t_state && t_state->threadID != t_threadID)
+      t_state = t_state->next;
+
+    if (t_state == nullptr)
+    {
+      const size_t id = numRenderThreads.fetch_add(1); 
+      if (id >= NUM_PREALLOC_THREAD_WORK_STATES) t_state = new ThreadWorkState(true);
+      else                                       t_state = &threadWorkState[id];
+      t_state->threadID = t_threadID;
+
+      /* link new thread state into the list */
+      t_state->next = current_t_state;
+      current_t_state = t_state;
+    }
     linkedlist_mtx.unlock();
+
+    /* replace the least recently added slot of this thread */
+    ThreadCacheSlot& slot = t_slots[t_next_slot++ % NUM_THREAD_CACHE_SLOTS];
+    slot.cacheID = cacheID;
+    slot.state = t_state;
+    return t_state;
   }
 
   void SharedLazyTessellationCache::waitForUsersLessEqual(ThreadWorkState *const t_state,
@@ -101,7 +111,7 @@ namespace embree
         
         /* switch to the next segment */
         addCurrentIndex();
-        CACHE_STATS(PRINT("RESET TESS CACHE"));
+        evictions++;
         
 #if FORCE_SIMPLE_FLUSH == 1
         next_block = 0;
@@ -112,9 +122,7 @@ namespace embree
         switch_block_threshold = next_block + (maxBlocks/NUM_CACHE_SEGMENTS);
         assert( switch_block_threshold <= maxBlocks );
 #endif
-        
-        CACHE_STATS(SharedTessellationCacheStats::cache_flushes++);
-        
+
         /* release all blocked threads */
         
         for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next)
@@ -218,30 +226,57 @@ namespace embree
   ////////////////////////////////////////////////////////////////////////////////////////////////////////////
   ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-  std::atomic<size_t> SharedTessellationCacheStats::cache_accesses(0);
-  std::atomic<size_t> SharedTessellationCacheStats::cache_hits(0);
-  std::atomic<size_t> SharedTessellationCacheStats::cache_misses(0);
-  std::atomic<size_t> SharedTessellationCacheStats::cache_flushes(0);  
-  SpinLock   SharedTessellationCacheStats::mtx;  
-  size_t SharedTessellationCacheStats::cache_num_patches(0);
+  void SharedLazyTessellationCache::resize(size_t new_size)
+  {
+    if (new_size >= MAX_TESSELLATION_CACHE_SIZE)
+      new_size = MAX_TESSELLATION_CACHE_SIZE;
+    if (getSize() != new_size)
+      realloc(new_size);
+  }
+
+  size_t SharedLazyTessellationCache::numThreadWorkStates()
+  {
+    size_t N = 0;
+    linkedlist_mtx.lock();
+    for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next) N++;
+    linkedlist_mtx.unlock();
+    return N;
+  }
+
+  SharedLazyTessellationCache::Statistics SharedLazyTessellationCache::getStatistics()
+  {
+    Statistics stats;
+    linkedlist_mtx.lock();
+    for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next) {
+      stats.hits   += t->hits.load(std::memory_order_relaxed);
+      stats.misses += t->misses.load(std::memory_order_relaxed);
+    }
+    linkedlist_mtx.unlock();
+    stats.evictions = evictions;
+    return stats;
+  }
 
-  void SharedTessellationCacheStats::printStats()
+  void SharedLazyTessellationCache::clearStatistics()
   {
-    PRINT(cache_accesses);
-    PRINT(cache_misses);
-    PRINT(cache_hits);
-    PRINT(cache_flushes);
-    PRINT(100.0f * cache_hits / cache_accesses);
-    assert(cache_hits + cache_misses == cache_accesses);
-    PRINT(cache_num_patches);
+    linkedlist_mtx.lock();
+    for (ThreadWorkState *t=current_t_state;t!=nullptr;t=t->next) {
+      t->hits.store(0,std::memory_order_relaxed);
+      t->misses.store(0,std::memory_order_relaxed);
+    }
+    linkedlist_mtx.unlock();
+    evictions = 0;
   }
 
-  void SharedTessellationCacheStats::clearStats()
+  void SharedLazyTessellationCache::printStatistics()
   {
-    SharedTessellationCacheStats::cache_accesses  = 0;
-    SharedTessellationCacheStats::cache_hits      = 0;
-    SharedTessellationCacheStats::cache_misses    = 0;
-    SharedTessellationCacheStats::cache_flushes   = 0;
+    const Statistics stats = getStatistics();
+    const size_t accesses = stats.hits+stats.misses;
+    std::cout << "tessellation cache statistics:" << std::endl;
+    std::cout << "  size      = " << float(size)*1E-6 << " MB" << std::endl;
+    std::cout << "  accesses  = " << accesses << std::endl;
+    std::cout << "  hits      = " << stats.hits << " (" << (accesses ? 100.0f*stats.hits/accesses : 0.0f) << "%)" << std::endl;
+    std::cout << "  misses    = " << stats.misses << std::endl;
+    std::cout << "  evictions = " << stats.evictions << std::endl;
   }
 
   struct cache_regression_test : public RegressionTest
@@ -251,6 +286,7 @@ namespace embree
     std::atomic<int> threadIDCounter;
     static const size_t numEntries = 4*1024;
     SharedLazyTessellationCache::CacheEntry entry[numEntries];
+    std::unique_ptr<SharedLazyTessellationCache> cache;
 
     cache_regression_test() 
       : RegressionTest("cache_regression_test"), numFailed(0), threadIDCounter(0)
@@ -261,7 +297,8 @@ namespace embree
     static void thread_alloc(cache_regression_test* This)
     {
       int threadID = This->threadIDCounter++;
-      size_t maxN = SharedLazyTessellationCache::sharedLazyTessellationCache.maxAllocSize()/4;
+      SharedLazyTessellationCache& cache = *This->cache;
+      size_t maxN = cache.maxAllocSize()/4;
       This->barrier.wait();
 
       for (size_t j=0; j<100000; j++)
@@ -269,14 +306,14 @@ namespace embree
         size_t elt = (threadID+j)%numEntries;
         size_t N = min(1+10*(elt%1000),maxN);
           
-        volatile int* data = (volatile int*) SharedLazyTessellationCache::lookup(This->entry[elt],0,[&] () {
-            int* data = (int*) SharedLazyTessellationCache::sharedLazyTessellationCache.malloc(4*N);
+        volatile int* data = (volatile int*) cache.lookup(This->entry[elt],0,[&] () {
+            int* data = (int*) cache.malloc(4*N);
             for (size_t k=0; k<N; k++) data[k] = (int)elt;
             return data;
           });
         
         if (data == nullptr) {
-          SharedLazyTessellationCache::sharedLazyTessellationCache.unlock();
+          cache.unlock();
           This->numFailed++;
           continue;
         }
@@ -289,7 +326,7 @@ namespace embree
           }
         }
         
-        SharedLazyTessellationCache::sharedLazyTessellationCache.unlock();
+        cache.unlock();
       }
       This->barrier.wait();
     }
@@ -299,6 +336,10 @@ namespace embree
       numFailed.store(0);
 
       size_t numThreads = getNumberOfLogicalThreads();
+      cache.reset(new SharedLazyTessellationCache);
+      cache->resize(16*1024*1024);
+      for (size_t i=0; i<numEntries; i++)
+        entry[i].tag.reset();
       barrier.init(numThreads+1);
 
       /* create threads */
@@ -314,16 +355,46 @@ namespace embree
       for (size_t i=0; i<numThreads; i++)
         join(threads[i]);
 
+      /* every lookup is either a hit or a miss */
+      const SharedLazyTessellationCache::Statistics stats = cache->getStatistics();
+      if (stats.hits + stats.misses != numThreads*100000)
+        numFailed++;
+
+      /* resetting a different cache must not invalidate entries of this cache */
+      SharedLazyTessellationCache::CacheEntry isolated;
+      size_t numConstructed = 0;
+      auto construct = [&] () { numConstructed++; return (int*) cache->malloc(4); };
+      cache->lookup(isolated,0,construct); cache->unlock();
+      std::unique_ptr<SharedLazyTessellationCache> other(new SharedLazyTessellationCache);
+      other->resize(1024*1024);
+      other->reset();
+      cache->lookup(isolated,0,construct); cache->unlock();
+      if (numConstructed != 1 || other->getStatistics().hits + other->getStatistics().misses != 0)
+        numFailed++;
+
+      /* a thread cycling through more caches than it has slots keeps one work state per cache */
+      std::vector<std::unique_ptr<SharedLazyTessellationCache>> caches(2*SharedLazyTessellationCache::NUM_THREAD_CACHE_SLOTS);
+      std::vector<SharedLazyTessellationCache::CacheEntry> entries(caches.size());
+      for (auto& c : caches) {
+        c.reset(new SharedLazyTessellationCache);
+        c->resize(1024*1024);
+      }
+      for (size_t round=0; round<100; round++) {
+        for (size_t i=0; i<caches.size(); i++) {
+          caches[i]->lookup(entries[i],0,[&] () { return (int*) caches[i]->malloc(4); });
+          caches[i]->unlock();
+        }
+      }
+      for (auto& c : caches) {
+        const SharedLazyTessellationCache::Statistics stats = c->getStatistics();
+        if (c->numThreadWorkStates() != 1 || stats.hits + stats.misses != 100)
+          numFailed++;
+      }
+
+      cache.reset();
       return numFailed == 0;
     }
   };
 
   cache_regression_test cache_regression;
 };
-
-extern "C" void printTessCacheStats()
-{
-  PRINT("SHARED TESSELLATION CACHE");
-  embree::SharedTessellationCacheStats::printStats();
-  embree::SharedTessellationCacheStats::clearStats();
-}
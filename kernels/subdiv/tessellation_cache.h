@@ -10,33 +10,8 @@
 
 #define THREAD_BLOCK_ATOMIC_ADD 4
 
-#if defined(DEBUG)
-#define CACHE_STATS(x) 
-#else
-#define CACHE_STATS(x) 
-#endif
-
 namespace embree
 {
-  class SharedTessellationCacheStats
-  {
-  public:
-    /* stats */
-    static std::atomic<size_t> cache_accesses;
-    static std::atomic<size_t> cache_hits;
-    static std::atomic<size_t> cache_misses;
-    static std::atomic<size_t> cache_flushes;                
-    static size_t        cache_num_patches;
-    __aligned(64) static SpinLock mtx;
-    
-    /* print stats for debugging */                 
-    static void printStats();
-    static void clearStats();
-  };
-  
-  void resizeTessellationCache(size_t new_size);
-  void resetTessellationCache();
-  
  ////////////////////////////////////////////////////////////////////////////////
  ////////////////////////////////////////////////////////////////////////////////
  ////////////////////////////////////////////////////////////////////////////////
@@ -47,10 +22,15 @@ namespace embree
 
    std::atomic<size_t> counter;
    ThreadWorkState* next;
+   size_t threadID;
    bool allocated;
 
+   /* per thread statistics, only written by the owning thread */
+   std::atomic<size_t> hits;
+   std::atomic<size_t> misses;
+
    __forceinline ThreadWorkState(bool allocated = false) 
-     : counter(0), next(nullptr), allocated(allocated) 
+     : counter(0), next(nullptr), threadID(0), allocated(allocated), hits(0), misses(0)
    {
      assert( ((size_t)this % 64) == 0 ); 
    }   
@@ -58,10 +38,12 @@ namespace embree
 
  class __aligned(64) SharedLazyTessellationCache 
  {
+   ALIGNED_CLASS_(64);
  public:
    
    static const size_t NUM_CACHE_SEGMENTS              = 8;
    static const size_t NUM_PREALLOC_THREAD_WORK_STATES = 512;
+   static const size_t NUM_THREAD_CACHE_SLOTS          = 4;
    static const size_t COMMIT_INDEX_SHIFT              = 32+8;
 #if defined(__X86_64__) || defined(__aarch64__)
    static const size_t REF_TAG_MASK                    = 0xffffffffff;
@@ -70,40 +52,55 @@ namespace embree
 #endif
    static const size_t MAX_TESSELLATION_CACHE_SIZE     = REF_TAG_MASK+1;
    static const size_t BLOCK_SIZE                      = 64;
-   
 
-    /*! Per thread tessellation ref cache */
-   static __thread ThreadWorkState* init_t_state;
-   static ThreadWorkState* current_t_state;
-   
-   static __forceinline ThreadWorkState *threadState() 
+   /*! statistics of a single cache */
+   struct Statistics
    {
-     if (unlikely(!init_t_state))
-       /* sets init_t_state, can't return pointer due to macosx icc bug*/
-       SharedLazyTessellationCache::sharedLazyTessellationCache.getNextRenderThreadWorkState();
-     return init_t_state;
+     Statistics () : hits(0), misses(0), evictions(0) {}
+
+     size_t hits;       //!< number of lookups that found a valid entry
+     size_t misses;     //!< number of lookups that had to construct the entry
+     size_t evictions;  //!< number of cache segments evicted to make space for new entries
+   };
+
+   /*! Per thread tessellation ref cache, remembers the work states of the most recently used caches */
+   struct ThreadCacheSlot
+   {
+     size_t cacheID;
+     ThreadWorkState* state;
+   };
+   static __thread ThreadCacheSlot t_slots[NUM_THREAD_CACHE_SLOTS];
+   static __thread size_t t_next_slot;
+   static __thread size_t t_threadID;
+
+   __forceinline ThreadWorkState* threadState() 
+   {
+     for (size_t i=0; i<NUM_THREAD_CACHE_SLOTS; i++)
+       if (likely(t_slots[i].cacheID == cacheID))
+         return t_slots[i].state;
+     return getThreadWorkState();
    }
 
    struct Tag
    {
      __forceinline Tag() : data(0) {}
 
-     __forceinline Tag(void* ptr, size_t combinedTime) { 
-       init(ptr,combinedTime);
+     __forceinline Tag(void* ptr, void* base, size_t combinedTime) { 
+       init(ptr,base,combinedTime);
      }
 
-     __forceinline Tag(size_t ptr, size_t combinedTime) {
-       init((void*)ptr,combinedTime); 
+     __forceinline Tag(size_t ptr, void* base, size_t combinedTime) {
+       init((void*)ptr,base,combinedTime);
      }
 
-     __forceinline void init(void* ptr, size_t combinedTime)
+     __forceinline void init(void* ptr, void* base, size_t combinedTime)
      {
        if (ptr == nullptr) {
          data = 0;
          return;
        }
        int64_t new_root_ref = (int64_t) ptr;
-       new_root_ref -= (int64_t)SharedLazyTessellationCache::sharedLazyTessellationCache.getDataPtr();                                
+       new_root_ref -= (int64_t) base;
        assert( new_root_ref <= (int64_t)REF_TAG_MASK );
        new_root_ref |= (int64_t)combinedTime << COMMIT_INDEX_SHIFT; 
        data = new_root_ref;
@@ -127,11 +124,13 @@ namespace embree
 
  private:
 
+   size_t cacheID;
    float *data;
    bool hugepages;
    size_t size;
    size_t maxBlocks;
    ThreadWorkState *threadWorkState;
+   ThreadWorkState *current_t_state;
       
    __aligned(64) std::atomic<size_t> localTime;
    __aligned(64) std::atomic<size_t> next_block;
@@ -139,15 +138,18 @@ namespace embree
    __aligned(64) SpinLock   linkedlist_mtx;
    __aligned(64) std::atomic<size_t> switch_block_threshold;
    __aligned(64) std::atomic<size_t> numRenderThreads;
-
+   __aligned(64) std::atomic<size_t> evictions;
 
  public:
 
-      
    SharedLazyTessellationCache();
    ~SharedLazyTessellationCache();
 
-   void getNextRenderThreadWorkState();
+   /*! returns the work state of the calling thread, creates one if the thread did not use this cache before */
+   ThreadWorkState* getThreadWorkState();
+
+   /*! returns the number of thread work states of this cache */
+   size_t numThreadWorkStates();
 
    __forceinline size_t maxAllocSize() const {
      return switch_block_threshold;
@@ -166,83 +168,78 @@ namespace embree
 
    __forceinline bool isLocked(ThreadWorkState *const t_state) { return t_state->counter.load() != 0; }
 
-   static __forceinline void lock  () { sharedLazyTessellationCache.lockThread(threadState()); }
-   static __forceinline void unlock() { sharedLazyTessellationCache.unlockThread(threadState()); }
-   static __forceinline bool isLocked() { return sharedLazyTessellationCache.isLocked(threadState()); }
-   static __forceinline size_t getState() { return threadState()->counter.load(); }
-   static __forceinline void lockThreadLoop() { sharedLazyTessellationCache.lockThreadLoop(threadState()); }
-
-   static __forceinline size_t getTCacheTime(const size_t globalTime) {
-     return sharedLazyTessellationCache.getTime(globalTime);
-   }
+   __forceinline void lock  () { lockThread(threadState()); }
+   __forceinline void unlock() { unlockThread(threadState()); }
+   __forceinline bool isLocked() { return isLocked(threadState()); }
+   __forceinline size_t getState() { return threadState()->counter.load(); }
+   __forceinline void lockThreadLoop() { lockThreadLoop(threadState()); }
 
    /* per thread lock */
    __forceinline void lockThreadLoop (ThreadWorkState *const t_state) 
    { 
      while(1)
      {
-       size_t lock = SharedLazyTessellationCache::sharedLazyTessellationCache.lockThread(t_state,1);
+       size_t lock = lockThread(t_state,1);
        if (unlikely(lock >= THREAD_BLOCK_ATOMIC_ADD))
        {
          /* lock failed wait until sync phase is over */
-         sharedLazyTessellationCache.unlockThread(t_state,-1);	       
-         sharedLazyTessellationCache.waitForUsersLessEqual(t_state,0);
+         unlockThread(t_state,-1);	       
+         waitForUsersLessEqual(t_state,0);
        }
        else
          break;
      }
    }
 
-   static __forceinline void* lookup(CacheEntry& entry, size_t globalTime)
+   __forceinline void* lookup(CacheEntry& entry, size_t globalTime)
    {   
      const int64_t subdiv_patch_root_ref = entry.tag.get(); 
-     CACHE_STATS(SharedTessellationCacheStats::cache_accesses++);
      
      if (likely(subdiv_patch_root_ref != 0)) 
      {
-       const size_t subdiv_patch_root = (subdiv_patch_root_ref & REF_TAG_MASK) + (size_t)sharedLazyTessellationCache.getDataPtr();
+       const size_t subdiv_patch_root = (subdiv_patch_root_ref & REF_TAG_MASK) + (size_t)getDataPtr();
        const size_t subdiv_patch_cache_index = extractCommitIndex(subdiv_patch_root_ref);
        
-       if (likely( sharedLazyTessellationCache.validCacheIndex(subdiv_patch_cache_index,globalTime) ))
-       {
-         CACHE_STATS(SharedTessellationCacheStats::cache_hits++);
+       if (likely( validCacheIndex(subdiv_patch_cache_index,globalTime) ))
          return (void*) subdiv_patch_root;
-       }
      }
-     CACHE_STATS(SharedTessellationCacheStats::cache_misses++);
      return nullptr;
    }
 
    template<typename Constructor>
-     static __forceinline auto lookup (CacheEntry& entry, size_t globalTime, const Constructor constructor, const bool before=false) -> decltype(constructor())
+     __forceinline auto lookup (CacheEntry& entry, size_t globalTime, const Constructor constructor, const bool before=false) -> decltype(constructor())
    {
-     ThreadWorkState *t_state = SharedLazyTessellationCache::threadState();
+     ThreadWorkState *t_state = threadState();
 
      while (true)
      {
-       sharedLazyTessellationCache.lockThreadLoop(t_state);
-       void* patch = SharedLazyTessellationCache::lookup(entry,globalTime);
-       if (patch) return (decltype(constructor())) patch;
+       lockThreadLoop(t_state);
+       void* patch = lookup(entry,globalTime);
+       if (patch) {
+         t_state->hits.store(t_state->hits.load(std::memory_order_relaxed)+1,std::memory_order_relaxed);
+         return (decltype(constructor())) patch;
+       }
        
        if (entry.mutex.try_lock())
        {
          if (!validTag(entry.tag,globalTime)) 
          {
-           auto timeBefore = sharedLazyTessellationCache.getTime(globalTime);
+           t_state->misses.store(t_state->misses.load(std::memory_order_relaxed)+1,std::memory_order_relaxed);
+           auto timeBefore = getTime(globalTime);
            auto ret = constructor(); // thread is locked here!
            assert(ret);
            /* this should never return nullptr */
-           auto timeAfter = sharedLazyTessellationCache.getTime(globalTime);
+           auto timeAfter = getTime(globalTime);
            auto time = before ? timeBefore : timeAfter;
            __memory_barrier();
-           entry.tag = SharedLazyTessellationCache::Tag(ret,time);
+           entry.tag = SharedLazyTessellationCache::Tag(ret,getDataPtr(),time);
            __memory_barrier();
            entry.mutex.unlock();
            return ret;
          }
          entry.mutex.unlock();
        }
-       SharedLazyTessellationCache::sharedLazyTessellationCache.unlockThread(t_state);
+       unlockThread(t_state);
      }
    }
    
@@ -261,12 +258,12 @@ namespace embree
    }
 
 
-    static __forceinline bool validTag(const Tag& tag, size_t globalTime)
+    __forceinline bool validTag(const Tag& tag, size_t globalTime)
     {
       const int64_t subdiv_patch_root_ref = tag.get(); 
       if (subdiv_patch_root_ref == 0) return false;
       const size_t subdiv_patch_cache_index = extractCommitIndex(subdiv_patch_root_ref);
-      return sharedLazyTessellationCache.validCacheIndex(subdiv_patch_cache_index,globalTime);
+      return validCacheIndex(subdiv_patch_cache_index,globalTime);
     }
 
    void waitForUsersLessEqual(ThreadWorkState *const t_state,
@@ -283,23 +280,23 @@ namespace embree
      return index;
    }
 
-   static __forceinline void* malloc(const size_t bytes)
+   __forceinline void* malloc(const size_t bytes)
    {
      size_t block_index = -1;
      ThreadWorkState *const t_state = threadState();
      while (true)
      {
-       block_index = sharedLazyTessellationCache.alloc((bytes+BLOCK_SIZE-1)/BLOCK_SIZE);
+       block_index = alloc((bytes+BLOCK_SIZE-1)/BLOCK_SIZE);
        if (block_index == (size_t)-1)
        {
-         sharedLazyTessellationCache.unlockThread(t_state);		  
-         sharedLazyTessellationCache.allocNextSegment();
-         sharedLazyTessellationCache.lockThread(t_state);
+         unlockThread(t_state);		  
+         allocNextSegment();
+         lockThread(t_state);
          continue; 
        }
        break;
      }
-     return sharedLazyTessellationCache.getBlockPtr(block_index);
+     return getBlockPtr(block_index);
    }
 
    __forceinline void *getBlockPtr(const size_t block_index)
@@ -318,8 +315,18 @@ namespace embree
    void allocNextSegment();
    void realloc(const size_t newSize);
 
+   /*! resizes the cache, the size is clamped to the maximal supported size */
+   void resize(size_t newSize);
+
    void reset();
 
-   static SharedLazyTessellationCache sharedLazyTessellationCache;
+   /*! returns the accumulated statistics of all threads */
+   Statistics getStatistics();
+
+   /*! clears all statistics */
+   void clearStatistics();
+
+   /*! prints the statistics */
+   void printStatistics();
  };
 }
@@ -0,0 +1,322 @@
+#!/usr/bin/python
+
+## Copyright 2009-2020 Intel Corporation
+## SPDX-License-Identifier: Apache-2.0
+
+# Runs the tutorials in benchmark mode over a matrix of scenes, build
+# qualities, ISAs, thread counts, and ray types, stores the results as
+# JSON, and compares a set of results against a stored baseline.
+#
+#   benchmark_suite.py run --models models.txt --bin build --isa sse4.2,avx2 \
+#       --threads 1,0 --quality low,high --output current.json
+#   benchmark_suite.py print current.json
+#   benchmark_suite.py compare baseline.json current.json --threshold 5 \
+#       --metric-threshold build_mprims_per_s=10
+#
+# The compare command returns a non-zero exit code if any metric
+# regressed by more than its threshold.
+
+import sys
+import os
+import json
+import math
+import time
+import platform
+import argparse
+import subprocess
+
+########################## configuration ##########################
+
+# ray types map to a tutorial and its command line arguments
+rayTypes = {
+  'primary_coherent'   : ('viewer',        ['--shader', 'eyelight', '--coherent']),
+  'diffuse_incoherent' : ('pathtracer',    ['--incoherent', '--ambientlight', '1', '1', '1']),
+  'shadow'             : ('viewer',        ['--shader', 'occlusion']),
+  'packet'             : ('viewer_ispc',   ['--shader', 'eyelight', '--coherent']),
+  'stream'             : ('viewer_stream', ['--coherent'])
+}
+
+defaultRayTypes = ['primary_coherent', 'diffuse_incoherent', 'shadow', 'packet', 'stream']
+
+# metrics extracted from the tutorial output, True if higher values are better
+metrics = {
+  'fps'                : True,
+  'mrayps'             : True,
+  'build_time'         : False,
+  'build_mprims_per_s' : True,
+  'bvh_bytes'          : False,
+  'sah'                : False
+}
+
+percentiles = [5, 50, 95, 99]
+
+########################## statistics ##########################
+
+def percentile(sortedValues,p):
+  if len(sortedValues) == 0: return 0.0
+  x = (len(sortedValues)-1)*p/100.0
+  i = int(math.floor(x))
+  j = min(i+1,len(sortedValues)-1)
+  return sortedValues[i] + (sortedValues[j]-sortedValues[i])*(x-i)
+
+def statistics(values):
+  values = sorted(values)
+  n = len(values)
+  mean = sum(values)/n
+  var = sum((v-mean)*(v-mean) for v in values)/(n-1) if n > 1 else 0.0
+  stat = {
+    'samples' : n,
+    'mean'    : mean,
+    'stddev'  : math.sqrt(var),
+    'min'     : values[0],
+    'max'     : values[-1]
+  }
+  for p in percentiles:
+    stat['p' + str(p)] = percentile(values,p)
+  return stat
+
+########################## data extraction ##########################
+
+def extract(output,values):
+  build_time = 0.0
+  build_prims = 0.0
+  bvh_bytes = 0.0
+  sah = 0.0
+  builds = 0
+  for line in output.splitlines():
+    tokens = line.split()
+    if len(tokens) == 0: continue
+    if tokens[0] == 'BENCHMARK_BUILD':
+      dt = float(tokens[1])
+      build_time  += dt
+      build_prims += float(tokens[2])*dt
+      sah         += float(tokens[3])
+      bvh_bytes   += float(tokens[4])
+      builds += 1
+    elif tokens[0] == 'BENCHMARK_RENDER_FRAMES':
+      values['fps'] += [float(t) for t in tokens[1:]]
+    elif tokens[0] == 'BENCHMARK_RENDER_MRAYPS_FRAMES':
+      values['mrayps'] += [float(t) for t in tokens[1:]]
+    elif line.startswith('Embree Ray Tracing Kernels '):
+      values['version'] = line[len('Embree Ray Tracing Kernels '):].strip()
+
+  if builds > 0:
+    values['build_time'].append(build_time)
+    values['bvh_bytes'].append(bvh_bytes)
+    values['sah'].append(sah)
+    if build_time > 0.0:
+      values['build_mprims_per_s'].append(1E-6*build_prims/build_time)
+
+########################## running ##########################
+
+def readModelsFile(models_file):
+  models = []
+  path, basename = os.path.split(models_file)
+  with open(models_file, 'r') as f:
+    for line in f.readlines():
+      line = line.strip()
+      if line == "": continue
+      if line.startswith("#"): continue
+      (name,model) = line.split(None,1)
+      models += [(name,os.path.join(path,model.strip()))]
+  return models
+
+def splitList(s):
+  return [x.strip() for x in s.split(',') if x.strip() != '']
+
+def configName(config):
+  return '/'.join([config['scene'], config['ray_type'], 'isa=' + config['isa'],
+                   'quality=' + config['quality'], 'threads=' + config['threads']])
+
+def rtcoreConfig(config,extra):
+  rtcore = ['verbose=1']
+  if config['isa']     != 'default': rtcore.append('isa=' + config['isa'])
+  if config['quality'] != 'default': rtcore.append('quality=' + config['quality'])
+  if config['threads'] != 'default': rtcore.append('threads=' + config['threads'])
+  if extra: rtcore.append(extra)
+  return ','.join(rtcore)
+
+def runConfig(args,config,model):
+  (tutorial,tutorialArgs) = rayTypes[config['ray_type']]
+  command = [os.path.join(args.bin,tutorial), '-c' if model.endswith('.ecs') else '-i', model] + tutorialArgs
+  command += ['--size', str(args.size[0]), str(args.size[1])]
+  command += ['--rtcore', rtcoreConfig(config,args.rtcore)]
+  command += ['--benchmark', str(args.benchmark[0]), str(args.benchmark[1])]
+
+  values = dict((m,[]) for m in metrics)
+  values['version'] = ''
+  for r in range(args.repeat):
+    try:
+      output = subprocess.check_output(command, stderr=subprocess.STDOUT)
+    except subprocess.CalledProcessError as e:
+      sys.stderr.write('failed: ' + ' '.join(command) + '\n' + e.output.decode('utf-8','replace'))
+      return None
+    except OSError as e:
+      sys.stderr.write('cannot execute ' + command[0] + ': ' + str(e) + '\n')
+      return None
+    extract(output.decode('utf-8','replace'),values)
+
+  result = dict(config)
+  result['name'] = configName(config)
+  result['command'] = ' '.join(command)
+  result['version'] = values['version']
+  result['metrics'] = {}
+  for m in metrics:
+    if len(values[m]) > 0:
+      result['metrics'][m] = statistics(values[m])
+  return result
+
+def run(args):
+  models = readModelsFile(args.models)
+  for r in args.rays:
+    if not r in rayTypes:
+      sys.stderr.write('unknown ray type ' + r + ', valid types are: ' + ', '.join(sorted(rayTypes.keys())) + '\n')
+      sys.exit(1)
+
+  results = []
+  for (modelname,model) in models:
+    for ray in args.rays:
+      for isa in args.isa:
+        for quality in args.quality:
+          for threads in args.threads:
+            config = { 'scene' : modelname, 'ray_type' : ray, 'isa' : isa, 'quality' : quality, 'threads' : threads }
+            sys.stdout.write('  ' + '{0:<80}'.format(configName(config)) + ' | ')
+            sys.stdout.flush()
+            result = runConfig(args,config,model)
+            if result is None:
+              sys.stdout.write('failed\n')
+              continue
+            results.append(result)
+            printResult(result)
+
+  report = {
+    'format'    : 'embree-benchmark-suite',
+    'version'   : 1,
+    'date'      : time.strftime('%Y-%m-%dT%H:%M:%S'),
+    'host'      : { 'node' : platform.node(), 'system' : platform.system(), 'machine' : platform.machine(), 'processor' : platform.processor() },
+    'settings'  : { 'benchmark' : args.benchmark, 'repeat' : args.repeat, 'size' : args.size, 'rtcore' : args.rtcore },
+    'results'   : results
+  }
+  with open(args.output,'w') as f:
+    json.dump(report,f,indent=2,sort_keys=True)
+  print('results written to ' + args.output)
+
+########################## printing ##########################
+
+def printResult(result):
+  m = result['metrics']
+  line = ''
+  if 'build_mprims_per_s' in m:
+    line += (' %#8.2f M/s' % m['build_mprims_per_s']['mean'])
+    line += (' %#6.1f MB' % (1E-6*m['bvh_bytes']['mean']))
+  if 'fps' in m:
+    line += (' %#8.3f fps' % m['fps']['mean'])
+    line += (' +/-%#6.2f%%' % (100.0*m['fps']['stddev']/max(m['fps']['mean'],1E-9)))
+    line += (' p5 %#8.3f p95 %#8.3f' % (m['fps']['p5'], m['fps']['p95']))
+  print(line)
+
+def load(fileName):
+  with open(fileName,'r') as f:
+    report = json.load(f)
+  if report.get('format') != 'embree-benchmark-suite':
+    sys.stderr.write(fileName + ' is not a benchmark suite result file\n')
+    sys.exit(1)
+  return report
+
+def printReport(args):
+  report = load(args.results)
+  print(args.results + ' (' + report['date'] + ', ' + report['host']['node'] + ')')
+  for result in report['results']:
+    sys.stdout.write('  ' + '{0:<80}'.format(result['name']) + ' | ')
+    printResult(result)
+
+########################## comparison ##########################
+
+def compare(args):
+  baseline = load(args.baseline)
+  current = load(args.current)
+  thresholds = dict((m,args.threshold) for m in metrics)
+  for t in args.metric_threshold:
+    (m,v) = t.split('=',1)
+    if not m in metrics:
+      sys.stderr.write('unknown metric ' + m + '\n')
+      sys.exit(1)
+    thresholds[m] = float(v)
+
+  base = dict((r['name'],r) for r in baseline['results'])
+  regressions = 0
+  for result in current['results']:
+    name = result['name']
+    if not name in base:
+      print('  ' + '{0:<80}'.format(name) + ' | not in baseline')
+      continue
+    for m in sorted(result['metrics'].keys()):
+      if not m in base[name]['metrics'] or thresholds[m] < 0.0: continue
+      cur = result['metrics'][m]
+      ref = base[name]['metrics'][m]
+      if ref[args.statistic] == 0.0: continue
+
+      # relative change, positive values are improvements
+      gain = 100.0*(cur[args.statistic]/ref[args.statistic]-1.0)
+      if not metrics[m]: gain = -gain
+
+      # changes within the measurement noise are never regressions
+      noise = args.sigma*math.sqrt(cur['stddev']**2 + ref['stddev']**2)
+      regressed = gain < -thresholds[m] and abs(cur[args.statistic]-ref[args.statistic]) > noise
+      if regressed: regressions += 1
+      if regressed or args.verbose:
+        line = '  ' + '{0:<80}'.format(name) + ' | ' + '{0:<18}'.format(m)
+        line += (' %#12.4g -> %#12.4g (%#+7.2f%%)' % (ref[args.statistic], cur[args.statistic], gain))
+        if regressed: line += ' REGRESSION (threshold ' + str(thresholds[m]) + '%)'
+        print(line)
+
+  for name in sorted(base.keys()):
+    if not name in [r['name'] for r in current['results']]:
+      print('  ' + '{0:<80}'.format(name) + ' | missing in current results')
+
+  if regressions > 0:
+    print(str(regressions) + ' regression(s) found')
+    return 1
+  print('no regressions found')
+  return 0
+
+########################## command line parsing ##########################
+
+parser = argparse.ArgumentParser(description='Embree benchmark suite')
+commands = parser.add_subparsers(dest='command')
+
+runParser = commands.add_parser('run', help='runs the benchmark matrix and writes the results as JSON')
+runParser.add_argument('--models', required=True, help='file listing one "name path" pair per line')
+runParser.add_argument('--bin', default='.', help='directory containing the tutorial executables')
+runParser.add_argument('--output', required=True, help='JSON output file')
+runParser.add_argument('--rays', type=splitList, default=defaultRayTypes, help='comma separated list of ray types: ' + ', '.join(defaultRayTypes))
+runParser.add_argument('--isa', type=splitList, default=['default'], help='comma separated list of ISAs passed as rtcore isa=')
+runParser.add_argument('--quality', type=splitList, default=['default'], help='comma separated list of build qualities: low, medium, high')
+runParser.add_argument('--threads', type=splitList, default=['default'], help='comma separated list of thread counts')
+runParser.add_argument('--benchmark', type=int, nargs=2, default=[8,32], metavar=('SKIP','FRAMES'), help='frames to skip and to measure')
+runParser.add_argument('--repeat', type=int, default=3, help='number of process runs per configuration')
+runParser.add_argument('--size', type=int, nargs=2, default=[1024,1024], metavar=('WIDTH','HEIGHT'), help='image size')
+runParser.add_argument('--rtcore', default='', help='additional device configuration, e.g. set_affinity=1')
+
+printParser = commands.add_parser('print', help='prints a JSON result file')
+printParser.add_argument('results')
+
+compareParser = commands.add_parser('compare', help='compares results against a baseline, fails on regressions')
+compareParser.add_argument('baseline')
+compareParser.add_argument('current')
+compareParser.add_argument('--threshold', type=float, default=5.0, help='allowed regression in percent for all metrics')
+compareParser.add_argument('--metric-threshold', action='append', default=[], metavar='METRIC=PERCENT', help='allowed regression for one metric, negative values disable the metric')
+compareParser.add_argument('--statistic', default='p50', choices=['mean','min','max'] + ['p' + str(p) for p in percentiles], help='statistic to compare')
+compareParser.add_argument('--sigma', type=float, default=0.0, help='ignore changes smaller than this multiple of the combined standard deviation')
+compareParser.add_argument('--verbose', action='store_true', help='print all compared metrics')
+
+args = parser.parse_args()
+if args.command == 'run':
+  run(args)
+elif args.command == 'print':
+  printReport(args)
+elif args.command == 'compare':
+  sys.exit(compare(args))
+else:
+  parser.print_help()
+  sys.exit(1)
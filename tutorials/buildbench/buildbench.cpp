@@ -6,6 +6,7 @@
 namespace embree
 {
   uint32_t g_num_user_threads = 0;
+  uint32_t g_num_scaling_threads = 0;
   
   struct Tutorial : public SceneLoadingTutorialApplication
   {
@@ -20,6 +21,10 @@ namespace embree
           rtcore += ",user_threads=" + toString(g_num_user_threads);
           rtcore += ",start_threads=0,set_affinity=0";
         }, "--user_threads <int>: invokes user thread benchmark with specified number of application provided build threads");
+
+      registerOption("scaling", [] (Ref<ParseStream> cin, const FileName& path) {
+          g_num_scaling_threads = cin->getInt();
+        }, "--scaling <int>: measures static build performance with 1, 2, 4, ... up to the specified number of threads");
     }
     
     void postParseCommandLine() 
@@ -8,6 +8,7 @@
 namespace embree {
 
   extern uint32_t g_num_user_threads;
+  extern uint32_t g_num_scaling_threads;
 
   static const MAYBE_UNUSED size_t skip_iterations               = 5;
   static const MAYBE_UNUSED size_t iterations_dynamic_deformable = 200;
@@ -252,7 +253,7 @@ namespace embree {
     g_scene = nullptr;
   }
 
-  void Benchmark_Static_Create(ISPCScene* scene_in, size_t benchmark_iterations, RTCBuildQuality quality, RTCBuildQuality qflags)
+  double Benchmark_Static_Create(ISPCScene* scene_in, size_t benchmark_iterations, RTCBuildQuality quality, RTCBuildQuality qflags)
   {
     assert(g_scene == nullptr);
     size_t primitives = getNumPrimitives(scene_in);
@@ -300,6 +301,39 @@ namespace embree {
               << 1.0 / (time/iterations) * primitives / 1000000.0 << " Mprims/s" << std::endl;
 
     g_scene = nullptr;
+    return time/iterations;
+  }
+
+  void Benchmark_Static_Create_Scaling(ISPCScene* scene_in, size_t benchmark_iterations, const std::string& cfg)
+  {
+    size_t primitives = getNumPrimitives(scene_in);
+    double time1 = 0.0;
+
+    std::vector<size_t> threadCounts;
+    for (size_t numThreads=1; numThreads<g_num_scaling_threads; numThreads*=2)
+      threadCounts.push_back(numThreads);
+    threadCounts.push_back(g_num_scaling_threads);
+
+    for (size_t numThreads : threadCounts)
+    {
+      /* the number of threads of the tasking system is fixed at device creation */
+      rtcReleaseDevice(g_device);
+      g_device = rtcNewDevice((cfg+",threads="+toString(numThreads)).c_str());
+      error_handler(nullptr,rtcGetDeviceError(g_device));
+      rtcSetDeviceErrorFunction(g_device,error_handler,nullptr);
+
+      const double time = Benchmark_Static_Create(scene_in,benchmark_iterations,RTC_BUILD_QUALITY_MEDIUM,RTC_BUILD_QUALITY_MEDIUM);
+      if (numThreads == 1) time1 = time;
+
+      std::cout << "BENCHMARK_SCALING_STATIC " << numThreads << " threads, "
+                << time << " s, "
+                << 1.0 / time * primitives / 1000000.0 << " Mprims/s, "
+                << time1 / time << "x speedup" << std::endl;
+    }
+
+    rtcReleaseDevice(g_device);
+    g_device = rtcNewDevice(cfg.c_str());
+    rtcSetDeviceErrorFunction(g_device,error_handler,nullptr);
   }
 
   BarrierSys barrier;
@@ -399,7 +433,11 @@ namespace embree {
   /* called by the C++ code for initialization */
   extern "C" void device_init (char* cfg)
   {
-    if (g_num_user_threads == 0)
+    if (g_num_scaling_threads != 0)
+    {
+      Benchmark_Static_Create_Scaling(g_ispc_scene,iterations_static_static,cfg);
+    }
+    else if (g_num_user_threads == 0)
     {
       /* set error handler */
       Benchmark_Dynamic_Update(g_ispc_scene,iterations_dynamic_dynamic,RTC_BUILD_QUALITY_REFIT);
@@ -0,0 +1,111 @@
+// Copyright 2009-2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "../../../common/sys/platform.h"
+
+namespace embree
+{
+  /*! Layout of the Embree binary scene format (.ebs). The file starts
+   *  with a FileHeader directly followed by the section table. The
+   *  node section lists all nodes of the scene graph such that nodes
+   *  only reference nodes stored before them. Each node owns a
+   *  consecutive range of records of the array section, and each
+   *  array record references data stored at a 64 byte aligned file
+   *  offset. Vertex arrays use the in-memory layout of the scene graph
+   *  (Vec3fa with 16 byte stride), thus they can be used directly from
+   *  a memory mapping of the file. */
+  namespace EBS
+  {
+    static const char MAGIC[8] = { 'E','M','B','R','E','E','B','S' };
+    static const uint32_t VERSION = 1;
+    static const uint32_t INVALID_ID = -1;
+    static const size_t DATA_ALIGNMENT = 64;
+
+    struct FileHeader
+    {
+      char magic[8];           //!< file signature
+      uint32_t version;        //!< format version
+      uint32_t numSections;    //!< number of section table entries
+      uint32_t root;           //!< ID of the root node
+      uint32_t reserved;
+    };
+
+    enum SectionType
+    {
+      SECTION_NODES  = 0,      //!< array of Node records
+      SECTION_ARRAYS = 1,      //!< array of Array records
+      SECTION_DATA   = 2       //!< aligned array data
+    };
+
+    struct Section
+    {
+      uint32_t type;           //!< SectionType
+      uint32_t reserved;
+      uint64_t offset;         //!< file offset of the section
+      uint64_t bytes;          //!< size of the section in bytes
+    };
+
+    enum NodeType
+    {
+      NODE_GROUP         = 0,
+      NODE_TRANSFORM     = 1,
+      NODE_TRIANGLE_MESH = 2,
+      NODE_QUAD_MESH     = 3,
+      NODE_SUBDIV_MESH   = 4,
+      NODE_HAIR_SET      = 5,
+      NODE_POINT_SET     = 6,
+      NODE_MATERIAL      = 7,  //!< subtype is the MaterialType
+      NODE_TEXTURE       = 8,
+      NODE_LIGHT         = 9,  //!< subtype is the LightType
+      NODE_CAMERA        = 10,
+      NODE_GRID_MESH     = 11
+    };
+
+    struct Node
+    {
+      uint32_t type;           //!< NodeType
+      uint32_t subtype;        //!< material type, light type, or curve and point geometry type
+      uint32_t firstArray;     //!< index of the first array of the node
+      uint32_t numArrays;      //!< number of arrays of the node
+    };
+
+    /*! Tags identify the arrays of a node, arrays with multiple time steps are stored once per time step. */
+    enum ArrayTag
+    {
+      ARRAY_NAME              = 0,   //!< char, name of the node or file name of a texture
+      ARRAY_PARAMS            = 1,   //!< float, scalar parameters of the node
+      ARRAY_CHILDREN          = 2,   //!< uint32_t, IDs of child nodes
+      ARRAY_MATERIAL          = 3,   //!< uint32_t, ID of the material node
+      ARRAY_TEXTURES          = 4,   //!< uint32_t, IDs of the texture nodes of a material
+      ARRAY_SPACES            = 5,   //!< AffineSpace3fa, transformation for each time step
+      ARRAY_POSITIONS         = 6,   //!< Vec3fa, one array per time step
+      ARRAY_NORMALS           = 7,   //!< Vec3fa, one array per time step
+      ARRAY_TANGENTS          = 8,   //!< Vec3fa, one array per time step
+      ARRAY_DNORMALS          = 9,   //!< Vec3fa, one array per time step
+      ARRAY_TEXCOORDS         = 10,  //!< Vec2f
+      ARRAY_INDICES           = 11,  //!< triangles, quads, or hairs
+      ARRAY_POSITION_INDICES  = 12,  //!< uint32_t
+      ARRAY_NORMAL_INDICES    = 13,  //!< uint32_t
+      ARRAY_TEXCOORD_INDICES  = 14,  //!< uint32_t
+      ARRAY_FACES             = 15,  //!< uint32_t, number of vertices per face
+      ARRAY_HOLES             = 16,  //!< uint32_t
+      ARRAY_EDGE_CREASES      = 17,  //!< Vec2i
+      ARRAY_EDGE_CREASE_WEIGHTS   = 18, //!< float
+      ARRAY_VERTEX_CREASES        = 19, //!< uint32_t
+      ARRAY_VERTEX_CREASE_WEIGHTS = 20, //!< float
+      ARRAY_FLAGS             = 21,  //!< uint8_t, curve end cap flags
+      ARRAY_TEXELS            = 22,  //!< texture data, width, height, and format are stored as params
+      ARRAY_GRIDS             = 23   //!< GridMeshNode::Grid
+    };
+
+    struct Array
+    {
+      uint32_t tag;            //!< ArrayTag
+      uint32_t stride;         //!< size of one item in bytes
+      uint64_t size;           //!< number of items
+      uint64_t offset;         //!< file offset of the first item
+    };
+  }
+}
@@ -0,0 +1,500 @@
+// Copyright 2009-2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ebs_loader.h"
+#include "ebs_format.h"
+#include "mapped_file.h"
+
+namespace embree
+{
+  /*! The loader memory maps the file and validates the section table,
+   *  all nodes, and all arrays first. Textures, materials, lights, and
+   *  cameras, and then all geometries are created in parallel, as they
+   *  only reference nodes of the previous phase. Groups and transforms
+   *  are finally created sequentially in file order. */
+  class EBSLoader
+  {
+  public:
+
+    EBSLoader(const FileName& fileName);
+
+  public:
+    Ref<SceneGraph::Node> root;
+
+  private:
+    const EBS::Array* getArray(const EBS::Node& node, EBS::ArrayTag tag, size_t i = 0) const;
+    size_t countArrays(const EBS::Node& node, EBS::ArrayTag tag) const;
+    std::string getName(const EBS::Node& node) const;
+    std::vector<float> getParams(const EBS::Node& node, size_t num) const;
+    std::vector<uint32_t> getIDs(const EBS::Node& node, EBS::ArrayTag tag) const;
+    Ref<SceneGraph::Node> getNode(size_t id, uint32_t ref) const;
+    Ref<SceneGraph::MaterialNode> getMaterial(size_t id, const EBS::Node& node) const;
+    std::shared_ptr<Texture> getTexture(size_t id, uint32_t ref) const;
+
+    template<typename Vector>
+    void loadArray(const EBS::Node& node, EBS::ArrayTag tag, Vector& vec, size_t i = 0) const;
+    void loadArrays(const EBS::Node& node, EBS::ArrayTag tag, std::vector<avector<Vec3fa>>& vecs) const;
+
+    void createTexture(size_t id);
+    void createMaterial(size_t id);
+    void createLight(size_t id);
+    void createCamera(size_t id);
+    void createTransform(size_t id);
+    void createGroup(size_t id);
+    void createTriangleMesh(size_t id);
+    void createQuadMesh(size_t id);
+    void createSubdivMesh(size_t id);
+    void createGridMesh(size_t id);
+    void createHairSet(size_t id);
+    void createPointSet(size_t id);
+    void createNode(size_t id);
+
+  private:
+    MappedFile file;
+    const EBS::Node* nodes;
+    size_t numNodes;
+    const EBS::Array* arrays;
+    size_t numArrays;
+    std::vector<Ref<SceneGraph::Node>> sceneNodes;
+    std::vector<std::shared_ptr<Texture>> textures;
+  };
+
+  EBSLoader::EBSLoader(const FileName& fileName)
+    : file(fileName), nodes(nullptr), numNodes(0), arrays(nullptr), numArrays(0)
+  {
+    /* validate file header */
+    EBS::FileHeader header;
+    if (file.bytes < sizeof(header)) throw std::runtime_error("invalid binary scene file " + fileName.str());
+    memcpy(&header,file.ptr,sizeof(header));
+    if (memcmp(header.magic,EBS::MAGIC,sizeof(header.magic)) != 0)
+      throw std::runtime_error("invalid binary scene file signature: " + fileName.str());
+    if (header.version != EBS::VERSION)
+      throw std::runtime_error("unsupported binary scene file version " + toString(header.version) + ": " + fileName.str());
+    if (header.numSections > (file.bytes-sizeof(header))/sizeof(EBS::Section))
+      throw std::runtime_error("corrupted binary scene file " + fileName.str());
+
+    /* find node and array sections */
+    const EBS::Section* sections = (const EBS::Section*) (file.ptr+sizeof(header));
+    for (size_t i=0; i<header.numSections; i++)
+    {
+      const EBS::Section& section = sections[i];
+      if (section.offset > file.bytes || section.bytes > file.bytes-section.offset)
+        throw std::runtime_error("corrupted binary scene file " + fileName.str());
+
+      if (section.type == EBS::SECTION_NODES) {
+        nodes = (const EBS::Node*) (file.ptr+section.offset);
+        numNodes = section.bytes/sizeof(EBS::Node);
+      }
+      else if (section.type == EBS::SECTION_ARRAYS) {
+        arrays = (const EBS::Array*) (file.ptr+section.offset);
+        numArrays = section.bytes/sizeof(EBS::Array);
+      }
+    }
+    if (header.root >= numNodes)
+      throw std::runtime_error("corrupted binary scene file " + fileName.str());
+
+    /* validate all nodes and arrays */
+    for (size_t i=0; i<numNodes; i++)
+      if (nodes[i].firstArray > numArrays || nodes[i].numArrays > numArrays-nodes[i].firstArray)
+        throw std::runtime_error("corrupted binary scene file " + fileName.str());
+
+    for (size_t i=0; i<numArrays; i++)
+      if (arrays[i].stride == 0 || arrays[i].offset > file.bytes || arrays[i].size > (file.bytes-arrays[i].offset)/arrays[i].stride)
+        throw std::runtime_error("corrupted binary scene file " + fileName.str());
+
+    /* create nodes in three phases, nodes only reference nodes of previous phases or nodes stored before them */
+    std::vector<size_t> phases[3];
+    for (size_t i=0; i<numNodes; i++)
+    {
+      switch (nodes[i].type) {
+      case EBS::NODE_TEXTURE: case EBS::NODE_MATERIAL: case EBS::NODE_LIGHT: case EBS::NODE_CAMERA:
+        phases[0].push_back(i); break;
+      case EBS::NODE_TRIANGLE_MESH: case EBS::NODE_QUAD_MESH: case EBS::NODE_SUBDIV_MESH: case EBS::NODE_GRID_MESH: case EBS::NODE_HAIR_SET: case EBS::NODE_POINT_SET:
+        phases[1].push_back(i); break;
+      default:
+        phases[2].push_back(i); break;
+      }
+    }
+
+    sceneNodes.resize(numNodes);
+    textures.resize(numNodes);
+    for (size_t i : phases[0]) if (nodes[i].type == EBS::NODE_TEXTURE) createNode(i); // textures first, as materials reference them
+    parallel_for(phases[0].size(), [&](const size_t i) { if (nodes[phases[0][i]].type != EBS::NODE_TEXTURE) createNode(phases[0][i]); });
+    parallel_for(phases[1].size(), [&](const size_t i) { createNode(phases[1][i]); });
+    for (size_t i : phases[2]) createNode(i);
+
+    root = sceneNodes[header.root];
+    if (!root) throw std::runtime_error("corrupted binary scene file " + fileName.str());
+  }
+
+  const EBS::Array* EBSLoader::getArray(const EBS::Node& node, EBS::ArrayTag tag, size_t i) const
+  {
+    for (size_t a=node.firstArray; a<node.firstArray+node.numArrays; a++)
+      if (arrays[a].tag == uint32_t(tag) && i-- == 0) return &arrays[a];
+    return nullptr;
+  }
+
+  size_t EBSLoader::countArrays(const EBS::Node& node, EBS::ArrayTag tag) const
+  {
+    size_t n = 0;
+    for (size_t a=node.firstArray; a<node.firstArray+node.numArrays; a++)
+      if (arrays[a].tag == uint32_t(tag)) n++;
+    return n;
+  }
+
+  template<typename Vector>
+  void EBSLoader::loadArray(const EBS::Node& node, EBS::ArrayTag tag, Vector& vec, size_t i) const
+  {
+    const EBS::Array* array = getArray(node,tag,i);
+    if (array == nullptr) return;
+    if (array->stride != sizeof(vec[0])) throw std::runtime_error("invalid array stride in binary scene file");
+    vec.resize(array->size);
+    if (array->size) memcpy((void*)vec.data(),file.ptr+array->offset,array->size*array->stride);
+  }
+
+  void EBSLoader::loadArrays(const EBS::Node& node, EBS::ArrayTag tag, std::vector<avector<Vec3fa>>& vecs) const
+  {
+    vecs.resize(countArrays(node,tag));
+    for (size_t i=0; i<vecs.size(); i++)
+      loadArray(node,tag,vecs[i],i);
+  }
+
+  std::string EBSLoader::getName(const EBS::Node& node) const
+  {
+    const EBS::Array* array = getArray(node,EBS::ARRAY_NAME);
+    if (array == nullptr) return "";
+    return std::string(file.ptr+array->offset,array->size*array->stride);
+  }
+
+  std::vector<float> EBSLoader::getParams(const EBS::Node& node, size_t num) const
+  {
+    std::vector<float> params;
+    loadArray(node,EBS::ARRAY_PARAMS,params);
+    if (params.size() < num) throw std::runtime_error("missing parameters in binary scene file");
+    return params;
+  }
+
+  std::vector<uint32_t> EBSLoader::getIDs(const EBS::Node& node, EBS::ArrayTag tag) const
+  {
+    std::vector<uint32_t> ids;
+    loadArray(node,tag,ids);
+    return ids;
+  }
+
+  Ref<SceneGraph::Node> EBSLoader::getNode(size_t id, uint32_t ref) const
+  {
+    if (ref >= id || !sceneNodes[ref]) throw std::runtime_error("invalid node reference in binary scene file");
+    return sceneNodes[ref];
+  }
+
+  Ref<SceneGraph::MaterialNode> EBSLoader::getMaterial(size_t id, const EBS::Node& node) const
+  {
+    const std::vector<uint32_t> ids = getIDs(node,EBS::ARRAY_MATERIAL);
+    if (ids.size() == 0 || ids[0] == EBS::INVALID_ID) return nullptr;
+    if (ids[0] >= id || nodes[ids[0]].type != EBS::NODE_MATERIAL) throw std::runtime_error("invalid material reference in binary scene file");
+    return getNode(id,ids[0]).dynamicCast<SceneGraph::MaterialNode>();
+  }
+
+  std::shared_ptr<Texture> EBSLoader::getTexture(size_t id, uint32_t ref) const
+  {
+    if (ref == EBS::INVALID_ID) return nullptr;
+    if (ref >= id || nodes[ref].type != EBS::NODE_TEXTURE) throw std::runtime_error("invalid texture reference in binary scene file");
+    return textures[ref];
+  }
+
+  void EBSLoader::createTexture(size_t id)
+  {
+    const EBS::Node& node = nodes[id];
+    const std::vector<float> params = getParams(node,3);
+    const unsigned width = unsigned(params[0]), height = unsigned(params[1]);
+    const Texture::Format format = Texture::Format(int(params[2]));
+
+    const EBS::Array* texels = getArray(node,EBS::ARRAY_TEXELS);
+    if (texels == nullptr || texels->stride != Texture::getFormatBytesPerTexel(format) || texels->size != size_t(width)*size_t(height))
+      throw std::runtime_error("invalid texture in binary scene file");
+
+    textures[id] = std::make_shared<Texture>(width,height,format,file.ptr+texels->offset);
+    textures[id]->fileName = getName(node);
+  }
+
+  static Vec3fa getVec3fa(const std::vector<float>& params, size_t i) {
+    return Vec3fa(params[i+0],params[i+1],params[i+2]);
+  }
+
+  void EBSLoader::createMaterial(size_t id)
+  {
+    const EBS::Node& node = nodes[id];
+    Ref<SceneGraph::MaterialNode> material;
+    switch (node.subtype)
+    {
+    case MATERIAL_OBJ: {
+      const std::vector<float> params = getParams(node,16);
+      const std::vector<uint32_t> maps = getIDs(node,EBS::ARRAY_TEXTURES);
+      if (maps.size() != 5) throw std::runtime_error("invalid material in binary scene file");
+      Ref<OBJMaterial> m = new OBJMaterial(params[1],getTexture(id,maps[0]),
+                                           getVec3fa(params,7),getTexture(id,maps[1]),
+                                           getVec3fa(params,10),getTexture(id,maps[2]),
+                                           params[2],getTexture(id,maps[3]),
+                                           getTexture(id,maps[4]));
+      m->illum = int(params[0]);
+      m->Ni = params[3];
+      m->Ka = getVec3fa(params,4);
+      m->Kt = getVec3fa(params,13);
+      material = m.dynamicCast<SceneGraph::MaterialNode>();
+      break;
+    }
+    case MATERIAL_THIN_DIELECTRIC: {
+      const std::vector<float> params = getParams(node,5);
+      material = new ThinDielectricMaterial(getVec3fa(params,0),params[3],params[4]);
+      break;
+    }
+    case MATERIAL_METAL: {
+      const std::vector<float> params = getParams(node,10);
+      material = new MetalMaterial(getVec3fa(params,0),getVec3fa(params,3),getVec3fa(params,6),params[9]);
+      break;
+    }
+    case MATERIAL_REFLECTIVE_METAL: {
+      const std::vector<float> params = getParams(node,10);
+      material = new MetalMaterial(getVec3fa(params,0),getVec3fa(params,3),getVec3fa(params,6));
+      break;
+    }
+    case MATERIAL_VELVET: {
+      const std::vector<float> params = getParams(node,8);
+      material = new VelvetMaterial(getVec3fa(params,0),params[3],getVec3fa(params,4),params[7]);
+      break;
+    }
+    case MATERIAL_DIELECTRIC: {
+      const std::vector<float> params = getParams(node,8);
+      material = new DielectricMaterial(getVec3fa(params,0),getVec3fa(params,3),params[6],params[7]);
+      break;
+    }
+    case MATERIAL_METALLIC_PAINT: {
+      const std::vector<float> params = getParams(node,8);
+      material = new MetallicPaintMaterial(getVec3fa(params,0),getVec3fa(params,3),params[6],params[7]);
+      break;
+    }
+    case MATERIAL_MATTE: {
+      const std::vector<float> params = getParams(node,3);
+      material = new MatteMaterial(getVec3fa(params,0));
+      break;
+    }
+    case MATERIAL_MIRROR: {
+      const std::vector<float> params = getParams(node,3);
+      material = new MirrorMaterial(getVec3fa(params,0));
+      break;
+    }
+    case MATERIAL_HAIR: {
+      const std::vector<float> params = getParams(node,8);
+      material = new HairMaterial(getVec3fa(params,0),getVec3fa(params,3),params[6],params[7]);
+      break;
+    }
+    default:
+      throw std::runtime_error("unsupported material in binary scene file");
+    }
+    material->name = getName(node);
+    sceneNodes[id] = material.dynamicCast<SceneGraph::Node>();
+  }
+
+  void EBSLoader::createLight(size_t id)
+  {
+    const EBS::Node& node = nodes[id];
+    Ref<SceneGraph::Light> light;
+    switch (node.subtype)
+    {
+    case SceneGraph::LIGHT_AMBIENT: {
+      const std::vector<float> params = getParams(node,3);
+      light = new SceneGraph::AmbientLight(getVec3fa(params,0));
+      break;
+    }
+    case SceneGraph::LIGHT_POINT: {
+      const std::vector<float> params = getParams(node,6);
+      light = new SceneGraph::PointLight(getVec3fa(params,0),getVec3fa(params,3));
+      break;
+    }
+    case SceneGraph::LIGHT_DIRECTIONAL: {
+      const std::vector<float> params = getParams(node,6);
+      light = new SceneGraph::DirectionalLight(getVec3fa(params,0),getVec3fa(params,3));
+      break;
+    }
+    case SceneGraph::LIGHT_SPOT: {
+      const std::vector<float> params = getParams(node,11);
+      light = new SceneGraph::SpotLight(getVec3fa(params,0),getVec3fa(params,3),getVec3fa(params,6),params[9],params[10]);
+      break;
+    }
+    case SceneGraph::LIGHT_DISTANT: {
+      const std::vector<float> params = getParams(node,7);
+      light = new SceneGraph::DistantLight(getVec3fa(params,0),getVec3fa(params,3),params[6]);
+      break;
+    }
+    case SceneGraph::LIGHT_TRIANGLE: {
+      const std::vector<float> params = getParams(node,12);
+      light = new SceneGraph::TriangleLight(getVec3fa(params,0),getVec3fa(params,3),getVec3fa(params,6),getVec3fa(params,9));
+      break;
+    }
+    case SceneGraph::LIGHT_QUAD: {
+      const std::vector<float> params = getParams(node,15);
+      light = new SceneGraph::QuadLight(getVec3fa(params,0),getVec3fa(params,3),getVec3fa(params,6),getVec3fa(params,9),getVec3fa(params,12));
+      break;
+    }
+    default:
+      throw std::runtime_error("unsupported light in binary scene file");
+    }
+    sceneNodes[id] = new SceneGraph::LightNode(light);
+    sceneNodes[id]->name = getName(node);
+  }
+
+  void EBSLoader::createCamera(size_t id)
+  {
+    const EBS::Node& node = nodes[id];
+    const std::vector<float> params = getParams(node,10);
+    sceneNodes[id] = new SceneGraph::PerspectiveCameraNode(getVec3fa(params,0),getVec3fa(params,3),getVec3fa(params,6),params[9]);
+    sceneNodes[id]->name = getName(node);
+  }
+
+  void EBSLoader::createTransform(size_t id)
+  {
+    const EBS::Node& node = nodes[id];
+    const std::vector<float> params = getParams(node,3);
+    const std::vector<uint32_t> child = getIDs(node,EBS::ARRAY_CHILDREN);
+    if (child.size() != 1) throw std::runtime_error("invalid transform node in binary scene file");
+
+    SceneGraph::Transformations spaces;
+    spaces.time_range = BBox1f(params[0],params[1]);
+    spaces.quaternion = params[2] != 0.0f;
+    loadArray(node,EBS::ARRAY_SPACES,spaces.spaces);
+    if (spaces.size() == 0) throw std::runtime_error("invalid transform node in binary scene file");
+
+    sceneNodes[id] = new SceneGraph::TransformNode(spaces,getNode(id,child[0]));
+    sceneNodes[id]->name = getName(node);
+  }
+
+  void EBSLoader::createGroup(size_t id)
+  {
+    const EBS::Node& node = nodes[id];
+    const std::vector<uint32_t> children = getIDs(node,EBS::ARRAY_CHILDREN);
+    Ref<SceneGraph::GroupNode> group = new SceneGraph::GroupNode;
+    for (size_t i=0; i<children.size(); i++)
+      group->add(getNode(id,children[i]));
+    group->name = getName(node);
+    sceneNodes[id] = group.dynamicCast<SceneGraph::Node>();
+  }
+
+  void EBSLoader::createTriangleMesh(size_t id)
+  {
+    const EBS::Node& node = nodes[id];
+    const std::vector<float> params = getParams(node,2);
+    Ref<SceneGraph::TriangleMeshNode> mesh = new SceneGraph::TriangleMeshNode(getMaterial(id,node),BBox1f(params[0],params[1]));
+    loadArrays(node,EBS::ARRAY_POSITIONS,mesh->positions);
+    loadArrays(node,EBS::ARRAY_NORMALS,mesh->normals);
+    loadArray(node,EBS::ARRAY_TEXCOORDS,mesh->texcoords);
+    loadArray(node,EBS::ARRAY_INDICES,mesh->triangles);
+    mesh->name = getName(node);
+    mesh->verify();
+    sceneNodes[id] = mesh.dynamicCast<SceneGraph::Node>();
+  }
+
+  void EBSLoader::createQuadMesh(size_t id)
+  {
+    const EBS::Node& node = nodes[id];
+    const std::vector<float> params = getParams(node,2);
+    Ref<SceneGraph::QuadMeshNode> mesh = new SceneGraph::QuadMeshNode(getMaterial(id,node),BBox1f(params[0],params[1]));
+    loadArrays(node,EBS::ARRAY_POSITIONS,mesh->positions);
+    loadArrays(node,EBS::ARRAY_NORMALS,mesh->normals);
+    loadArray(node,EBS::ARRAY_TEXCOORDS,mesh->texcoords);
+    loadArray(node,EBS::ARRAY_INDICES,mesh->quads);
+    mesh->name = getName(node);
+    mesh->verify();
+    sceneNodes[id] = mesh.dynamicCast<SceneGraph::Node>();
+  }
+
+  void EBSLoader::createSubdivMesh(size_t id)
+  {
+    const EBS::Node& node = nodes[id];
+    const std::vector<float> params = getParams(node,6);
+    Ref<SceneGraph::SubdivMeshNode> mesh = new SceneGraph::SubdivMeshNode(getMaterial(id,node),BBox1f(params[0],params[1]));
+    mesh->position_subdiv_mode = RTCSubdivisionMode(int(params[2]));
+    mesh->normal_subdiv_mode = RTCSubdivisionMode(int(params[3]));
+    mesh->texcoord_subdiv_mode = RTCSubdivisionMode(int(params[4]));
+    mesh->tessellationRate = params[5];
+    loadArrays(node,EBS::ARRAY_POSITIONS,mesh->positions);
+    loadArrays(node,EBS::ARRAY_NORMALS,mesh->normals);
+    loadArray(node,EBS::ARRAY_TEXCOORDS,mesh->texcoords);
+    loadArray(node,EBS::ARRAY_POSITION_INDICES,mesh->position_indices);
+    loadArray(node,EBS::ARRAY_NORMAL_INDICES,mesh->normal_indices);
+    loadArray(node,EBS::ARRAY_TEXCOORD_INDICES,mesh->texcoord_indices);
+    loadArray(node,EBS::ARRAY_FACES,mesh->verticesPerFace);
+    loadArray(node,EBS::ARRAY_HOLES,mesh->holes);
+    loadArray(node,EBS::ARRAY_EDGE_CREASES,mesh->edge_creases);
+    loadArray(node,EBS::ARRAY_EDGE_CREASE_WEIGHTS,mesh->edge_crease_weights);
+    loadArray(node,EBS::ARRAY_VERTEX_CREASES,mesh->vertex_creases);
+    loadArray(node,EBS::ARRAY_VERTEX_CREASE_WEIGHTS,mesh->vertex_crease_weights);
+    mesh->zero_pad_arrays();
+    mesh->name = getName(node);
+    mesh->verify();
+    sceneNodes[id] = mesh.dynamicCast<SceneGraph::Node>();
+  }
+
+  void EBSLoader::createGridMesh(size_t id)
+  {
+    const EBS::Node& node = nodes[id];
+    const std::vector<float> params = getParams(node,2);
+    Ref<SceneGraph::GridMeshNode> mesh = new SceneGraph::GridMeshNode(getMaterial(id,node),BBox1f(params[0],params[1]));
+    loadArrays(node,EBS::ARRAY_POSITIONS,mesh->positions);
+    loadArray(node,EBS::ARRAY_GRIDS,mesh->grids);
+    mesh->name = getName(node);
+    mesh->verify();
+    sceneNodes[id] = mesh.dynamicCast<SceneGraph::Node>();
+  }
+
+  void EBSLoader::createHairSet(size_t id)
+  {
+    const EBS::Node& node = nodes[id];
+    const std::vector<float> params = getParams(node,3);
+    Ref<SceneGraph::HairSetNode> hair = new SceneGraph::HairSetNode(RTCGeometryType(node.subtype),getMaterial(id,node),BBox1f(params[0],params[1]));
+    hair->tessellation_rate = unsigned(params[2]);
+    loadArrays(node,EBS::ARRAY_POSITIONS,hair->positions);
+    loadArrays(node,EBS::ARRAY_NORMALS,hair->normals);
+    loadArrays(node,EBS::ARRAY_TANGENTS,hair->tangents);
+    loadArrays(node,EBS::ARRAY_DNORMALS,hair->dnormals);
+    loadArray(node,EBS::ARRAY_INDICES,hair->hairs);
+    loadArray(node,EBS::ARRAY_FLAGS,hair->flags);
+    hair->name = getName(node);
+    hair->verify();
+    sceneNodes[id] = hair.dynamicCast<SceneGraph::Node>();
+  }
+
+  void EBSLoader::createPointSet(size_t id)
+  {
+    const EBS::Node& node = nodes[id];
+    const std::vector<float> params = getParams(node,2);
+    Ref<SceneGraph::PointSetNode> points = new SceneGraph::PointSetNode(RTCGeometryType(node.subtype),getMaterial(id,node),BBox1f(params[0],params[1]));
+    loadArrays(node,EBS::ARRAY_POSITIONS,points->positions);
+    loadArrays(node,EBS::ARRAY_NORMALS,points->normals);
+    points->name = getName(node);
+    points->verify();
+    sceneNodes[id] = points.dynamicCast<SceneGraph::Node>();
+  }
+
+  void EBSLoader::createNode(size_t id)
+  {
+    switch (nodes[id].type) {
+    case EBS::NODE_GROUP        : createGroup(id); break;
+    case EBS::NODE_TRANSFORM    : createTransform(id); break;
+    case EBS::NODE_TRIANGLE_MESH: createTriangleMesh(id); break;
+    case EBS::NODE_QUAD_MESH    : createQuadMesh(id); break;
+    case EBS::NODE_SUBDIV_MESH  : createSubdivMesh(id); break;
+    case EBS::NODE_GRID_MESH    : createGridMesh(id); break;
+    case EBS::NODE_HAIR_SET     : createHairSet(id); break;
+    case EBS::NODE_POINT_SET    : createPointSet(id); break;
+    case EBS::NODE_MATERIAL     : createMaterial(id); break;
+    case EBS::NODE_TEXTURE      : createTexture(id); break;
+    case EBS::NODE_LIGHT        : createLight(id); break;
+    case EBS::NODE_CAMERA       : createCamera(id); break;
+    default: throw std::runtime_error("unsupported node type in binary scene file");
+    }
+  }
+
+  Ref<SceneGraph::Node> SceneGraph::loadEBS(const FileName& fileName) {
+    return EBSLoader(fileName).root;
+  }
+}
@@ -0,0 +1,500 @@
+// Copyright 2009-2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "ebs_writer.h"
+#include "ebs_format.h"
+#include <deque>
+
+namespace embree
+{
+  class EBSWriter
+  {
+  public:
+
+    EBSWriter(Ref<SceneGraph::Node> root, const FileName& fileName);
+
+  private:
+    uint32_t store(Ref<SceneGraph::Node> node);
+    uint32_t store(const std::shared_ptr<Texture>& texture);
+    uint32_t store(Ref<SceneGraph::MaterialNode> material);
+    uint32_t store(Ref<SceneGraph::LightNode> light);
+    uint32_t store(Ref<SceneGraph::PerspectiveCameraNode> camera);
+    uint32_t store(Ref<SceneGraph::TransformNode> node);
+    uint32_t store(Ref<SceneGraph::GroupNode> group);
+    uint32_t store(Ref<SceneGraph::TriangleMeshNode> mesh);
+    uint32_t store(Ref<SceneGraph::QuadMeshNode> mesh);
+    uint32_t store(Ref<SceneGraph::SubdivMeshNode> mesh);
+    uint32_t store(Ref<SceneGraph::GridMeshNode> mesh);
+    uint32_t store(Ref<SceneGraph::HairSetNode> hair);
+    uint32_t store(Ref<SceneGraph::PointSetNode> points);
+
+    /* nodes are created after all nodes they reference, thus node IDs are increasing from leaves to root */
+    void beginNode(EBS::NodeType type, uint32_t subtype, const std::string& name);
+    uint32_t endNode();
+
+    void addArray(EBS::ArrayTag tag, const void* data, size_t stride, size_t size);
+    void addArray(EBS::ArrayTag tag, const std::vector<avector<Vec3fa>>& vecs);
+    void addParams(const std::vector<float>& params);
+    void addIDs(EBS::ArrayTag tag, const std::vector<uint32_t>& ids);
+
+    template<typename T>
+    void addArray(EBS::ArrayTag tag, const std::vector<T>& vec) {
+      addArray(tag,vec.data(),sizeof(T),vec.size());
+    }
+
+    void write(const FileName& fileName, uint32_t root);
+
+  private:
+    std::vector<EBS::Node> nodes;
+    std::vector<EBS::Array> arrays;
+    std::vector<const char*> arrayData;         //!< data of each array, points into the scene graph or tempData
+    std::deque<std::vector<char>> tempData;     //!< data of arrays created while storing
+    std::map<Ref<SceneGraph::Node>, uint32_t> nodeMap;
+    std::map<std::shared_ptr<Texture>, uint32_t> textureMap;
+  };
+
+  static uint64_t alignOffset(uint64_t offset, uint64_t alignment) {
+    return (offset+alignment-1) & ~(alignment-1);
+  }
+
+  static void push(std::vector<float>& params, const Vec3fa& v) {
+    params.push_back(v.x); params.push_back(v.y); params.push_back(v.z);
+  }
+
+  void EBSWriter::beginNode(EBS::NodeType type, uint32_t subtype, const std::string& name)
+  {
+    EBS::Node node;
+    node.type = type;
+    node.subtype = subtype;
+    node.firstArray = (uint32_t) arrays.size();
+    node.numArrays = 0;
+    nodes.push_back(node);
+    if (name.size()) addArray(EBS::ARRAY_NAME,name.data(),1,name.size());
+  }
+
+  uint32_t EBSWriter::endNode()
+  {
+    nodes.back().numArrays = (uint32_t) arrays.size() - nodes.back().firstArray;
+    return (uint32_t) nodes.size()-1;
+  }
+
+  void EBSWriter::addArray(EBS::ArrayTag tag, const void* data, size_t stride, size_t size)
+  {
+    EBS::Array array;
+    array.tag = tag;
+    array.stride = (uint32_t) stride;
+    array.size = size;
+    array.offset = 0;
+    arrays.push_back(array);
+    arrayData.push_back((const char*)data);
+  }
+
+  void EBSWriter::addArray(EBS::ArrayTag tag, const std::vector<avector<Vec3fa>>& vecs)
+  {
+    for (const auto& vec : vecs)
+      addArray(tag,vec.data(),sizeof(Vec3fa),vec.size());
+  }
+
+  void EBSWriter::addParams(const std::vector<float>& params)
+  {
+    tempData.push_back(std::vector<char>((const char*)params.data(),(const char*)(params.data()+params.size())));
+    addArray(EBS::ARRAY_PARAMS,tempData.back().data(),sizeof(float),params.size());
+  }
+
+  void EBSWriter::addIDs(EBS::ArrayTag tag, const std::vector<uint32_t>& ids)
+  {
+    tempData.push_back(std::vector<char>((const char*)ids.data(),(const char*)(ids.data()+ids.size())));
+    addArray(tag,tempData.back().data(),sizeof(uint32_t),ids.size());
+  }
+
+  uint32_t EBSWriter::store(const std::shared_ptr<Texture>& texture)
+  {
+    if (!texture) return EBS::INVALID_ID;
+    if (textureMap.find(texture) != textureMap.end())
+      return textureMap[texture];
+
+    std::vector<float> params;
+    params.push_back(float(texture->width));
+    params.push_back(float(texture->height));
+    params.push_back(float(texture->format));
+
+    beginNode(EBS::NODE_TEXTURE,0,texture->fileName);
+    addParams(params);
+    addArray(EBS::ARRAY_TEXELS,texture->data,texture->bytesPerTexel,size_t(texture->width)*size_t(texture->height));
+    return textureMap[texture] = endNode();
+  }
+
+  uint32_t EBSWriter::store(Ref<SceneGraph::MaterialNode> mnode)
+  {
+    std::vector<float> params;
+    std::vector<uint32_t> textures;
+    uint32_t type = 0;
+
+    if (Ref<OBJMaterial> m = mnode.dynamicCast<OBJMaterial>()) {
+      type = MATERIAL_OBJ;
+      params.push_back(float(m->illum));
+      params.push_back(m->d);
+      params.push_back(m->Ns);
+      params.push_back(m->Ni);
+      push(params,m->Ka);
+      push(params,m->Kd);
+      push(params,m->Ks);
+      push(params,m->Kt);
+      textures.push_back(store(m->_map_d));
+      textures.push_back(store(m->_map_Kd));
+      textures.push_back(store(m->_map_Ks));
+      textures.push_back(store(m->_map_Ns));
+      textures.push_back(store(m->_map_Displ));
+    }
+    else if (Ref<ThinDielectricMaterial> m = mnode.dynamicCast<ThinDielectricMaterial>()) {
+      type = MATERIAL_THIN_DIELECTRIC;
+      push(params,m->transmission);
+      params.push_back(m->eta);
+      params.push_back(m->thickness);
+    }
+    else if (Ref<MetalMaterial> m = mnode.dynamicCast<MetalMaterial>()) {
+      type = m->base.type;
+      push(params,m->reflectance);
+      push(params,m->eta);
+      push(params,m->k);
+      params.push_back(m->roughness);
+    }
+    else if (Ref<VelvetMaterial> m = mnode.dynamicCast<VelvetMaterial>()) {
+      type = MATERIAL_VELVET;
+      push(params,m->reflectance);
+      params.push_back(m->backScattering);
+      push(params,m->horizonScatteringColor);
+      params.push_back(m->horizonScatteringFallOff);
+    }
+    else if (Ref<DielectricMaterial> m = mnode.dynamicCast<DielectricMaterial>()) {
+      type = MATERIAL_DIELECTRIC;
+      push(params,m->transmissionOutside);
+      push(params,m->transmissionInside);
+      params.push_back(m->etaOutside);
+      params.push_back(m->etaInside);
+    }
+    else if (Ref<MetallicPaintMaterial> m = mnode.dynamicCast<MetallicPaintMaterial>()) {
+      type = MATERIAL_METALLIC_PAINT;
+      push(params,m->shadeColor);
+      push(params,m->glitterColor);
+      params.push_back(m->glitterSpread);
+      params.push_back(m->eta);
+    }
+    else if (Ref<MatteMaterial> m = mnode.dynamicCast<MatteMaterial>()) {
+      type = MATERIAL_MATTE;
+      push(params,m->reflectance);
+    }
+    else if (Ref<MirrorMaterial> m = mnode.dynamicCast<MirrorMaterial>()) {
+      type = MATERIAL_MIRROR;
+      push(params,m->reflectance);
+    }
+    else if (Ref<HairMaterial> m = mnode.dynamicCast<HairMaterial>()) {
+      type = MATERIAL_HAIR;
+      push(params,m->Kr);
+      push(params,m->Kt);
+      params.push_back(m->nx);
+      params.push_back(m->ny);
+    }
+    else
+      throw std::runtime_error("unsupported material");
+
+    beginNode(EBS::NODE_MATERIAL,type,mnode->name);
+    addParams(params);
+    if (textures.size()) addIDs(EBS::ARRAY_TEXTURES,textures);
+    return endNode();
+  }
+
+  uint32_t EBSWriter::store(Ref<SceneGraph::LightNode> node)
+  {
+    std::vector<float> params;
+    const SceneGraph::LightType type = node->light->getType();
+    switch (type)
+    {
+    case SceneGraph::LIGHT_AMBIENT: {
+      Ref<SceneGraph::AmbientLight> light = node->light.dynamicCast<SceneGraph::AmbientLight>();
+      push(params,light->L);
+      break;
+    }
+    case SceneGraph::LIGHT_POINT: {
+      Ref<SceneGraph::PointLight> light = node->light.dynamicCast<SceneGraph::PointLight>();
+      push(params,light->P);
+      push(params,light->I);
+      break;
+    }
+    case SceneGraph::LIGHT_DIRECTIONAL: {
+      Ref<SceneGraph::DirectionalLight> light = node->light.dynamicCast<SceneGraph::DirectionalLight>();
+      push(params,light->D);
+      push(params,light->E);
+      break;
+    }
+    case SceneGraph::LIGHT_SPOT: {
+      Ref<SceneGraph::SpotLight> light = node->light.dynamicCast<SceneGraph::SpotLight>();
+      push(params,light->P);
+      push(params,light->D);
+      push(params,light->I);
+      params.push_back(light->angleMin);
+      params.push_back(light->angleMax);
+      break;
+    }
+    case SceneGraph::LIGHT_DISTANT: {
+      Ref<SceneGraph::DistantLight> light = node->light.dynamicCast<SceneGraph::DistantLight>();
+      push(params,light->D);
+      push(params,light->L);
+      params.push_back(light->halfAngle);
+      break;
+    }
+    case SceneGraph::LIGHT_TRIANGLE: {
+      Ref<SceneGraph::TriangleLight> light = node->light.dynamicCast<SceneGraph::TriangleLight>();
+      push(params,light->v0);
+      push(params,light->v1);
+      push(params,light->v2);
+      push(params,light->L);
+      break;
+    }
+    case SceneGraph::LIGHT_QUAD: {
+      Ref<SceneGraph::QuadLight> light = node->light.dynamicCast<SceneGraph::QuadLight>();
+      push(params,light->v0);
+      push(params,light->v1);
+      push(params,light->v2);
+      push(params,light->v3);
+      push(params,light->L);
+      break;
+    }
+    default: throw std::runtime_error("unsupported light");
+    }
+
+    beginNode(EBS::NODE_LIGHT,type,node->name);
+    addParams(params);
+    return endNode();
+  }
+
+  uint32_t EBSWriter::store(Ref<SceneGraph::PerspectiveCameraNode> camera)
+  {
+    std::vector<float> params;
+    push(params,camera->from);
+    push(params,camera->to);
+    push(params,camera->up);
+    params.push_back(camera->fov);
+
+    beginNode(EBS::NODE_CAMERA,0,camera->name);
+    addParams(params);
+    return endNode();
+  }
+
+  uint32_t EBSWriter::store(Ref<SceneGraph::TransformNode> node)
+  {
+    const uint32_t child = store(node->child);
+    std::vector<float> params;
+    params.push_back(node->spaces.time_range.lower);
+    params.push_back(node->spaces.time_range.upper);
+    params.push_back(node->spaces.quaternion ? 1.0f : 0.0f);
+
+    beginNode(EBS::NODE_TRANSFORM,0,node->name);
+    addParams(params);
+    addIDs(EBS::ARRAY_CHILDREN,std::vector<uint32_t>(1,child));
+    addArray(EBS::ARRAY_SPACES,node->spaces.spaces.data(),sizeof(AffineSpace3fa),node->spaces.size());
+    return endNode();
+  }
+
+  uint32_t EBSWriter::store(Ref<SceneGraph::GroupNode> group)
+  {
+    std::vector<uint32_t> children;
+    for (size_t i=0; i<group->children.size(); i++)
+      children.push_back(store(group->children[i]));
+
+    beginNode(EBS::NODE_GROUP,0,group->name);
+    addIDs(EBS::ARRAY_CHILDREN,children);
+    return endNode();
+  }
+
+  uint32_t EBSWriter::store(Ref<SceneGraph::TriangleMeshNode> mesh)
+  {
+    const uint32_t material = store(mesh->material.dynamicCast<SceneGraph::Node>());
+    std::vector<float> params;
+    params.push_back(mesh->time_range.lower);
+    params.push_back(mesh->time_range.upper);
+
+    beginNode(EBS::NODE_TRIANGLE_MESH,0,mesh->name);
+    addParams(params);
+    addIDs(EBS::ARRAY_MATERIAL,std::vector<uint32_t>(1,material));
+    addArray(EBS::ARRAY_POSITIONS,mesh->positions);
+    addArray(EBS::ARRAY_NORMALS,mesh->normals);
+    addArray(EBS::ARRAY_TEXCOORDS,mesh->texcoords);
+    addArray(EBS::ARRAY_INDICES,mesh->triangles);
+    return endNode();
+  }
+
+  uint32_t EBSWriter::store(Ref<SceneGraph::QuadMeshNode> mesh)
+  {
+    const uint32_t material = store(mesh->material.dynamicCast<SceneGraph::Node>());
+    std::vector<float> params;
+    params.push_back(mesh->time_range.lower);
+    params.push_back(mesh->time_range.upper);
+
+    beginNode(EBS::NODE_QUAD_MESH,0,mesh->name);
+    addParams(params);
+    addIDs(EBS::ARRAY_MATERIAL,std::vector<uint32_t>(1,material));
+    addArray(EBS::ARRAY_POSITIONS,mesh->positions);
+    addArray(EBS::ARRAY_NORMALS,mesh->normals);
+    addArray(EBS::ARRAY_TEXCOORDS,mesh->texcoords);
+    addArray(EBS::ARRAY_INDICES,mesh->quads);
+    return endNode();
+  }
+
+  uint32_t EBSWriter::store(Ref<SceneGraph::SubdivMeshNode> mesh)
+  {
+    const uint32_t material = store(mesh->material.dynamicCast<SceneGraph::Node>());
+    std::vector<float> params;
+    params.push_back(mesh->time_range.lower);
+    params.push_back(mesh->time_range.upper);
+    params.push_back(float(mesh->position_subdiv_mode));
+    params.push_back(float(mesh->normal_subdiv_mode));
+    params.push_back(float(mesh->texcoord_subdiv_mode));
+    params.push_back(mesh->tessellationRate);
+
+    beginNode(EBS::NODE_SUBDIV_MESH,0,mesh->name);
+    addParams(params);
+    addIDs(EBS::ARRAY_MATERIAL,std::vector<uint32_t>(1,material));
+    addArray(EBS::ARRAY_POSITIONS,mesh->positions);
+    addArray(EBS::ARRAY_NORMALS,mesh->normals);
+    addArray(EBS::ARRAY_TEXCOORDS,mesh->texcoords);
+    addArray(EBS::ARRAY_POSITION_INDICES,mesh->position_indices);
+    addArray(EBS::ARRAY_NORMAL_INDICES,mesh->normal_indices);
+    addArray(EBS::ARRAY_TEXCOORD_INDICES,mesh->texcoord_indices);
+    addArray(EBS::ARRAY_FACES,mesh->verticesPerFace);
+    addArray(EBS::ARRAY_HOLES,mesh->holes);
+    addArray(EBS::ARRAY_EDGE_CREASES,mesh->edge_creases);
+    addArray(EBS::ARRAY_EDGE_CREASE_WEIGHTS,mesh->edge_crease_weights);
+    addArray(EBS::ARRAY_VERTEX_CREASES,mesh->vertex_creases);
+    addArray(EBS::ARRAY_VERTEX_CREASE_WEIGHTS,mesh->vertex_crease_weights);
+    return endNode();
+  }
+
+  uint32_t EBSWriter::store(Ref<SceneGraph::GridMeshNode> mesh)
+  {
+    const uint32_t material = store(mesh->material.dynamicCast<SceneGraph::Node>());
+    std::vector<float> params;
+    params.push_back(mesh->time_range.lower);
+    params.push_back(mesh->time_range.upper);
+
+    beginNode(EBS::NODE_GRID_MESH,0,mesh->name);
+    addParams(params);
+    addIDs(EBS::ARRAY_MATERIAL,std::vector<uint32_t>(1,material));
+    addArray(EBS::ARRAY_POSITIONS,mesh->positions);
+    addArray(EBS::ARRAY_GRIDS,mesh->grids);
+    return endNode();
+  }
+
+  uint32_t EBSWriter::store(Ref<SceneGraph::HairSetNode> hair)
+  {
+    const uint32_t material = store(hair->material.dynamicCast<SceneGraph::Node>());
+    std::vector<float> params;
+    params.push_back(hair->time_range.lower);
+    params.push_back(hair->time_range.upper);
+    params.push_back(float(hair->tessellation_rate));
+
+    beginNode(EBS::NODE_HAIR_SET,hair->type,hair->name);
+    addParams(params);
+    addIDs(EBS::ARRAY_MATERIAL,std::vector<uint32_t>(1,material));
+    addArray(EBS::ARRAY_POSITIONS,hair->positions);
+    addArray(EBS::ARRAY_NORMALS,hair->normals);
+    addArray(EBS::ARRAY_TANGENTS,hair->tangents);
+    addArray(EBS::ARRAY_DNORMALS,hair->dnormals);
+    addArray(EBS::ARRAY_INDICES,hair->hairs);
+    addArray(EBS::ARRAY_FLAGS,hair->flags);
+    return endNode();
+  }
+
+  uint32_t EBSWriter::store(Ref<SceneGraph::PointSetNode> points)
+  {
+    const uint32_t material = store(points->material.dynamicCast<SceneGraph::Node>());
+    std::vector<float> params;
+    params.push_back(points->time_range.lower);
+    params.push_back(points->time_range.upper);
+
+    beginNode(EBS::NODE_POINT_SET,points->type,points->name);
+    addParams(params);
+    addIDs(EBS::ARRAY_MATERIAL,std::vector<uint32_t>(1,material));
+    addArray(EBS::ARRAY_POSITIONS,points->positions);
+    addArray(EBS::ARRAY_NORMALS,points->normals);
+    return endNode();
+  }
+
+  uint32_t EBSWriter::store(Ref<SceneGraph::Node> node)
+  {
+    if (!node) return EBS::INVALID_ID;
+    if (nodeMap.find(node) != nodeMap.end())
+      return nodeMap[node];
+
+    uint32_t id = EBS::INVALID_ID;
+    if      (Ref<SceneGraph::MaterialNode> m = node.dynamicCast<SceneGraph::MaterialNode>()) id = store(m);
+    else if (Ref<SceneGraph::LightNode> m = node.dynamicCast<SceneGraph::LightNode>()) id = store(m);
+    else if (Ref<SceneGraph::PerspectiveCameraNode> m = node.dynamicCast<SceneGraph::PerspectiveCameraNode>()) id = store(m);
+    else if (Ref<SceneGraph::TransformNode> m = node.dynamicCast<SceneGraph::TransformNode>()) id = store(m);
+    else if (Ref<SceneGraph::GroupNode> m = node.dynamicCast<SceneGraph::GroupNode>()) id = store(m);
+    else if (Ref<SceneGraph::TriangleMeshNode> m = node.dynamicCast<SceneGraph::TriangleMeshNode>()) id = store(m);
+    else if (Ref<SceneGraph::QuadMeshNode> m = node.dynamicCast<SceneGraph::QuadMeshNode>()) id = store(m);
+    else if (Ref<SceneGraph::SubdivMeshNode> m = node.dynamicCast<SceneGraph::SubdivMeshNode>()) id = store(m);
+    else if (Ref<SceneGraph::GridMeshNode> m = node.dynamicCast<SceneGraph::GridMeshNode>()) id = store(m);
+    else if (Ref<SceneGraph::HairSetNode> m = node.dynamicCast<SceneGraph::HairSetNode>()) id = store(m);
+    else if (Ref<SceneGraph::PointSetNode> m = node.dynamicCast<SceneGraph::PointSetNode>()) id = store(m);
+    else throw std::runtime_error("unsupported node type");
+    return nodeMap[node] = id;
+  }
+
+  void EBSWriter::write(const FileName& fileName, uint32_t root)
+  {
+    /* calculate file layout */
+    EBS::Section sections[3];
+    sections[0].type = EBS::SECTION_NODES;
+    sections[0].offset = sizeof(EBS::FileHeader) + sizeof(sections);
+    sections[0].bytes = nodes.size()*sizeof(EBS::Node);
+    sections[1].type = EBS::SECTION_ARRAYS;
+    sections[1].offset = sections[0].offset + sections[0].bytes;
+    sections[1].bytes = arrays.size()*sizeof(EBS::Array);
+    sections[2].type = EBS::SECTION_DATA;
+    sections[2].offset = alignOffset(sections[1].offset + sections[1].bytes, EBS::DATA_ALIGNMENT);
+
+    uint64_t offset = sections[2].offset;
+    for (size_t i=0; i<arrays.size(); i++) {
+      arrays[i].offset = offset;
+      offset = alignOffset(offset + arrays[i].size*arrays[i].stride, EBS::DATA_ALIGNMENT);
+    }
+    sections[2].bytes = offset - sections[2].offset;
+    for (size_t i=0; i<3; i++) sections[i].reserved = 0;
+
+    EBS::FileHeader header;
+    memcpy(header.magic,EBS::MAGIC,sizeof(header.magic));
+    header.version = EBS::VERSION;
+    header.numSections = 3;
+    header.root = root;
+    header.reserved = 0;
+
+    /* write file */
+    std::fstream file;
+    file.exceptions (std::fstream::failbit | std::fstream::badbit);
+    file.open (fileName.c_str(), std::fstream::out | std::fstream::binary);
+    file.write((const char*)&header,sizeof(header));
+    file.write((const char*)sections,sizeof(sections));
+    if (nodes.size())  file.write((const char*)nodes.data(),nodes.size()*sizeof(EBS::Node));
+    if (arrays.size()) file.write((const char*)arrays.data(),arrays.size()*sizeof(EBS::Array));
+
+    const char zeros[EBS::DATA_ALIGNMENT] = { 0 };
+    uint64_t pos = sections[1].offset + sections[1].bytes;
+    for (size_t i=0; i<arrays.size(); i++) {
+      file.write(zeros,arrays[i].offset-pos);
+      file.write(arrayData[i],arrays[i].size*arrays[i].stride);
+      pos = arrays[i].offset + arrays[i].size*arrays[i].stride;
+    }
+    file.write(zeros,sections[2].offset+sections[2].bytes-pos);
+  }
+
+  EBSWriter::EBSWriter(Ref<SceneGraph::Node> root, const FileName& fileName)
+  {
+    write(fileName,store(root));
+  }
+
+  void SceneGraph::storeEBS(Ref<SceneGraph::Node> root, const FileName& fileName) {
+    EBSWriter(root,fileName);
+  }
+}
@@ -0,0 +1,14 @@
+// Copyright 2009-2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "scenegraph.h"
+
+namespace embree
+{
+  namespace SceneGraph
+  {
+    void storeEBS(Ref<SceneGraph::Node> root, const FileName& fileName);
+  }
+}
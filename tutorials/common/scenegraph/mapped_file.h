@@ -0,0 +1,62 @@
+// Copyright 2009-2020 Intel Corporation
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include "../../../common/sys/alloc.h"
+#include "../../../common/sys/filename.h"
+#include "../../../common/algorithms/parallel_for.h"
+#include <fstream>
+
+namespace embree
+{
+  /*! read-only memory mapping of an entire file, used by the parallel scene loaders */
+  class MappedFile
+  {
+  public:
+
+    MappedFile (const FileName& fileName)
+      : ptr(nullptr), bytes(0), mapping(nullptr), mappingBytes(0)
+    {
+      std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+      if (!file.is_open()) THROW_RUNTIME_ERROR("cannot open " + fileName.str());
+      bytes = (size_t) file.tellg();
+      file.close();
+
+      ptr = (const char*) os_map_file(fileName.c_str(),0,bytes,mapping,mappingBytes);
+      os_prefetch((void*)ptr,bytes);
+    }
+
+    ~MappedFile () {
+      os_unmap_file(mapping,mappingBytes);
+    }
+
+    /*! splits the file range [begin,end) into about numChunks chunks, each
+     *  chunk starts directly after a newline that is not escaped by a '\' */
+    std::vector<size_t> splitLines(size_t begin, size_t end, size_t numChunks) const
+    {
+      std::vector<size_t> chunks;
+      chunks.push_back(begin);
+      for (size_t i=1; i<numChunks; i++)
+      {
+        size_t pos = max(chunks.back()+1, begin + i*(end-begin)/numChunks);
+        while (pos < end && (ptr[pos-1] != '\n' || (pos >= 2 && ptr[pos-2] == '\\'))) pos++;
+        if (pos < end && pos > chunks.back()) chunks.push_back(pos);
+      }
+      chunks.push_back(end);
+      return chunks;
+    }
+
+  private:
+    MappedFile (const MappedFile& other) DELETED; // do not implement
+    MappedFile& operator= (const MappedFile& other) DELETED; // do not implement
+
+  public:
+    const char* ptr;   //!< start of file data
+    size_t bytes;      //!< size of the file
+
+  private:
+    void* mapping;
+    size_t mappingBytes;
+  };
+}
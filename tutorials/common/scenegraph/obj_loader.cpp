@@ -3,6 +3,8 @@
 
 #include "obj_loader.h"
 #include "texture.h"
+#include "mapped_file.h"
+#include "../../../common/algorithms/parallel_prefix_sum.h"
 
 namespace embree
 {
@@ -29,7 +31,7 @@ namespace embree
   }
 
   /*! Fill space at the end of the token with 0s. */
-  static inline const char* trimEnd(const char* token) 
+  static inline const char* trimEnd(const char* token)
   {
     if (*token == 0) return token;
     char* pe = (char*) token;
@@ -39,11 +41,35 @@ namespace embree
     return token;
   }
 
+  /*! Copies the next line of [ptr,end) into line, lines ending with '\' get joined with the following line. */
+  static inline const char* getLine(const char* ptr, const char* end, std::string& line)
+  {
+    line.clear();
+    while (true)
+    {
+      const char* eol = (const char*) memchr(ptr, '\n', end-ptr);
+      if (eol == nullptr) eol = end;
+      line.append(ptr, eol);
+      ptr = eol < end ? eol+1 : end;
+      if (line.empty() || line[line.size()-1] != '\\') break;
+
+      line[line.size()-1] = ' ';
+      if (ptr == end) break;
+      if (*ptr == '\n') { ptr++; break; }
+    }
+    return ptr;
+  }
+
   /*! Determine if character is a separator. */
   static inline bool isSep(const char c) {
     return (c == ' ') || (c == '\t');
   }
 
+  /*! Determine if character is a decimal digit. */
+  static inline bool isDigit(const char c) {
+    return (c >= '0') && (c <= '9');
+  }
+
   /*! Parse separator. */
   static inline const char* parseSep(const char*& token) {
     size_t sep = strspn(token, " \t");
@@ -56,10 +82,71 @@ namespace embree
     return token+=strspn(token, " \t");
   }
 
+  /*! Converts a string to a double like atof. Numbers with at most 19
+   *  significant digits that fit into the double mantissa and have a
+   *  small decimal exponent are exactly representable as mantissa and
+   *  power of ten, thus a single multiplication or division gives the
+   *  correctly rounded result. All other numbers fall back to atof. */
+  static inline double parseDouble(const char* str)
+  {
+    static const double pow10[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char* p = str + strspn(str, " \t");
+    const bool negative = *p == '-';
+    if (*p == '-' || *p == '+') p++;
+
+    uint64_t mantissa = 0;
+    int exponent = 0, digits = 0, significant = 0;
+    for (; isDigit(*p); p++, digits++) {
+      if (mantissa || *p != '0') significant++;
+      mantissa = 10*mantissa + (*p-'0');
+    }
+    if (*p == '.') {
+      for (p++; isDigit(*p); p++, digits++, exponent--) {
+        if (mantissa || *p != '0') significant++;
+        mantissa = 10*mantissa + (*p-'0');
+      }
+    }
+    if (digits == 0 || *p == 'x' || *p == 'X')
+      return atof(str);
+
+    if (*p == 'e' || *p == 'E')
+    {
+      p++;
+      const bool negativeExponent = *p == '-';
+      if (*p == '-' || *p == '+') p++;
+      if (!isDigit(*p)) return atof(str);
+      int e = 0;
+      for (; isDigit(*p); p++)
+        if (e < 10000) e = 10*e + (*p-'0');
+      exponent += negativeExponent ? -e : e;
+    }
+
+    if (significant > 19 || mantissa > (uint64_t(1) << 53) || exponent < -22 || exponent > 22)
+      return atof(str);
+
+    const double value = exponent < 0 ? double(mantissa) / pow10[-exponent] : double(mantissa) * pow10[exponent];
+    return negative ? -value : value;
+  }
+
+  /*! Converts a string to an int like atoi. */
+  static inline int parseInt(const char* str)
+  {
+    const char* p = str + strspn(str, " \t");
+    const bool negative = *p == '-';
+    if (*p == '-' || *p == '+') p++;
+    unsigned int n = 0;
+    for (; isDigit(*p); p++) n = 10*n + (*p-'0');
+    return negative ? -int(n) : int(n);
+  }
+
   /*! Read float from a string. */
   static inline float getFloat(const char*& token) {
     token += strspn(token, " \t");
-    float n = (float)atof(token);
+    float n = (float)parseDouble(token);
     token += strcspn(token, " \t\r");
     return n;
   }
@@ -67,7 +154,7 @@ namespace embree
   /*! Read int from a string. */
   static inline int getInt(const char*& token) {
     token += strspn(token, " \t");
-    int n = atoi(token);
+    int n = parseInt(token);
     token += strcspn(token, " \t\r");
     return n;
   }
@@ -99,21 +186,80 @@ namespace embree
     return Vec3fa(x,y,z);
   }
 
+  /*! The OBJ file gets memory mapped and split into chunks at line
+   *  boundaries. A first parallel pass counts the vertices of each
+   *  chunk, such that a prefix sum gives the position of each chunk's
+   *  vertices in the vertex arrays. A second parallel pass parses all
+   *  chunks, which can then resolve relative indices locally. The faces
+   *  of all chunks get merged into face groups in file order, and the
+   *  meshes of all face groups are finally created in parallel. */
   class OBJLoader
   {
   public:
 
     /*! Constructor. */
     OBJLoader(const FileName& fileName, const bool subdivMode, const bool combineIntoSingleObject);
- 
+
     /*! output model */
     Ref<SceneGraph::GroupNode> group;
-  
+
   private:
 
+    /*! Number of vertex positions, normals, and texture coordinates. */
+    struct VertexCounts
+    {
+      VertexCounts () : v(0), vn(0), vt(0) {}
+      VertexCounts (size_t v, size_t vn, size_t vt) : v(v), vn(vn), vt(vt) {}
+
+      friend VertexCounts operator+ (const VertexCounts& a, const VertexCounts& b) {
+        return VertexCounts(a.v+b.v, a.vn+b.vn, a.vt+b.vt);
+      }
+
+      size_t v, vn, vt;
+    };
+
+    /*! Faces, edge creases, and hair of one mesh. */
+    struct FaceGroup
+    {
+      bool empty() const { return faceSizes.empty() && hair.empty(); }
+      void append(FaceGroup& other);
+
+      std::vector<unsigned int> faceSizes;
+      std::vector<Vertex> faceVertices;
+      std::vector<Crease> ec;
+      std::vector<avector<Vec3fa> > hair;
+      Ref<SceneGraph::MaterialNode> material;
+      VertexCounts counts;     //!< number of vertices parsed when the group got flushed
+    };
+
+    /*! Material statement and the faces that follow it inside a chunk. */
+    struct Segment
+    {
+      enum Statement { NONE, USEMTL, MTLLIB };
+
+      Segment (Statement statement = NONE, const std::string& name = "", const VertexCounts& counts = VertexCounts())
+        : statement(statement), name(name), counts(counts) {}
+
+      Statement statement;
+      std::string name;        //!< material or material library name
+      VertexCounts counts;     //!< number of vertices parsed before the statement
+      FaceGroup faces;
+    };
+
+    /*! Part of the file parsed by a single task. */
+    struct Chunk
+    {
+      Chunk (size_t begin, size_t end) : begin(begin), end(end) {}
+
+      size_t begin, end;        //!< byte range inside the file
+      VertexCounts counts;      //!< number of vertices in the chunk
+      VertexCounts base;        //!< number of vertices in all previous chunks
+      std::vector<Segment> segments;
+    };
+
     /*! file to load */
     FileName path;
-  
+
     /*! load only quads and ignore triangles */
     bool subdivMode;
 
@@ -121,85 +267,152 @@ namespace embree
     avector<Vec3fa> v;
     avector<Vec3fa> vn;
     std::vector<Vec2f> vt;
-    std::vector<Crease> ec;
-
-    std::vector<std::vector<Vertex> > curGroup;
-    std::vector<avector<Vec3fa> > curGroupHair;
 
     /*! Material handling. */
-    std::string curMaterialName;
-    Ref<SceneGraph::MaterialNode> curMaterial;
     std::map<std::string, Ref<SceneGraph::MaterialNode> > material;
-    std::map<std::string, std::shared_ptr<Texture>> textureMap; 
+    std::map<std::string, std::shared_ptr<Texture>> textureMap;
 
   private:
     void loadMTL(const FileName& fileName);
-    unsigned int fix_v (int index);
-    unsigned int fix_vt(int index);
-    unsigned int fix_vn(int index);
-    void flushFaceGroup();
-    void flushTriGroup();
-    void flushHairGroup();
-    Vertex getUInt3(const char*& token);
-    uint32_t getVertex(std::map<Vertex,uint32_t>& vertexMap, Ref<SceneGraph::TriangleMeshNode> mesh, const Vertex& i);
+    void countChunk(const MappedFile& file, Chunk& chunk);
+    void parseChunk(const MappedFile& file, Chunk& chunk);
+    static unsigned int fix(int index, size_t count);
+    static Vertex getUInt3(const char*& token, const VertexCounts& counts);
+    static void flushFaceGroup(FaceGroup& cur, const VertexCounts& counts, std::vector<FaceGroup>& groups);
+    Ref<SceneGraph::Node> createTriGroup(const FaceGroup& g);
+    Ref<SceneGraph::Node> createHairGroup(const FaceGroup& g);
+    uint32_t getVertex(std::map<Vertex,uint32_t>& vertexMap, Ref<SceneGraph::TriangleMeshNode> mesh, const Vertex& i, const VertexCounts& counts);
     std::shared_ptr<Texture> loadTexture(const FileName& fname);
   };
 
-  OBJLoader::OBJLoader(const FileName &fileName, const bool subdivMode, const bool combineIntoSingleObject) 
+  OBJLoader::OBJLoader(const FileName &fileName, const bool subdivMode, const bool combineIntoSingleObject)
     : group(new SceneGraph::GroupNode), path(fileName.path()), subdivMode(subdivMode)
   {
-    /* open file */
-    std::ifstream cin;
-    cin.open(fileName.c_str());
-    if (!cin.is_open()) {
-      THROW_RUNTIME_ERROR("cannot open " + fileName.str());
-      return;
-    }
+    /* map file */
+    MappedFile file(fileName);
+
+    /* split file into chunks of about 1 MB at line boundaries */
+    std::vector<Chunk> chunks;
+    const std::vector<size_t> bounds = file.splitLines(0,file.bytes,(file.bytes+(1<<20)-1)>>20);
+    for (size_t i=0; i+1<bounds.size(); i++)
+      chunks.push_back(Chunk(bounds[i],bounds[i+1]));
+
+    /* count vertices of each chunk and compute where each chunk's vertices are stored */
+    parallel_for(chunks.size(), [&](const size_t i) { countChunk(file,chunks[i]); });
+    std::vector<VertexCounts> counts(chunks.size()), base(chunks.size());
+    for (size_t i=0; i<chunks.size(); i++) counts[i] = chunks[i].counts;
+    const VertexCounts total = parallel_prefix_sum(counts,base,chunks.size(),VertexCounts(),std::plus<VertexCounts>());
+    for (size_t i=0; i<chunks.size(); i++) chunks[i].base = base[i];
+
+    /* parse all chunks */
+    v.resize(total.v);
+    vn.resize(total.vn);
+    vt.resize(total.vt);
+    parallel_for(chunks.size(), [&](const size_t i) { parseChunk(file,chunks[i]); });
 
     /* generate default material */
     Ref<SceneGraph::MaterialNode> defaultMaterial = new OBJMaterial("default");
-    curMaterialName = "default";
-    curMaterial = defaultMaterial;
 
-    while (cin.peek() != -1)
+    /* merge faces into face groups, materials are handled in file order */
+    std::vector<FaceGroup> groups;
+    FaceGroup cur;
+    cur.material = defaultMaterial;
+    for (size_t i=0; i<chunks.size(); i++)
     {
-      /* load next multiline */
-      std::string line; std::getline(cin,line);
-      while (!line.empty() && line[line.size()-1] == '\\') {
-	line[line.size()-1] = ' ';
-	std::string next_line; std::getline(cin,next_line);
-	if (next_line.empty()) break;
-	line += next_line;
+      for (size_t j=0; j<chunks[i].segments.size(); j++)
+      {
+        Segment& segment = chunks[i].segments[j];
+
+        /*! use material */
+        if (segment.statement == Segment::USEMTL)
+        {
+          if (!combineIntoSingleObject) flushFaceGroup(cur,segment.counts,groups);
+          if (material.find(segment.name) == material.end())
+            cur.material = defaultMaterial;
+          else
+            cur.material = material[segment.name];
+        }
+
+        /* load material library */
+        else if (segment.statement == Segment::MTLLIB)
+          loadMTL(path + segment.name);
+
+        cur.append(segment.faces);
       }
+      chunks[i].segments.clear();
+    }
+    flushFaceGroup(cur,total,groups);
+
+    /* create meshes of all face groups */
+    std::vector<Ref<SceneGraph::Node>> triMeshes(groups.size());
+    std::vector<Ref<SceneGraph::Node>> hairSets(groups.size());
+    parallel_for(groups.size(), [&](const size_t i) {
+      triMeshes[i] = createTriGroup(groups[i]);
+      hairSets[i] = createHairGroup(groups[i]);
+    });
+
+    for (size_t i=0; i<groups.size(); i++) {
+      group->add(triMeshes[i]);
+      group->add(hairSets[i]);
+    }
+  }
+
+  /*! counts the vertex positions, normals, and texture coordinates of a chunk */
+  void OBJLoader::countChunk(const MappedFile& file, Chunk& chunk)
+  {
+    std::string line;
+    for (const char* ptr = file.ptr+chunk.begin, *end = file.ptr+chunk.end; ptr < end; )
+    {
+      ptr = getLine(ptr,end,line);
+      const char* token = line.c_str() + strspn(line.c_str(), " \t");
+      if (token[0] != 'v') continue;
+      if (isSep(token[1])) chunk.counts.v++;
+      else if (token[1] == 'n' && isSep(token[2])) chunk.counts.vn++;
+      else if (token[1] == 't' && isSep(token[2])) chunk.counts.vt++;
+    }
+  }
+
+  /*! parses a chunk, vertices are directly stored into the vertex arrays */
+  void OBJLoader::parseChunk(const MappedFile& file, Chunk& chunk)
+  {
+    VertexCounts counts = chunk.base;
+    chunk.segments.push_back(Segment());
+    FaceGroup* faces = &chunk.segments.back().faces;
+
+    std::string line;
+    for (const char* ptr = file.ptr+chunk.begin, *end = file.ptr+chunk.end; ptr < end; )
+    {
+      /* load next multiline */
+      ptr = getLine(ptr,end,line);
       const char* token = trimEnd(line.c_str() + strspn(line.c_str(), " \t"));
       if (token[0] == 0) continue;
 
       /*! parse position */
-      if (token[0] == 'v' && isSep(token[1])) { 
-        v.push_back(getVec3f(token += 2)); continue;
+      if (token[0] == 'v' && isSep(token[1])) {
+        v[counts.v++] = getVec3f(token += 2); continue;
       }
 
       /* parse normal */
-      if (token[0] == 'v' && token[1] == 'n' && isSep(token[2])) { 
-        vn.push_back(getVec3f(token += 3)); 
-        continue; 
+      if (token[0] == 'v' && token[1] == 'n' && isSep(token[2])) {
+        vn[counts.vn++] = getVec3f(token += 3);
+        continue;
       }
 
       /* parse texcoord */
-      if (token[0] == 'v' && token[1] == 't' && isSep(token[2])) { vt.push_back(getVec2f(token += 3)); continue; }
+      if (token[0] == 'v' && token[1] == 't' && isSep(token[2])) { vt[counts.vt++] = getVec2f(token += 3); continue; }
 
       /*! parse face */
       if (token[0] == 'f' && isSep(token[1]))
       {
         parseSep(token += 1);
 
-        std::vector<Vertex> face;
+        unsigned int numVertices = 0;
         while (token[0]) {
-	  Vertex vtx = getUInt3(token);
-          face.push_back(vtx);
+          faces->faceVertices.push_back(getUInt3(token,counts));
+          numVertices++;
           parseSepOpt(token);
         }
-        curGroup.push_back(face);
+        faces->faceSizes.push_back(numVertices);
         continue;
       }
 
@@ -221,7 +434,7 @@ namespace embree
         for (unsigned int i=0; i<3*N+1; i++) {
           hair.push_back(getVec3fa(token));
         }
-        
+
         for (unsigned int i=0; i<N+1; i++)
         {
           float r = getFloat(token);
@@ -230,50 +443,40 @@ namespace embree
           hair[3*i+0].w = r;
           if (i != N) hair[3*i+1].w = r;
         }
-        curGroupHair.push_back(hair);
+        faces->hair.push_back(hair);
       }
-      
+
       /*! parse edge crease */
       if (token[0] == 'e' && token[1] == 'c' && isSep(token[2]))
       {
 	parseSep(token += 2);
 	float w = getFloat(token);
 	parseSepOpt(token);
-	unsigned int a = fix_v(getInt(token));
+	unsigned int a = fix(getInt(token),counts.v);
 	parseSepOpt(token);
-	unsigned int b = fix_v(getInt(token));
+	unsigned int b = fix(getInt(token),counts.v);
 	parseSepOpt(token);
-	ec.push_back(Crease(w, a, b));
+	faces->ec.push_back(Crease(w, a, b));
 	continue;
       }
 
-      /*! use material */
+      /*! use material, materials are selected when merging the chunks */
       if (!strncmp(token, "usemtl", 6) && isSep(token[6]))
       {
-        if (!combineIntoSingleObject) flushFaceGroup();
-        std::string name(parseSep(token += 6));
-        if (material.find(name) == material.end()) {
-          curMaterial = defaultMaterial;
-          curMaterialName = "default";
-        }
-        else {
-          curMaterial = material[name];
-          curMaterialName = name;
-        }
+        chunk.segments.push_back(Segment(Segment::USEMTL,parseSep(token += 6),counts));
+        faces = &chunk.segments.back().faces;
         continue;
       }
 
-      /* load material library */
+      /* load material library, gets loaded when merging the chunks */
       if (!strncmp(token, "mtllib", 6) && isSep(token[6])) {
-        loadMTL(path + std::string(parseSep(token += 6)));
+        chunk.segments.push_back(Segment(Segment::MTLLIB,parseSep(token += 6),counts));
+        faces = &chunk.segments.back().faces;
         continue;
       }
 
       // ignore unknown stuff
     }
-    flushFaceGroup();
-
-    cin.close();
   }
 
   struct ExtObjMaterial
@@ -454,17 +657,16 @@ namespace embree
     cin.close();
   }
 
+
   /*! handles relative indices and starts indexing from 0 */
-  unsigned int OBJLoader::fix_v (int index) { return (index > 0 ? index - 1 : (index == 0 ? 0 : (int) v .size() + index)); }
-  unsigned int OBJLoader::fix_vt(int index) { return (index > 0 ? index - 1 : (index == 0 ? 0 : (int) vt.size() + index)); }
-  unsigned int OBJLoader::fix_vn(int index) { return (index > 0 ? index - 1 : (index == 0 ? 0 : (int) vn.size() + index)); }
+  unsigned int OBJLoader::fix(int index, size_t count) { return (index > 0 ? index - 1 : (index == 0 ? 0 : (int) count + index)); }
 
   /*! Parse differently formated triplets like: n0, n0/n1/n2, n0//n2, n0/n1.          */
   /*! All indices are converted to C-style (from 0). Missing entries are assigned -1. */
-  Vertex OBJLoader::getUInt3(const char*& token)
+  Vertex OBJLoader::getUInt3(const char*& token, const VertexCounts& counts)
   {
     Vertex v(-1);
-    v.v = fix_v(atoi(token));
+    v.v = fix(parseInt(token),counts.v);
     token += strcspn(token, "/ \t\r");
     if (token[0] != '/') return(v);
     token++;
@@ -472,105 +674,128 @@ namespace embree
     // it is i//n
     if (token[0] == '/') {
       token++;
-      v.vn = fix_vn(atoi(token));
+      v.vn = fix(parseInt(token),counts.vn);
       token += strcspn(token, " \t\r");
       return(v);
     }
 
     // it is i/t/n or i/t
-    v.vt = fix_vt(atoi(token));
+    v.vt = fix(parseInt(token),counts.vt);
     token += strcspn(token, "/ \t\r");
     if (token[0] != '/') return(v);
     token++;
 
     // it is i/t/n
-    v.vn = fix_vn(atoi(token));
+    v.vn = fix(parseInt(token),counts.vn);
     token += strcspn(token, " \t\r");
     return(v);
   }
 
-  uint32_t OBJLoader::getVertex(std::map<Vertex,uint32_t>& vertexMap, Ref<SceneGraph::TriangleMeshNode> mesh, const Vertex& i)
+  uint32_t OBJLoader::getVertex(std::map<Vertex,uint32_t>& vertexMap, Ref<SceneGraph::TriangleMeshNode> mesh, const Vertex& i, const VertexCounts& counts)
   {
     const std::map<Vertex, uint32_t>::iterator& entry = vertexMap.find(i);
     if (entry != vertexMap.end()) return(entry->second);
-    
-    if (i.v >= v.size()) std::cout << "WARNING: corrupted OBJ file" << std::endl;
+
+    if (i.v >= counts.v) std::cout << "WARNING: corrupted OBJ file" << std::endl;
     else mesh->positions[0].push_back(v[i.v]);
-      
+
     if (i.vn != -1) {
       while (mesh->normals[0].size() < mesh->positions[0].size()) mesh->normals[0].push_back(zero); // some vertices might not had a normal
 
-      if (i.vn >= vn.size()) std::cout << "WARNING: corrupted OBJ file" << std::endl;
+      if (i.vn >= counts.vn) std::cout << "WARNING: corrupted OBJ file" << std::endl;
       else mesh->normals[0][mesh->positions[0].size()-1] = vn[i.vn];
     }
     if (i.vt != -1) {
       while (mesh->texcoords.size() < mesh->positions[0].size()) mesh->texcoords.push_back(zero); // some vertices might not had a texture coordinate
 
-      if (i.vt >= vt.size()) std::cout << "WARNING: corrupted OBJ file" << std::endl;
+      if (i.vt >= counts.vt) std::cout << "WARNING: corrupted OBJ file" << std::endl;
       else mesh->texcoords[mesh->positions[0].size()-1] = vt[i.vt];
     }
     return (vertexMap[i] = (unsigned int)(mesh->positions[0].size()) - 1);
   }
 
-  void OBJLoader::flushFaceGroup()
+  template<typename Vector>
+  static void appendVector(Vector& dst, Vector& src)
   {
-    flushTriGroup();
-    flushHairGroup();
+    if (dst.empty()) std::swap(dst,src);
+    else dst.insert(dst.end(),std::make_move_iterator(src.begin()),std::make_move_iterator(src.end()));
+    src.clear();
   }
 
-  /*! end current facegroup and append to mesh */
-  void OBJLoader::flushTriGroup()
+  void OBJLoader::FaceGroup::append(FaceGroup& other)
   {
-    if (curGroup.empty()) return;
+    appendVector(faceSizes,other.faceSizes);
+    appendVector(faceVertices,other.faceVertices);
+    appendVector(ec,other.ec);
+    appendVector(hair,other.hair);
+  }
+
+  /*! end current facegroup, edge creases are kept until the next group with faces */
+  void OBJLoader::flushFaceGroup(FaceGroup& cur, const VertexCounts& counts, std::vector<FaceGroup>& groups)
+  {
+    if (cur.empty()) return;
+
+    FaceGroup next;
+    next.material = cur.material;
+    if (cur.faceSizes.empty()) std::swap(next.ec,cur.ec);
+
+    cur.counts = counts;
+    groups.push_back(std::move(cur));
+    cur = std::move(next);
+  }
+
+  /*! creates the mesh of a face group */
+  Ref<SceneGraph::Node> OBJLoader::createTriGroup(const FaceGroup& g)
+  {
+    if (g.faceSizes.empty()) return nullptr;
 
     if (subdivMode)
     {
-      Ref<SceneGraph::SubdivMeshNode> mesh = new SceneGraph::SubdivMeshNode(curMaterial,BBox1f(0,1),1);
+      Ref<SceneGraph::SubdivMeshNode> mesh = new SceneGraph::SubdivMeshNode(g.material,BBox1f(0,1),1);
       mesh->normals.resize(1);
-      group->add(mesh.cast<SceneGraph::Node>());
 
-      for (size_t i=0; i<v.size();  i++) mesh->positions[0].push_back(v[i]);
-      for (size_t i=0; i<vn.size(); i++) mesh->normals[0].push_back(vn[i]);
-      for (size_t i=0; i<vt.size(); i++) mesh->texcoords.push_back(vt[i]);
-      
-      for (size_t i=0; i<ec.size(); ++i) {
-        assert(((size_t)ec[i].a < v.size()) && ((size_t)ec[i].b < v.size()));
-        mesh->edge_creases.push_back(Vec2i(ec[i].a, ec[i].b));
-        mesh->edge_crease_weights.push_back(ec[i].w);
-      }
-      
-      for (size_t j=0; j<curGroup.size(); j++)
-      {
-        const std::vector<Vertex>& face = curGroup[j];
-        mesh->verticesPerFace.push_back(int(face.size()));
-        for (size_t i=0; i<face.size(); i++)
-          mesh->position_indices.push_back(face[i].v);
+      mesh->positions[0].resize(g.counts.v);
+      mesh->normals[0].resize(g.counts.vn);
+      std::copy(v.begin(),v.begin()+g.counts.v,mesh->positions[0].begin());
+      std::copy(vn.begin(),vn.begin()+g.counts.vn,mesh->normals[0].begin());
+      mesh->texcoords.assign(vt.begin(),vt.begin()+g.counts.vt);
+
+      for (size_t i=0; i<g.ec.size(); ++i) {
+        assert(((size_t)g.ec[i].a < g.counts.v) && ((size_t)g.ec[i].b < g.counts.v));
+        mesh->edge_creases.push_back(Vec2i(g.ec[i].a, g.ec[i].b));
+        mesh->edge_crease_weights.push_back(g.ec[i].w);
       }
+
+      mesh->verticesPerFace.assign(g.faceSizes.begin(),g.faceSizes.end());
+      mesh->position_indices.resize(g.faceVertices.size());
+      for (size_t i=0; i<g.faceVertices.size(); i++)
+        mesh->position_indices[i] = g.faceVertices[i].v;
+
       if (mesh->normals[0].size() == 0)
         mesh->normals.clear();
       mesh->verify();
+      return mesh.cast<SceneGraph::Node>();
     }
     else
     {
-      Ref<SceneGraph::TriangleMeshNode> mesh = new SceneGraph::TriangleMeshNode(curMaterial,BBox1f(0,1),1);
+      Ref<SceneGraph::TriangleMeshNode> mesh = new SceneGraph::TriangleMeshNode(g.material,BBox1f(0,1),1);
       mesh->normals.resize(1);
-      group->add(mesh.cast<SceneGraph::Node>());
       // merge three indices into one
       std::map<Vertex, uint32_t> vertexMap;
-      for (size_t j=0; j<curGroup.size(); j++)
+      for (size_t j=0, f=0; j<g.faceSizes.size(); f+=g.faceSizes[j++])
       {
         /* iterate over all faces */
-        const std::vector<Vertex>& face = curGroup[j];
-        
+        const Vertex* face = &g.faceVertices[f];
+
         /* triangulate the face with a triangle fan */
         Vertex i0 = face[0], i1 = Vertex(-1), i2 = face[1];
-        for (size_t k=2; k < face.size(); k++) 
+        for (size_t k=2; k < g.faceSizes[j]; k++)
         {
           i1 = i2; i2 = face[k];
           uint32_t v0,v1,v2;
-          v0 = getVertex(vertexMap, mesh, i0);
-          v1 = getVertex(vertexMap, mesh, i1);
-          v2 = getVertex(vertexMap, mesh, i2);
+          v0 = getVertex(vertexMap, mesh, i0, g.counts);
+          v1 = getVertex(vertexMap, mesh, i1, g.counts);
+          v2 = getVertex(vertexMap, mesh, i2, g.counts);
           assert(v0 < mesh->numVertices());
           assert(v1 < mesh->numVertices());
           assert(v2 < mesh->numVertices());
@@ -584,35 +809,32 @@ namespace embree
       if (mesh->normals[0].size() == 0)
         mesh->normals.clear();
       mesh->verify();
+      return mesh.cast<SceneGraph::Node>();
     }
-    
-    curGroup.clear();
-    ec.clear();
   }
 
-   void OBJLoader::flushHairGroup()
-   {
-     if (curGroupHair.empty()) return;
-
-     avector<Vec3fa> vertices;
-     std::vector<SceneGraph::HairSetNode::Hair> curves;
-     
-     for (size_t i=0; i<curGroupHair.size(); i++) {
-       for (size_t j=0; j<curGroupHair[i].size(); j++) {
-         if (j%3 == 0) curves.push_back(SceneGraph::HairSetNode::Hair((unsigned int)vertices.size(),(unsigned int)i));
-         vertices.push_back(curGroupHair[i][j]);
-       }
-     }
-       
-     Ref<SceneGraph::HairSetNode> mesh = new SceneGraph::HairSetNode(vertices,curves,curMaterial,RTC_GEOMETRY_TYPE_FLAT_BEZIER_CURVE);
-     group->add(mesh.cast<SceneGraph::Node>());
-     mesh->verify();
-     curGroupHair.clear();
-   }
-   
+  /*! creates the hair set of a face group */
+  Ref<SceneGraph::Node> OBJLoader::createHairGroup(const FaceGroup& g)
+  {
+    if (g.hair.empty()) return nullptr;
+
+    avector<Vec3fa> vertices;
+    std::vector<SceneGraph::HairSetNode::Hair> curves;
+
+    for (size_t i=0; i<g.hair.size(); i++) {
+      for (size_t j=0; j<g.hair[i].size(); j++) {
+        if (j%3 == 0) curves.push_back(SceneGraph::HairSetNode::Hair((unsigned int)vertices.size(),(unsigned int)i));
+        vertices.push_back(g.hair[i][j]);
+      }
+    }
+
+    Ref<SceneGraph::HairSetNode> mesh = new SceneGraph::HairSetNode(vertices,curves,g.material,RTC_GEOMETRY_TYPE_FLAT_BEZIER_CURVE);
+    mesh->verify();
+    return mesh.cast<SceneGraph::Node>();
+  }
+
   Ref<SceneGraph::Node> loadOBJ(const FileName& fileName, const bool subdivMode, const bool combineIntoSingleObject) {
-    OBJLoader loader(fileName,subdivMode,combineIntoSingleObject); 
+    OBJLoader loader(fileName,subdivMode,combineIntoSingleObject);
     return loader.group.cast<SceneGraph::Node>();
   }
 }
-
@@ -2,6 +2,8 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include "ply_loader.h"
+#include "mapped_file.h"
+#include "../../../common/algorithms/parallel_prefix_sum.h"
 #include <list>
 
 namespace embree
@@ -90,10 +92,10 @@ namespace embree
       else return stringOfTypeTag(ty.ty);
     }
 
-    /* PLY parser class */
+    /* PLY parser class, the file gets memory mapped and the element data is decoded in parallel */
     struct PlyParser
     {
-      std::fstream fs;
+      MappedFile file;
       Mesh mesh;
       Ref<SceneGraph::Node> scene;
 
@@ -101,20 +103,17 @@ namespace embree
       enum Format { ASCII, BINARY_BIG_ENDIAN, BINARY_LITTLE_ENDIAN } format;
 
       /* constructor parses the input stream */
-      PlyParser(const FileName& fileName) : format(ASCII)
+      PlyParser(const FileName& fileName) : file(fileName), format(ASCII)
       {
-        /* open file */
-        fs.open (fileName.c_str(), std::fstream::in | std::fstream::binary);
-        if (!fs.is_open()) throw std::runtime_error("cannot open file : " + fileName.str());
-
         /* check for file signature */
-        std::string signature; getline(fs,signature);
+        size_t pos = 0;
+        std::string signature = getLine(pos);
         if (signature != "ply") throw std::runtime_error("invalid PLY file signature: " + signature);
-        
+
         /* read header */
         std::list<std::string> header;
         while (true) {
-          std::string line; getline(fs,line);
+          std::string line = getLine(pos);
           if (line == "end_header") break;
           if (line.find_first_of('#') == 0) continue;
           if (line == "") continue;
@@ -124,14 +123,33 @@ namespace embree
         /* parse header */
         parseHeader(header);
 
-        /* now parse all elements */
+        /* allocate data for all properties */
         for (std::vector<std::string>::iterator i = mesh.order.begin(); i!=mesh.order.end(); i++)
-          parseElementData(mesh.elements[*i]);
+          allocElementData(mesh.elements[*i]);
+
+        /* now parse all elements */
+        if (format == ASCII)
+          parseAsciiData(pos);
+        else
+          for (std::vector<std::string>::iterator i = mesh.order.begin(); i!=mesh.order.end(); i++)
+            pos = parseBinaryElementData(mesh.elements[*i],pos);
 
         /* create triangle mesh */
         scene = import();
       }
 
+      /* reads a header line, a trailing carriage return is ignored */
+      std::string getLine(size_t& pos)
+      {
+        if (pos >= file.bytes) throw std::runtime_error("unexpected end of PLY file");
+        const char* begin = file.ptr+pos;
+        const char* end = (const char*) memchr(begin,'\n',file.bytes-pos);
+        if (end == nullptr) end = file.ptr+file.bytes;
+        pos = min(size_t(end-file.ptr)+1,file.bytes);
+        if (end > begin && end[-1] == '\r') end--;
+        return std::string(begin,end);
+      }
+
       /* parse the PLY header */
       void parseHeader(std::list<std::string>& header) 
       {
@@ -208,80 +226,224 @@ namespace embree
         } else return Type(typeTagOfString(ty));
       }
 
-      /* parses data of a PLY element */
-      void parseElementData(Element& elt) 
+      /* allocates the data arrays of all properties of an element */
+      void allocElementData(Element& elt)
       {
-        /* allocate data for all properties */
         for (std::vector<std::string>::iterator i=elt.properties.begin(); i!=elt.properties.end(); i++) {
-          if (elt.type[*i].ty == Type::PTY_LIST) elt.list[*i] = std::vector<std::vector<size_t> >();
-          else elt.data[*i] = std::vector<float>();
+          if (elt.type[*i].ty == Type::PTY_LIST) elt.list[*i].resize(elt.size);
+          else elt.data[*i].resize(elt.size);
         }
-        
-        /* parse all elements */
-        for (size_t e=0; e<elt.size; e++)
+      }
+
+      /* list of properties of an element with direct pointers to their data arrays */
+      struct PropertyDecoder
+      {
+        PropertyDecoder (Element& elt)
         {
-          /* load all properties of the element */
           for (std::vector<std::string>::iterator i=elt.properties.begin(); i!=elt.properties.end(); i++) {
-            Type ty = elt.type[*i];
-            if (ty.ty == Type::PTY_LIST) loadPropertyList(elt.list[*i],ty.index,ty.data);
-            else loadPropertyData(elt.data[*i],ty.ty);
+            types.push_back(elt.type[*i]);
+            data.push_back(types.back().ty == Type::PTY_LIST ? nullptr : &elt.data[*i]);
+            list.push_back(types.back().ty == Type::PTY_LIST ? &elt.list[*i] : nullptr);
           }
         }
+
+        std::vector<Type> types;
+        std::vector<std::vector<float>*> data;
+        std::vector<std::vector<std::vector<size_t> >*> list;
+      };
+
+      /* ASCII elements are stored one per line, the lines are counted in
+       * parallel for chunks of the file, such that a prefix sum over the
+       * counts gives the element stored in the first line of each chunk */
+      void parseAsciiData(size_t pos)
+      {
+        /* calculate first line of each element type */
+        std::vector<Element*> elts;
+        std::vector<PropertyDecoder> decoders;
+        std::vector<size_t> firstLine(1,0);
+        for (std::vector<std::string>::iterator i = mesh.order.begin(); i!=mesh.order.end(); i++) {
+          elts.push_back(&mesh.elements[*i]);
+          decoders.push_back(PropertyDecoder(*elts.back()));
+          firstLine.push_back(firstLine.back()+elts.back()->size);
+        }
+        const size_t numLines = firstLine.back();
+
+        /* split data into chunks of about 1 MB */
+        const std::vector<size_t> bounds = file.splitLines(pos,file.bytes,(file.bytes-pos+(1<<20)-1)>>20);
+        const size_t numChunks = bounds.size()-1;
+
+        /* count non-empty lines of each chunk */
+        std::vector<size_t> lines(numChunks), lineOffset(numChunks);
+        parallel_for(numChunks, [&](const size_t c) {
+            std::string line;
+            size_t n = 0;
+            for (size_t p=bounds[c]; p<bounds[c+1]; )
+              if (getDataLine(p,bounds[c+1],line)) n++;
+            lines[c] = n;
+          });
+        if (parallel_prefix_sum(lines,lineOffset,numChunks,size_t(0),std::plus<size_t>()) < numLines)
+          throw std::runtime_error("unexpected end of PLY file");
+
+        /* parse all lines */
+        parallel_for(numChunks, [&](const size_t c)
+        {
+          std::string line;
+          size_t l = lineOffset[c];
+          size_t k = std::upper_bound(firstLine.begin(),firstLine.end(),l)-firstLine.begin()-1;
+          for (size_t p=bounds[c]; p<bounds[c+1] && l<numLines; )
+          {
+            if (!getDataLine(p,bounds[c+1],line)) continue;
+            while (l >= firstLine[k+1]) k++;
+
+            const char* token = line.c_str();
+            const PropertyDecoder& decoder = decoders[k];
+            const size_t e = l-firstLine[k];
+            for (size_t i=0; i<decoder.types.size(); i++)
+            {
+              const Type& ty = decoder.types[i];
+              if (ty.ty == Type::PTY_LIST) {
+                std::vector<size_t>& lst = (*decoder.list[i])[e];
+                lst.resize(parseAsciiInt(token));
+                for (size_t j=0; j<lst.size(); j++) lst[j] = parseAsciiInt(token);
+              }
+              else if (ty.ty == Type::PTY_FLOAT || ty.ty == Type::PTY_DOUBLE)
+                (*decoder.data[i])[e] = parseAsciiFloat(token);
+              else
+                (*decoder.data[i])[e] = float(parseAsciiInt(token));
+            }
+            l++;
+          }
+        });
+      }
+
+      /* copies the next line of the chunk, returns false for empty lines */
+      bool getDataLine(size_t& pos, size_t end, std::string& line) const
+      {
+        const char* begin = file.ptr+pos;
+        const char* eol = (const char*) memchr(begin,'\n',end-pos);
+        if (eol == nullptr) eol = file.ptr+end;
+        pos = eol-file.ptr+1;
+        line.assign(begin,eol);
+        return line.find_first_not_of(" \t\r") != std::string::npos;
+      }
+
+      int parseAsciiInt(const char*& token) const
+      {
+        char* next = nullptr;
+        const long i = strtol(token,&next,10);
+        if (next == token) throw std::runtime_error("invalid PLY element data");
+        token = next;
+        return int(i);
+      }
+
+      float parseAsciiFloat(const char*& token) const
+      {
+        char* next = nullptr;
+        const float f = strtof(token,&next);
+        if (next == token) throw std::runtime_error("invalid PLY element data");
+        token = next;
+        return f;
+      }
+
+      /* parses binary data of a PLY element, records of elements without
+       * list properties have a fixed size, otherwise the start of each
+       * record is found by a sequential scan over the list sizes */
+      size_t parseBinaryElementData(Element& elt, size_t pos)
+      {
+        PropertyDecoder decoder(elt);
+        bool fixedSize = true;
+        size_t recordBytes = 0;
+        for (size_t i=0; i<decoder.types.size(); i++) {
+          if (decoder.types[i].ty == Type::PTY_LIST) fixedSize = false;
+          else recordBytes += sizeOfType(decoder.types[i].ty);
+        }
+
+        std::vector<size_t> records;
+        const size_t begin = pos;
+        if (fixedSize)
+        {
+          if (recordBytes && elt.size > (file.bytes-pos)/recordBytes) throw std::runtime_error("unexpected end of PLY file");
+          pos += elt.size*recordBytes;
+        }
+        else
+        {
+          records.resize(elt.size);
+          for (size_t e=0; e<elt.size; e++)
+          {
+            records[e] = pos;
+            for (size_t i=0; i<decoder.types.size(); i++)
+            {
+              const Type& ty = decoder.types[i];
+              if (ty.ty == Type::PTY_LIST) {
+                const size_t num = loadInteger(ty.index,pos);
+                pos += num*sizeOfType(ty.data);
+              }
+              else pos += sizeOfType(ty.ty);
+              if (pos > file.bytes) throw std::runtime_error("unexpected end of PLY file");
+            }
+          }
+        }
+
+        /* decode all records */
+        parallel_for(size_t(0), elt.size, size_t(4096), [&](const range<size_t>& r)
+        {
+          for (size_t e=r.begin(); e<r.end(); e++)
+          {
+            size_t p = fixedSize ? begin + e*recordBytes : records[e];
+            for (size_t i=0; i<decoder.types.size(); i++)
+            {
+              const Type& ty = decoder.types[i];
+              if (ty.ty == Type::PTY_LIST) {
+                std::vector<size_t>& lst = (*decoder.list[i])[e];
+                lst.resize(loadInteger(ty.index,p));
+                for (size_t j=0; j<lst.size(); j++) lst[j] = loadInteger(ty.data,p);
+              }
+              else (*decoder.data[i])[e] = loadFloat(ty.ty,p);
+            }
+          }
+        });
+        return pos;
       }
 
       /* load bytes from file and take care of little and big endian encoding */
-      void readBytes(void* dst, int num) {
-        if (format == BINARY_LITTLE_ENDIAN) fs.read((char*)dst,num);
-        else if (format == BINARY_BIG_ENDIAN) for (int i=0; i<num; i++) fs.read((char*)dst+num-i-1,1);
-        else throw std::runtime_error("internal error on PLY loader");
+      template<typename T>
+      T read(size_t& pos) const
+      {
+        if (pos+sizeof(T) > file.bytes) throw std::runtime_error("unexpected end of PLY file");
+        T r;
+        char* dst = (char*) &r;
+        if (format == BINARY_LITTLE_ENDIAN) memcpy(dst,file.ptr+pos,sizeof(T));
+        else for (size_t i=0; i<sizeof(T); i++) dst[sizeof(T)-i-1] = file.ptr[pos+i];
+        pos += sizeof(T);
+        return r;
       }
-      
-      int            read_ascii_int  () { int i;   fs >> i; return i; }
-      float          read_ascii_float() { float f; fs >> f; return f; }
-      signed char    read_char  () { if (format == ASCII) return read_ascii_int();   signed char r = 0;    readBytes(&r,1); return r; }
-      unsigned char  read_uchar () { if (format == ASCII) return read_ascii_int();   unsigned char r = 0;  readBytes(&r,1); return r; }
-      signed short   read_short () { if (format == ASCII) return read_ascii_int();   signed short r = 0;   readBytes(&r,2); return r; }
-      unsigned short read_ushort() { if (format == ASCII) return read_ascii_int();   unsigned short r = 0; readBytes(&r,2); return r; }
-      signed int     read_int   () { if (format == ASCII) return read_ascii_int();   signed int r = 0;     readBytes(&r,4); return r; }
-      unsigned int   read_uint  () { if (format == ASCII) return read_ascii_int();   unsigned int r = 0;   readBytes(&r,4); return r; }
-      float          read_float () { if (format == ASCII) return read_ascii_float(); float r = 0;          readBytes(&r,4); return r; }
-      double         read_double() { if (format == ASCII) return read_ascii_float(); double r = 0;         readBytes(&r,8); return r; }
 
       /* load an integer type */
-      size_t loadInteger(Type::Tag ty)
+      size_t loadInteger(Type::Tag ty, size_t& pos) const
       {
         switch (ty) {
-        case Type::PTY_CHAR   : return read_char(); break;
-        case Type::PTY_UCHAR  : return read_uchar(); break;
-        case Type::PTY_SHORT  : return read_short(); break;
-        case Type::PTY_USHORT : return read_ushort(); break;
-        case Type::PTY_INT    : return read_int(); break;
-        case Type::PTY_UINT   : return read_uint(); break;
+        case Type::PTY_CHAR   : return read<signed char>(pos); break;
+        case Type::PTY_UCHAR  : return read<unsigned char>(pos); break;
+        case Type::PTY_SHORT  : return read<signed short>(pos); break;
+        case Type::PTY_USHORT : return read<unsigned short>(pos); break;
+        case Type::PTY_INT    : return read<signed int>(pos); break;
+        case Type::PTY_UINT   : return read<unsigned int>(pos); break;
         default : throw std::runtime_error("invalid type"); return 0;
         }
       }
-        
-      /* load a list */
-      void loadPropertyList(std::vector<std::vector<size_t> >& vec,Type::Tag index_ty,Type::Tag data_ty)
-      {
-        std::vector<size_t> lst;
-        size_t num = loadInteger(index_ty);
-        for (size_t i=0; i<num; i++) lst.push_back(loadInteger(data_ty));
-        vec.push_back(lst);
-      }
 
       /* load a data element */
-      void loadPropertyData(std::vector<float>& vec, Type::Tag ty) 
+      float loadFloat(Type::Tag ty, size_t& pos) const
       {
         switch (ty) {
-        case Type::PTY_CHAR   : vec.push_back(float(read_char()));   break;
-        case Type::PTY_UCHAR  : vec.push_back(float(read_uchar()));  break;
-        case Type::PTY_SHORT  : vec.push_back(float(read_short()));  break;
-        case Type::PTY_USHORT : vec.push_back(float(read_ushort())); break;
-        case Type::PTY_INT    : vec.push_back(float(read_int()));    break;
-        case Type::PTY_UINT   : vec.push_back(float(read_uint()));   break;
-        case Type::PTY_FLOAT  : vec.push_back(float(read_float()));  break;
-        case Type::PTY_DOUBLE : vec.push_back(float(read_double())); break;
+        case Type::PTY_CHAR   : return float(read<signed char>(pos));
+        case Type::PTY_UCHAR  : return float(read<unsigned char>(pos));
+        case Type::PTY_SHORT  : return float(read<signed short>(pos));
+        case Type::PTY_USHORT : return float(read<unsigned short>(pos));
+        case Type::PTY_INT    : return float(read<signed int>(pos));
+        case Type::PTY_UINT   : return float(read<unsigned int>(pos));
+        case Type::PTY_FLOAT  : return float(read<float>(pos));
+        case Type::PTY_DOUBLE : return float(read<double>(pos));
         default : throw std::runtime_error("invalid type");
         }
       }
@@ -7,6 +7,9 @@
 #include "obj_loader.h"
 #include "ply_loader.h"
 #include "corona_loader.h"
+#include "ebs_loader.h"
+#include "ebs_writer.h"
+#include "../../../common/algorithms/parallel_for.h"
 
 namespace embree
 {
@@ -18,6 +21,7 @@ namespace embree
     else if (toLowerCase(filename.ext()) == std::string("ply" )) return loadPLY(filename);
     else if (toLowerCase(filename.ext()) == std::string("xml" )) return loadXML(filename);
     else if (toLowerCase(filename.ext()) == std::string("scn" )) return loadCorona(filename);
+    else if (toLowerCase(filename.ext()) == std::string("ebs" )) return loadEBS(filename);
     else throw std::runtime_error("unknown scene format: " + filename.ext());
   }
 
@@ -26,6 +30,9 @@ namespace embree
     if (toLowerCase(filename.ext()) == std::string("xml")) {
       storeXML(root,filename,embedTextures,referenceMaterials);
     }
+    else if (toLowerCase(filename.ext()) == std::string("ebs")) {
+      storeEBS(root,filename);
+    }
     else
       throw std::runtime_error("unknown scene format: " + filename.ext());
   }
@@ -1740,6 +1747,278 @@ namespace embree
     }
   }
 
+  /*! Detects static triangle and quad meshes that are copies of each
+   *  other up to a rigid transformation and replaces all copies by
+   *  transform nodes that reference a single mesh. Meshes are first
+   *  hashed in parallel by their topology, texture coordinates,
+   *  material, and vertex distances to the centroid, which are all
+   *  invariant under rigid transformations. Meshes with equal hash are
+   *  then compared in parallel: the transformation is derived from a
+   *  frame spanned by two vertices and verified for all vertices and
+   *  normals. */
+  struct DuplicateInstancer
+  {
+    struct Mesh
+    {
+      enum Type { TRIANGLE_MESH, QUAD_MESH };
+
+      Mesh (Ref<SceneGraph::Node> node)
+        : node(node), type(TRIANGLE_MESH), positions(nullptr), normals(nullptr), topology(nullptr), topologyBytes(0), texcoords(nullptr), texcoordBytes(0), material(nullptr),
+          hash(0), center(zero), radius(0.0f), anchor0(0), anchor1(0), frame(one), valid(false) {}
+
+      Ref<SceneGraph::Node> node;
+      Type type;
+      const avector<Vec3fa>* positions;
+      const avector<Vec3fa>* normals;
+      const char* topology;         //!< triangle or quad index buffer
+      size_t topologyBytes;
+      const char* texcoords;
+      size_t texcoordBytes;
+      SceneGraph::MaterialNode* material;
+
+      uint64_t hash;
+      Vec3fa center;
+      float radius;
+      size_t anchor0, anchor1;      //!< vertices that span the frame of reference meshes
+      LinearSpace3fa frame;
+      bool valid;
+    };
+
+    DuplicateInstancer (Ref<SceneGraph::Node> root)
+    {
+      collect(root);
+
+      /* hash all meshes in parallel */
+      parallel_for(meshes.size(), [&](const size_t i) { analyse(meshes[i]); });
+
+      /* group meshes with equal hash in the order they appear in the scene */
+      std::map<uint64_t,size_t> bucketMap;
+      std::vector<std::vector<size_t>> buckets;
+      for (size_t i=0; i<meshes.size(); i++) {
+        if (!meshes[i].valid) continue;
+        auto entry = bucketMap.find(meshes[i].hash);
+        if (entry == bucketMap.end()) {
+          bucketMap[meshes[i].hash] = buckets.size();
+          buckets.push_back(std::vector<size_t>(1,i));
+        }
+        else
+          buckets[entry->second].push_back(i);
+      }
+
+      /* match meshes of each bucket against the first mesh of each distinct shape */
+      std::vector<Ref<SceneGraph::Node>> instances(meshes.size());
+      parallel_for(buckets.size(), [&](const size_t b)
+      {
+        if (buckets[b].size() < 2) return;
+        std::vector<size_t> references;
+        for (size_t i : buckets[b])
+        {
+          bool found = false;
+          for (size_t r : references)
+          {
+            AffineSpace3fa space;
+            if (!match(meshes[r],meshes[i],space)) continue;
+            instances[i] = new SceneGraph::TransformNode(space,meshes[r].node);
+            instances[i]->name = meshes[i].node->name;
+            found = true;
+            break;
+          }
+          if (!found) {
+            setupFrame(meshes[i]);
+            references.push_back(i);
+          }
+        }
+      });
+
+      /* replace duplicated meshes in the scene graph */
+      for (size_t i=0; i<meshes.size(); i++)
+        if (instances[i]) replacement[meshes[i].node.ptr] = instances[i];
+
+      for (Ref<SceneGraph::Node>* slot : slots) {
+        auto entry = replacement.find(slot->ptr);
+        if (entry != replacement.end()) *slot = entry->second;
+      }
+    }
+
+    void addMesh(Ref<SceneGraph::Node>& slot)
+    {
+      slots.push_back(&slot);
+      if (visited.find(slot.ptr) != visited.end()) return;
+      visited.insert(slot.ptr);
+
+      Mesh mesh(slot);
+      if (Ref<SceneGraph::TriangleMeshNode> tmesh = slot.dynamicCast<SceneGraph::TriangleMeshNode>())
+      {
+        if (tmesh->numTimeSteps() != 1) return;
+        mesh.type = Mesh::TRIANGLE_MESH;
+        mesh.positions = &tmesh->positions[0];
+        mesh.normals = tmesh->normals.size() ? &tmesh->normals[0] : nullptr;
+        mesh.topology = (const char*) tmesh->triangles.data();
+        mesh.topologyBytes = tmesh->triangles.size()*sizeof(SceneGraph::TriangleMeshNode::Triangle);
+        mesh.texcoords = (const char*) tmesh->texcoords.data();
+        mesh.texcoordBytes = tmesh->texcoords.size()*sizeof(Vec2f);
+        mesh.material = tmesh->material.ptr;
+      }
+      else if (Ref<SceneGraph::QuadMeshNode> qmesh = slot.dynamicCast<SceneGraph::QuadMeshNode>())
+      {
+        if (qmesh->numTimeSteps() != 1) return;
+        mesh.type = Mesh::QUAD_MESH;
+        mesh.positions = &qmesh->positions[0];
+        mesh.normals = qmesh->normals.size() ? &qmesh->normals[0] : nullptr;
+        mesh.topology = (const char*) qmesh->quads.data();
+        mesh.topologyBytes = qmesh->quads.size()*sizeof(SceneGraph::QuadMeshNode::Quad);
+        mesh.texcoords = (const char*) qmesh->texcoords.data();
+        mesh.texcoordBytes = qmesh->texcoords.size()*sizeof(Vec2f);
+        mesh.material = qmesh->material.ptr;
+      }
+      else
+        return;
+
+      if (mesh.positions->size() == 0) return;
+      meshes.push_back(mesh);
+    }
+
+    void collect(Ref<SceneGraph::Node>& node)
+    {
+      if (Ref<SceneGraph::TransformNode> xfmNode = node.dynamicCast<SceneGraph::TransformNode>()) {
+        if (visited.find(node.ptr) != visited.end()) return;
+        visited.insert(node.ptr);
+        collect(xfmNode->child);
+      }
+      else if (Ref<SceneGraph::GroupNode> groupNode = node.dynamicCast<SceneGraph::GroupNode>()) {
+        if (visited.find(node.ptr) != visited.end()) return;
+        visited.insert(node.ptr);
+        for (auto& child : groupNode->children) collect(child);
+      }
+      else
+        addMesh(node);
+    }
+
+    static uint64_t hashBytes(uint64_t hash, const char* data, size_t bytes)
+    {
+      for (size_t i=0; i<bytes; i++)
+        hash = (hash ^ (unsigned char)data[i]) * 0x100000001b3ull;
+      return hash;
+    }
+
+    template<typename T>
+    static uint64_t hashValue(uint64_t hash, const T& value) {
+      return hashBytes(hash,(const char*)&value,sizeof(T));
+    }
+
+    static void analyse(Mesh& mesh)
+    {
+      const avector<Vec3fa>& positions = *mesh.positions;
+      const size_t N = positions.size();
+
+      double cx = 0.0, cy = 0.0, cz = 0.0;
+      for (size_t i=0; i<N; i++) {
+        cx += positions[i].x; cy += positions[i].y; cz += positions[i].z;
+      }
+      mesh.center = Vec3fa(float(cx/N),float(cy/N),float(cz/N));
+
+      float radius = 0.0f;
+      double sumDist = 0.0;
+      for (size_t i=0; i<N; i++) {
+        const float dist = length(positions[i]-mesh.center);
+        radius = max(radius,dist);
+        sumDist += dist;
+      }
+      mesh.radius = radius;
+      if (!std::isfinite(radius)) return;
+
+      uint64_t hash = 0xcbf29ce484222325ull;
+      hash = hashValue(hash,mesh.type);
+      hash = hashValue(hash,N);
+      hash = hashValue(hash,mesh.material);
+      hash = hashValue(hash,mesh.normals ? mesh.normals->size() : size_t(0));
+      hash = hashBytes(hash,mesh.topology,mesh.topologyBytes);
+      hash = hashBytes(hash,mesh.texcoords,mesh.texcoordBytes);
+
+      /* the radius and the mean vertex distance to the centroid are invariant under rigid
+       * transformations, they are coarsely quantized such that rounding rarely changes the hash */
+      if (radius > 0.0f) {
+        hash = hashValue(hash,int(floor(log2(radius)*64.0f)));
+        hash = hashValue(hash,int(floor(float(sumDist/N)/radius*64.0f)));
+      }
+
+      mesh.hash = hash;
+      mesh.valid = true;
+    }
+
+    /* the frame is spanned by the vertex farthest from the centroid and the vertex that is least collinear to it */
+    static void setupFrame(Mesh& mesh)
+    {
+      const avector<Vec3fa>& positions = *mesh.positions;
+      float maxDist = 0.0f, maxArea = 0.0f;
+      for (size_t i=0; i<positions.size(); i++) {
+        const float dist = length(positions[i]-mesh.center);
+        if (dist > maxDist) { maxDist = dist; mesh.anchor0 = i; }
+      }
+      const Vec3fa d0 = positions[mesh.anchor0]-mesh.center;
+      for (size_t i=0; i<positions.size(); i++) {
+        const float area = length(cross(d0,positions[i]-mesh.center));
+        if (area > maxArea) { maxArea = area; mesh.anchor1 = i; }
+      }
+      mesh.frame = getFrame(mesh,mesh.anchor0,mesh.anchor1);
+    }
+
+    static LinearSpace3fa getFrame(const Mesh& mesh, size_t anchor0, size_t anchor1)
+    {
+      const avector<Vec3fa>& positions = *mesh.positions;
+      const Vec3fa d0 = positions[anchor0]-mesh.center;
+      const Vec3fa d1 = positions[anchor1]-mesh.center;
+      const Vec3fa n = cross(d0,d1);
+      if (dot(d0,d0) == 0.0f || dot(n,n) == 0.0f) return one;
+      const Vec3fa vx = normalize(d0);
+      const Vec3fa vz = normalize(n);
+      return LinearSpace3fa(vx,cross(vz,vx),vz);
+    }
+
+    static bool match(const Mesh& ref, const Mesh& mesh, AffineSpace3fa& space)
+    {
+      if (ref.type != mesh.type) return false;
+      if (ref.material != mesh.material) return false;
+      if (ref.positions->size() != mesh.positions->size()) return false;
+      if ((ref.normals != nullptr) != (mesh.normals != nullptr)) return false;
+      if (ref.topologyBytes != mesh.topologyBytes || memcmp(ref.topology,mesh.topology,ref.topologyBytes) != 0) return false;
+      if (ref.texcoordBytes != mesh.texcoordBytes || memcmp(ref.texcoords,mesh.texcoords,ref.texcoordBytes) != 0) return false;
+
+      /* rotate the frame of the reference onto the frame of the mesh */
+      const LinearSpace3fa rotation = getFrame(mesh,ref.anchor0,ref.anchor1) * ref.frame.transposed();
+      space = AffineSpace3fa(rotation,mesh.center - xfmVector(rotation,ref.center));
+
+      /* tolerate float rounding of transformed vertex coordinates */
+      const float tolerance = 1E-5f*(ref.radius + max(reduce_max(abs(ref.center)),reduce_max(abs(mesh.center))));
+      const avector<Vec3fa>& p0 = *ref.positions;
+      const avector<Vec3fa>& p1 = *mesh.positions;
+      for (size_t i=0; i<p0.size(); i++)
+        if (reduce_max(abs(xfmPoint(space,p0[i])-p1[i])) > tolerance) return false;
+
+      if (ref.normals)
+      {
+        const avector<Vec3fa>& n0 = *ref.normals;
+        const avector<Vec3fa>& n1 = *mesh.normals;
+        if (n0.size() != n1.size()) return false;
+        for (size_t i=0; i<n0.size(); i++)
+          if (reduce_max(abs(xfmVector(rotation,n0[i])-n1[i])) > 1E-4f*max(1.0f,reduce_max(abs(n0[i])))) return false;
+      }
+      return true;
+    }
+
+  private:
+    std::vector<Mesh> meshes;
+    std::vector<Ref<SceneGraph::Node>*> slots;
+    std::set<SceneGraph::Node*> visited;
+    std::map<SceneGraph::Node*,Ref<SceneGraph::Node>> replacement;
+  };
+
+  Ref<SceneGraph::Node> SceneGraph::convert_duplicates_to_instances(Ref<SceneGraph::Node> node)
+  {
+    DuplicateInstancer instancer(node);
+    return node;
+  }
+
   struct SceneGraphFlattener
   {
     Ref<SceneGraph::Node> node;
@@ -46,6 +46,7 @@ namespace embree
 
     Ref<Node> remove_mblur(Ref<Node> node, bool mblur);
     void convert_mblur_to_nonmblur(Ref<Node> node);
+    Ref<Node> convert_duplicates_to_instances(Ref<Node> node);
 
     struct Statistics
     {
@@ -431,6 +431,10 @@ namespace embree
     registerOption("convert-mblur-to-nonmblur", [this] (Ref<ParseStream> cin, const FileName& path) {
          sgop.push_back(CONVERT_MBLUR_TO_NONMBLUR);
       }, "--convert-mblur-to-nonmblur: converts all motion blur geometry to non-motion blur geometry");
+
+    registerOption("convert-duplicates-to-instances", [this] (Ref<ParseStream> cin, const FileName& path) {
+         sgop.push_back(CONVERT_DUPLICATES_TO_INSTANCES);
+      }, "--convert-duplicates-to-instances: replaces triangle and quad meshes that are rigidly transformed copies of each other by instances of a single mesh, use with --instancing geometry");
     
     registerOption("remove-mblur", [this] (Ref<ParseStream> cin, const FileName& path) {
          remove_mblur = true;
@@ -655,6 +659,8 @@ namespace embree
     //Statistics stat;
     FilteredStatistics fpsStat(0.5f,0.0f);
     FilteredStatistics mraypsStat(0.5f,0.0f);
+    std::vector<float> fpsFrames;
+    std::vector<float> mraypsFrames;
     {
       size_t numTotalFrames = skipBenchmarkFrames + numBenchmarkFrames;
       for (size_t i=0; i<skipBenchmarkFrames; i++)
@@ -675,9 +681,11 @@ namespace embree
 
         float fps = float(1.0/(t1-t0));
         fpsStat.add(fps);
+        fpsFrames.push_back(fps);
 
         float mrayps = float(double(getNumRays())/(1000000.0*(t1-t0)));
         mraypsStat.add(mrayps);
+        mraypsFrames.push_back(mrayps);
 
         if (numTotalFrames >= 1024 && (i % 64 == 0))
         {
@@ -704,12 +712,20 @@ namespace embree
     std::cout << "BENCHMARK_RENDER_SIGMA " << fpsStat.getSigma() << std::endl;
     std::cout << "BENCHMARK_RENDER_AVG_SIGMA " << fpsStat.getAvgSigma() << std::endl;
 
+    /* unfiltered per frame results, used by scripts/benchmark_suite.py to compute percentiles */
+    std::cout << "BENCHMARK_RENDER_FRAMES";
+    for (size_t i=0; i<fpsFrames.size(); i++) std::cout << " " << fpsFrames[i];
+    std::cout << std::endl;
+
 #if defined(RAY_STATS)
     std::cout << "BENCHMARK_RENDER_MRAYPS_MIN " << mraypsStat.getMin() << std::endl;
     std::cout << "BENCHMARK_RENDER_MRAYPS_AVG " << mraypsStat.getAvg() << std::endl;
     std::cout << "BENCHMARK_RENDER_MRAYPS_MAX " << mraypsStat.getMax() << std::endl;
     std::cout << "BENCHMARK_RENDER_MRAYPS_SIGMA " << mraypsStat.getSigma() << std::endl;
     std::cout << "BENCHMARK_RENDER_MRAYPS_AVG_SIGMA " << mraypsStat.getAvgSigma() << std::endl;
+    std::cout << "BENCHMARK_RENDER_MRAYPS_FRAMES";
+    for (size_t i=0; i<mraypsFrames.size(); i++) std::cout << " " << mraypsFrames[i];
+    std::cout << std::endl;
 #endif
 
     std::cout << std::flush;
@@ -1312,6 +1328,7 @@ namespace embree
       case CONVERT_QUADS_TO_GRIDS       : scene->quads_to_grids(grid_resX,grid_resY); break;
       case CONVERT_GRIDS_TO_QUADS       : scene->grids_to_quads(); break;
       case CONVERT_MBLUR_TO_NONMBLUR    : convert_mblur_to_nonmblur(scene.dynamicCast<SceneGraph::Node>()); break;
+      case CONVERT_DUPLICATES_TO_INSTANCES : convert_duplicates_to_instances(scene.dynamicCast<SceneGraph::Node>()); break;
       default : throw std::runtime_error("unsupported scene graph operation");
       }
     }
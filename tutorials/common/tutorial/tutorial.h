@@ -205,6 +205,7 @@ namespace embree
       CONVERT_QUADS_TO_GRIDS,
       CONVERT_GRIDS_TO_QUADS,
       CONVERT_MBLUR_TO_NONMBLUR,
+      CONVERT_DUPLICATES_TO_INSTANCES,
     };
     std::vector<SceneGraphOperations> sgop;
 
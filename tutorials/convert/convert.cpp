@@ -191,6 +191,11 @@ namespace embree
         g_scene->bspline_to_bezier();
       }
 
+      /* convert rigidly transformed copies of meshes to instances */
+      else if (tag == "-convert-duplicates-to-instances") {
+        SceneGraph::convert_duplicates_to_instances(g_scene.dynamicCast<SceneGraph::Node>());
+      }
+
       /* flatten scene */
       else if (tag == "-flatten-group") {
         g_scene = SceneGraph::flatten(g_scene,SceneGraph::INSTANCING_GROUP);
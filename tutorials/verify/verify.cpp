@@ -11,6 +11,7 @@
 #include "../../kernels/common/context.h"
 #include "../../kernels/common/geometry.h"
 #include "../../kernels/common/scene.h"
+#include "../../kernels/subdiv/tessellation_cache.h"
 #include <regex>
 #include <stack>
 
@@ -2055,6 +2056,108 @@ namespace embree
     }
   };
 
+  struct InterpolateBatchTest : public VerifyApplication::Test
+  {
+    RTCGeometryType gtype;
+    
+    InterpolateBatchTest (std::string name, int isa, RTCGeometryType gtype)
+      : VerifyApplication::Test(name,isa,VerifyApplication::TEST_SHOULD_PASS), gtype(gtype) {}
+
+    /* compares a batch interpolation of unsorted samples against single interpolations */
+    bool checkBatch(RTCGeometry geom, RTCBufferType bufferType, unsigned int bufferSlot, unsigned int valueCount, unsigned int numPrims)
+    {
+      const unsigned int N = 10001; // large enough for the parallel sort
+      std::vector<int> valid(N);
+      std::vector<unsigned int> primIDs(N);
+      std::vector<float> u(N), v(N);
+      for (unsigned int i=0; i<N; i++) {
+        valid[i] = i%7 == 3 ? 0 : -1;
+        primIDs[i] = random_int()%numPrims;
+        u[i] = random_float();
+        v[i] = random_float();
+        if (gtype == RTC_GEOMETRY_TYPE_TRIANGLE && u[i]+v[i] > 1.0f) { u[i] = 1.0f-u[i]; v[i] = 1.0f-v[i]; }
+      }
+      
+      const float nan = std::numeric_limits<float>::quiet_NaN();
+      std::vector<float> P(N*valueCount,nan), dPdu(N*valueCount,nan), dPdv(N*valueCount,nan);
+      RTCInterpolateNArguments args;
+      args.geometry = geom;
+      args.valid = valid.data();
+      args.primIDs = primIDs.data();
+      args.u = u.data();
+      args.v = v.data();
+      args.N = N;
+      args.bufferType = bufferType;
+      args.bufferSlot = bufferSlot;
+      args.P = P.data();
+      args.dPdu = dPdu.data();
+      args.dPdv = dPdv.data();
+      args.ddPdudu = nullptr;
+      args.ddPdvdv = nullptr;
+      args.ddPdudv = nullptr;
+      args.valueCount = valueCount;
+      rtcInterpolateBatch(&args);
+      
+      bool passed = true;
+      for (unsigned int i=0; i<N; i++)
+      {
+        if (!valid[i]) {
+          passed &= std::isnan(P[i]); // invalid samples are not written
+          continue;
+        }
+        float P1[256], dPdu1[256], dPdv1[256];
+        rtcInterpolate1(geom,primIDs[i],u[i],v[i],bufferType,bufferSlot,P1,dPdu1,dPdv1,valueCount);
+        for (unsigned int j=0; j<valueCount; j++) {
+          passed &= fabsf(P[j*N+i]-P1[j]) < 1E-4f;
+          passed &= fabsf(dPdu[j*N+i]-dPdu1[j]) < 1E-3f;
+          passed &= fabsf(dPdv[j*N+i]-dPdv1[j]) < 1E-3f;
+        }
+      }
+      return passed;
+    }
+    
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      const unsigned int valueCount = 7;
+      RTCGeometry geom = rtcNewGeometry(device, gtype);
+      AssertNoError(device);
+      rtcSetGeometryVertexAttributeCount(geom,1);
+
+      unsigned int numPrims = 0;
+      if (gtype == RTC_GEOMETRY_TYPE_SUBDIVISION) {
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT, interpolation_quad_indices, 0, sizeof(unsigned int), num_interpolation_quad_faces*4);
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_FACE,  0, RTC_FORMAT_UINT, interpolation_quad_faces,   0, sizeof(unsigned int), num_interpolation_quad_faces);
+        numPrims = num_interpolation_quad_faces;
+      } else {
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, interpolation_triangle_indices, 0, 3*sizeof(unsigned int), num_interpolation_triangle_faces);
+        numPrims = num_interpolation_triangle_faces;
+      }
+      AssertNoError(device);
+      
+      std::vector<float> vertices0(num_interpolation_vertices*3+16);
+      for (size_t i=0; i<vertices0.size(); i++) vertices0[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices0.data(), 0, 3*sizeof(float), num_interpolation_vertices);
+      std::vector<float> user_vertices0(num_interpolation_vertices*valueCount+16);
+      for (size_t i=0; i<user_vertices0.size(); i++) user_vertices0[i] = random_float();
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE, 0, RTCFormat(RTC_FORMAT_FLOAT+valueCount), user_vertices0.data(), 0, valueCount*sizeof(float), num_interpolation_vertices);
+      rtcCommitGeometry(geom);
+      AssertNoError(device);
+
+      bool passed = true;
+      passed &= checkBatch(geom,RTC_BUFFER_TYPE_VERTEX,0,3,numPrims);
+      passed &= checkBatch(geom,RTC_BUFFER_TYPE_VERTEX_ATTRIBUTE,0,valueCount,numPrims);
+      AssertNoError(device);
+
+      rtcReleaseGeometry(geom);
+      AssertNoError(device);
+      return (VerifyApplication::TestReturnValue) passed;
+    }
+  };
+
   struct InterpolateTrianglesTest : public VerifyApplication::Test
   {
     size_t N;
@@ -2834,6 +2937,52 @@ namespace embree
       return (VerifyApplication::TestReturnValue) passed;
     }
   };
+
+  struct DuplicateInstancingTest : public VerifyApplication::Test
+  {
+    DuplicateInstancingTest (std::string name)
+      : VerifyApplication::Test(name,0,VerifyApplication::TEST_SHOULD_PASS) {}
+
+    static Ref<SceneGraph::TriangleMeshNode> createSphere(const Vec3fa& center, size_t numNormals)
+    {
+      Ref<SceneGraph::TriangleMeshNode> mesh = SceneGraph::createTriangleSphere(center,1.0f,16,nullptr).dynamicCast<SceneGraph::TriangleMeshNode>();
+      mesh->normals.push_back(avector<Vec3fa>(numNormals));
+      for (size_t i=0; i<numNormals; i++)
+        mesh->normals[0][i] = normalize(mesh->positions[0][i]-center);
+      return mesh;
+    }
+
+    static Ref<SceneGraph::TriangleMeshNode> transform(Ref<SceneGraph::TriangleMeshNode> mesh, const AffineSpace3fa& space)
+    {
+      for (auto& p : mesh->positions[0]) p = xfmPoint(space,p);
+      for (auto& n : mesh->normals[0]) n = xfmVector(space,n);
+      return mesh;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      /* rotated and translated copies become instances unless they are mirrored or their number of normals differs */
+      Ref<SceneGraph::TriangleMeshNode> sphere = createSphere(Vec3fa(0.0f),0);
+      const size_t N = sphere->positions[0].size();
+      const AffineSpace3fa rotation(LinearSpace3fa::rotate(Vec3fa(1.0f,2.0f,3.0f),0.7f),Vec3fa(5.0f,-2.0f,1.0f));
+      const AffineSpace3fa mirror(LinearSpace3fa::scale(Vec3fa(-1.0f,1.0f,1.0f)),Vec3fa(-3.0f,0.0f,0.0f));
+      Ref<SceneGraph::GroupNode> group = new SceneGraph::GroupNode;
+      group->add(createSphere(Vec3fa(0.0f),N).dynamicCast<SceneGraph::Node>());
+      group->add(createSphere(Vec3fa(3.0f,0.0f,0.0f),N/2).dynamicCast<SceneGraph::Node>());
+      group->add(createSphere(Vec3fa(0.0f,3.0f,0.0f),N).dynamicCast<SceneGraph::Node>());
+      group->add(transform(createSphere(Vec3fa(0.0f),N),rotation).dynamicCast<SceneGraph::Node>());
+      group->add(transform(createSphere(Vec3fa(0.0f),N),mirror).dynamicCast<SceneGraph::Node>());
+      SceneGraph::convert_duplicates_to_instances(group.dynamicCast<SceneGraph::Node>());
+
+      bool passed = true;
+      passed &= bool(group->children[0].dynamicCast<SceneGraph::TriangleMeshNode>());
+      passed &= bool(group->children[1].dynamicCast<SceneGraph::TriangleMeshNode>());
+      passed &= bool(group->children[2].dynamicCast<SceneGraph::TransformNode>());
+      passed &= bool(group->children[3].dynamicCast<SceneGraph::TransformNode>());
+      passed &= bool(group->children[4].dynamicCast<SceneGraph::TriangleMeshNode>());
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
     
   struct InactiveRaysTest : public VerifyApplication::IntersectTest
   {
@@ -4020,130 +4169,1475 @@ namespace embree
       return VerifyApplication::PASSED;
     }
   };
-  
-  /////////////////////////////////////////////////////////////////////////////////
-  /////////////////////////////////////////////////////////////////////////////////
-  /////////////////////////////////////////////////////////////////////////////////
-  /////////////////////////////////////////////////////////////////////////////////
 
-  void shootRandomRays (int hash, std::vector<IntersectMode>& intersectModes, std::vector<IntersectVariant>& intersectVariants, const VerifyScene& scene)
+  struct CurveLODTest : public VerifyApplication::Test
   {
-    RandomSampler sampler;
-    RandomSampler_init(sampler,hash);
+    CurveLODTest (std::string name, int isa)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS)
+    {}
 
-    const size_t numRays = 100;
-    for (auto imode : intersectModes)
+    float trace(RTCScene scene, RTCIntersectContext* context)
     {
-      for (auto ivariant : intersectVariants)
-      {
-        if (!has_variant(imode,ivariant)) continue;
+      RTCRayHit rayHit;
+      rayHit.ray.org_x = 0;
+      rayHit.ray.org_y = 0;
+      rayHit.ray.org_z = -5;
+      rayHit.ray.dir_x = 0;
+      rayHit.ray.dir_y = 0;
+      rayHit.ray.dir_z = 1;
+      rayHit.ray.tnear = 0;
+      rayHit.ray.tfar = 100000;
+      rayHit.ray.mask = -1;
+      rayHit.ray.flags = 0u;
+      rayHit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+      rayHit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+      rtcIntersect1(scene, context, &rayHit);
+      if (rayHit.hit.geomID == RTC_INVALID_GEOMETRY_ID) return -1.0f;
+      return rayHit.ray.tfar;
+    }
 
-        RTCRayHit rays[numRays];
-        for (size_t i=0; i<numRays; i++) {
-          Vec3fa org = 2.0f*RandomSampler_get3D(sampler) - Vec3fa(1.0f);
-          Vec3fa dir = 2.0f*RandomSampler_get3D(sampler) - Vec3fa(1.0f);
-          rays[i] = makeRay(org,dir); 
-        }
-        IntersectWithMode(imode,ivariant,scene,rays,numRays);
-      }
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      RTCDeviceRef device = rtcNewDevice(nullptr);
+      RTCSceneRef scene = rtcNewScene(device);
+
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_ROUND_BEZIER_CURVE);
+      Vec4f* vertices = (Vec4f*) rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT4, sizeof(Vec4f), 4);
+      vertices[0] = Vec4f(-1.0f,0.0f,0.0f,0.1f);
+      vertices[1] = Vec4f(-0.3f,0.0f,0.0f,0.1f);
+      vertices[2] = Vec4f(+0.3f,0.0f,0.0f,0.1f);
+      vertices[3] = Vec4f(+1.0f,0.0f,0.0f,0.1f);
+      unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT, sizeof(unsigned int), 1);
+      indices[0] = 0;
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene, geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      /* without ray cones the round curve is hit at its front side */
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      if (std::fabs(trace(scene,&context) - 4.9f) > 1E-2f)
+        return VerifyApplication::FAILED;
+
+      /* a narrow cone still intersects the round curve */
+      context.flags = RTC_INTERSECT_CONTEXT_FLAG_RAY_CONES;
+      context.coneWidth = 0.0f;
+      context.coneSpread = 0.01f;
+      if (std::fabs(trace(scene,&context) - 4.9f) > 1E-2f)
+        return VerifyApplication::FAILED;
+
+      /* a wide cone switches to the ribbon that passes through the center */
+      context.coneSpread = 1.0f;
+      if (std::fabs(trace(scene,&context) - 5.0f) > 1E-2f)
+        return VerifyApplication::FAILED;
+
+      AssertNoError(device);
+      return VerifyApplication::PASSED;
     }
-  }
+  };
 
-  struct RegressionTask
+  struct CurvePretessellationTest : public VerifyApplication::Test
   {
-    RegressionTask (VerifyApplication::Test* test, unsigned int sceneIndex, unsigned int sceneCount, unsigned int threadCount, bool cancelBuild)
-      : sceneIndex(sceneIndex), sceneCount(sceneCount), test(test), scene(nullptr), numActiveThreads(0), cancelBuild(cancelBuild), errorCounter(0) 
-    { 
-      barrier.init(threadCount); 
-      RandomSampler_init(sampler,0);
+    RTCGeometryType gtype;
+
+    CurvePretessellationTest (std::string name, int isa, RTCGeometryType gtype)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS), gtype(gtype) {}
+
+    bool trace(RTCScene scene, float x, float& t, float& u)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      RTCRayHit rayHit;
+      rayHit.ray.org_x = x;
+      rayHit.ray.org_y = 0;
+      rayHit.ray.org_z = -5;
+      rayHit.ray.dir_x = 0;
+      rayHit.ray.dir_y = 0;
+      rayHit.ray.dir_z = 1;
+      rayHit.ray.tnear = 0;
+      rayHit.ray.tfar = 100000;
+      rayHit.ray.mask = -1;
+      rayHit.ray.flags = 0u;
+      rayHit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+      rayHit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+      rtcIntersect1(scene, &context, &rayHit);
+      t = rayHit.ray.tfar;
+      u = rayHit.hit.u;
+      return rayHit.hit.geomID != RTC_INVALID_GEOMETRY_ID;
     }
 
-    unsigned int sceneIndex;
-    unsigned int sceneCount;
-    VerifyApplication::Test* test;
-    VerifyApplication* state;
-    Ref<VerifyScene> scene;
-    BarrierSys barrier;
-    volatile unsigned int numActiveThreads;
-    bool cancelBuild;
-    std::atomic<size_t> errorCounter;
-    RandomSampler sampler;
+    RTCScene createScene(RTCDevice device, float bend)
+    {
+      RTCScene scene = rtcNewScene(device);
+      RTCGeometry geom = rtcNewGeometry(device, gtype);
+      Vec4f* vertices = (Vec4f*) rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT4, sizeof(Vec4f), 4);
+      vertices[0] = Vec4f(-1.0f,0.0f,0.0f,0.1f);
+      vertices[1] = Vec4f(-0.3f,0.0f,-bend,0.1f);
+      vertices[2] = Vec4f(+0.3f,0.0f,-bend,0.1f);
+      vertices[3] = Vec4f(+1.0f,0.0f,0.0f,0.1f);
+      unsigned int* indices = (unsigned int*) rtcSetNewGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT, sizeof(unsigned int), 1);
+      indices[0] = 0;
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene, geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene(scene);
+      return scene;
+    }
+
+    /* returns the maximal distance deviation of the pre-tessellated curve from the original curve */
+    float maxError(RTCScene scene0, RTCScene scene1, float& maxErrorU)
+    {
+      float maxErrorT = 0.0f;
+      maxErrorU = 0.0f;
+      for (float x=-0.25f; x<=0.25f; x+=0.125f)
+      {
+        float t0 = 0.0f, u0 = 0.0f, t1 = 0.0f, u1 = 0.0f;
+        if (!trace(scene0,x,t0,u0)) return inf;
+        if (!trace(scene1,x,t1,u1)) return inf;
+        maxErrorT = max(maxErrorT,std::fabs(t0-t1));
+        maxErrorU = max(maxErrorU,std::fabs(u0-u1));
+      }
+      return maxErrorT;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device0 = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device0));
+
+      /* the pre-tessellated curve has to closely match the original curve */
+      bool passed = true;
+      float errorBent = inf;
+      for (int segments : { 1, 3, 5, 16, 32 })
+      {
+        RTCDeviceRef device1 = rtcNewDevice((cfg+",hair_pretessellate=1,hair_pretessellate_segments="+std::to_string(segments)).c_str());
+        errorHandler(nullptr,rtcGetDeviceError(device1));
+
+        RTCSceneRef straight0 = createScene(device0,0.0f), straight1 = createScene(device1,0.0f);
+        RTCSceneRef bent0 = createScene(device0,1.0f), bent1 = createScene(device1,1.0f);
+        AssertNoError(device0);
+        AssertNoError(device1);
+
+        /* straight curves are represented exactly by any number of segments */
+        float errorU = 0.0f;
+        const float error = maxError(straight0,straight1,errorU);
+        passed &= error < 1E-2f && (segments < 3 || errorU < 5E-2f);
+
+        /* bent curves get approximated better with more segments */
+        const float errorBentSegments = maxError(bent0,bent1,errorU);
+        if (segments == 1) passed &= errorBentSegments > 0.1f;
+        if (segments >= 16) passed &= errorBentSegments < 1E-2f && errorU < 5E-2f;
+        passed &= errorBentSegments <= errorBent;
+        errorBent = errorBentSegments;
+      }
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
   };
 
-  struct ThreadRegressionTask
+  struct UserGeometryBatchTest : public VerifyApplication::Test
   {
-    ThreadRegressionTask (unsigned int threadIndex, unsigned int threadCount,
-                          VerifyApplication* state, RTCDeviceRef& device, std::vector<IntersectMode>& intersectModes, RegressionTask* task)
-      : threadIndex(threadIndex), threadCount(threadCount), state(state), device(device), intersectModes(intersectModes), task(task) {}
+    struct SphereSet
+    {
+      std::vector<Sphere> spheres;
+      std::atomic<unsigned int> maxBatchSize;
+    };
 
-    unsigned int threadIndex;
-    unsigned int threadCount;
-    VerifyApplication* state;
-    RTCDeviceRef& device;
-    std::vector<IntersectMode>& intersectModes;
-    RegressionTask* task;
-  };
+    UserGeometryBatchTest (std::string name, int isa, std::string leafSizeConfig, bool addToCommittedScene)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS), leafSizeConfig(leafSizeConfig), addToCommittedScene(addToCommittedScene) {}
 
-  size_t monitorProgressBreak = 0;
-  std::atomic<size_t> monitorProgressInvokations(0);
-  std::atomic<size_t> monitorProgressBreakExecuted(0);
+    static void boundsFunc(const struct RTCBoundsFunctionArguments* const args)
+    {
+      SphereSet* set = (SphereSet*) args->geometryUserPtr;
+      *(BBox3fa*)args->bounds_o = set->spheres[args->primID].bounds();
+    }
 
-  bool monitorProgressFunction(void* ptr, double dn) 
-  {
-    size_t n = monitorProgressInvokations++;
-    if (n == monitorProgressBreak) {
-      monitorProgressBreakExecuted++;
-      return false;
+    static bool intersectSphere(const Sphere& sphere, RTCRayN* ray, unsigned int N, unsigned int i, float& t)
+    {
+      const Vec3fa org(RTCRayN_org_x(ray,N,i),RTCRayN_org_y(ray,N,i),RTCRayN_org_z(ray,N,i));
+      const Vec3fa dir(RTCRayN_dir_x(ray,N,i),RTCRayN_dir_y(ray,N,i),RTCRayN_dir_z(ray,N,i));
+      const Vec3fa v = org-sphere.pos;
+      const float A = dot(dir,dir);
+      const float B = 2.0f*dot(v,dir);
+      const float C = dot(v,v) - sqr(sphere.r);
+      const float D = B*B - 4.0f*A*C;
+      if (D < 0.0f) return false;
+      t = (-B-sqrt(D))/(2.0f*A);
+      return t > RTCRayN_tnear(ray,N,i) && t < RTCRayN_tfar(ray,N,i);
     }
-    return true;
-  }
 
-  void rtcore_regression_static_thread(void* ptr)
-  {
-    ThreadRegressionTask* thread = (ThreadRegressionTask*) ptr;
-    RegressionTask* task = thread->task;
-    if (thread->threadIndex > 0) 
+    static void intersectFuncBatch(const struct RTCIntersectFunctionNArguments* args, const unsigned int* primIDs, unsigned int numPrimitives)
     {
-      for (unsigned int i=0; i<task->sceneCount; i++) 
+      SphereSet* set = (SphereSet*) args->geometryUserPtr;
+      unsigned int maxBatchSize = set->maxBatchSize;
+      while (numPrimitives > maxBatchSize && !set->maxBatchSize.compare_exchange_weak(maxBatchSize,numPrimitives));
+
+      RTCRayN* ray = RTCRayHitN_RayN(args->rayhit,args->N);
+      RTCHitN* hit = RTCRayHitN_HitN(args->rayhit,args->N);
+      for (unsigned int i=0; i<args->N; i++)
       {
-  task->barrier.wait();
-  if (thread->threadIndex < task->numActiveThreads) 
-  {
-          rtcJoinCommitScene(*task->scene);
-    //if (rtcGetDeviceError(thread->device) != RTC_ERROR_NONE) task->errorCounter++;;
-          if (rtcGetDeviceError(thread->device) != RTC_ERROR_NONE) {
-            task->errorCounter++;
-          }
-          else {
-            shootRandomRays(i,thread->intersectModes,thread->state->intersectVariants,*task->scene);
-          }
-  }
-        task->barrier.wait();
+        if (!args->valid[i]) continue;
+        for (unsigned int j=0; j<numPrimitives; j++)
+        {
+          float t = 0.0f;
+          if (!intersectSphere(set->spheres[primIDs[j]],ray,args->N,i,t)) continue;
+          RTCRayN_tfar(ray,args->N,i) = t;
+          RTCHitN_u(hit,args->N,i) = 0.0f;
+          RTCHitN_v(hit,args->N,i) = 0.0f;
+          RTCHitN_primID(hit,args->N,i) = primIDs[j];
+          RTCHitN_geomID(hit,args->N,i) = args->geomID;
+          RTCHitN_instID(hit,args->N,i,0) = args->context->instID[0];
+        }
       }
-      delete thread; thread = nullptr;
-      return;
     }
 
-    if (rtcGetDeviceError(thread->device) != RTC_ERROR_NONE) task->errorCounter++;;
-    bool hasError = false;
+    static void occludedFuncBatch(const struct RTCOccludedFunctionNArguments* args, const unsigned int* primIDs, unsigned int numPrimitives)
+    {
+      SphereSet* set = (SphereSet*) args->geometryUserPtr;
+      for (unsigned int i=0; i<args->N; i++)
+      {
+        if (!args->valid[i]) continue;
+        for (unsigned int j=0; j<numPrimitives; j++)
+        {
+          float t = 0.0f;
+          if (!intersectSphere(set->spheres[primIDs[j]],args->ray,args->N,i,t)) continue;
+          RTCRayN_tfar(args->ray,args->N,i) = neg_inf;
+          break;
+        }
+      }
+    }
 
-    for (unsigned int i=0; i<task->sceneCount; i++) 
+    static void intersectFunc(const struct RTCIntersectFunctionNArguments* args) {
+      intersectFuncBatch(args,&args->primID,1);
+    }
+
+    static void occludedFunc(const struct RTCOccludedFunctionNArguments* args) {
+      occludedFuncBatch(args,&args->primID,1);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
     {
-      RandomSampler_init(task->sampler,task->sceneIndex*13565+i*3242);
-      if (i%5 == 0) std::cout << "." << std::flush;
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+leafSizeConfig;
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
 
-      SceneFlags sflags = getSceneFlags(i);
-      task->scene = new VerifyScene(thread->device,sflags);
-      if (rtcGetDeviceError(thread->device) != RTC_ERROR_NONE) task->errorCounter++;;
-      if (task->cancelBuild) rtcSetSceneProgressMonitorFunction(*task->scene,monitorProgressFunction,nullptr);
-      std::vector<std::unique_ptr<Sphere>> spheres;
-      
-      for (unsigned int j=0; j<10; j++) 
+      /* 8x8 grid of spheres in the xy plane */
+      SphereSet set;
+      set.maxBatchSize = 0;
+      for (int y=0; y<8; y++)
+        for (int x=0; x<8; x++)
+          set.spheres.push_back(Sphere(Vec3fa(float(x),float(y),0.0f),0.4f));
+
+      RTCSceneRef scene = rtcNewScene(device);
+
+      /* the leaf sizes have to follow the batch callbacks of geometries added to an already committed scene */
+      SphereSet unbatched;
+      if (addToCommittedScene)
       {
-        Vec3fa pos = 100.0f*RandomSampler_get3D(task->sampler);
-        int type = RandomSampler_getInt(task->sampler)%11;
-        switch (RandomSampler_getInt(task->sampler)%16) {
-        case 0: pos = Vec3fa(nan); break;
+        for (const Sphere& sphere : set.spheres)
+          unbatched.spheres.push_back(Sphere(sphere.pos+Vec3fa(100.0f,0.0f,0.0f),sphere.r));
+        RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_USER);
+        rtcSetGeometryUserPrimitiveCount(geom,(unsigned int)unbatched.spheres.size());
+        rtcSetGeometryUserData(geom,&unbatched);
+        rtcSetGeometryBoundsFunction(geom,boundsFunc,nullptr);
+        rtcSetGeometryIntersectFunction(geom,intersectFunc);
+        rtcSetGeometryOccludedFunction(geom,occludedFunc);
+        rtcCommitGeometry(geom);
+        rtcAttachGeometry(scene,geom);
+        rtcReleaseGeometry(geom);
+        rtcCommitScene(scene);
+        AssertNoError(device);
+      }
+
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_USER);
+      rtcSetGeometryUserPrimitiveCount(geom,(unsigned int)set.spheres.size());
+      rtcSetGeometryUserData(geom,&set);
+      rtcSetGeometryBoundsFunction(geom,boundsFunc,nullptr);
+      rtcSetGeometryIntersectFunctionBatch(geom,intersectFuncBatch);
+      rtcSetGeometryOccludedFunctionBatch(geom,occludedFuncBatch);
+      rtcCommitGeometry(geom);
+      unsigned int geomID = rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+
+      for (int y=0; y<32; y++)
+      {
+        for (int x=0; x<32; x++)
+        {
+          const float px = 0.25f*float(x), py = 0.25f*float(y);
+
+          /* the closest sphere center determines the expected hit */
+          const int sx = int(px+0.5f), sy = int(py+0.5f);
+          const float dx = px-float(sx), dy = py-float(sy);
+          const bool expectHit = sx < 8 && sy < 8 && dx*dx+dy*dy < sqr(0.4f);
+
+          RTCRayHit ray = makeRay(Vec3fa(px,py,-5.0f),Vec3fa(0,0,1));
+          rtcIntersect1(scene,&context,&ray);
+          if (expectHit != (ray.hit.geomID != RTC_INVALID_GEOMETRY_ID)) return VerifyApplication::FAILED;
+          if (expectHit && (ray.hit.geomID != geomID || ray.hit.primID != unsigned(sy*8+sx))) return VerifyApplication::FAILED;
+
+          RTCRay shadow = makeRay(Vec3fa(px,py,-5.0f),Vec3fa(0,0,1)).ray;
+          rtcOccluded1(scene,&context,&shadow);
+          if (expectHit != (shadow.tfar < 0.0f)) return VerifyApplication::FAILED;
+
+          /* packet traversal has to find the same hits */
+          RTCRayHit4 ray4;
+          const int valid4[4] = { -1, -1, -1, -1 };
+          for (unsigned int i=0; i<4; i++) {
+            RTCRayHit ray1 = makeRay(Vec3fa(px,py,-5.0f),Vec3fa(0,0,1));
+            setRay(ray4,i,ray1);
+          }
+          rtcIntersect4(valid4,scene,&context,&ray4);
+          for (unsigned int i=0; i<4; i++)
+            if (ray4.hit.geomID[i] != ray.hit.geomID || ray4.hit.primID[i] != ray.hit.primID) return VerifyApplication::FAILED;
+        }
+      }
+      AssertNoError(device);
+
+      /* multi-primitive leaves have to be passed as a single batch */
+      if (set.maxBatchSize < 2)
+        return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+
+    std::string leafSizeConfig;
+    bool addToCommittedScene;
+  };
+
+  struct SubdivTessellationConeTest : public VerifyApplication::Test
+  {
+    SubdivTessellationConeTest (std::string name, int isa)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS) {}
+
+    float trace(RTCScene scene)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      RTCRayHit ray = makeRay(Vec3fa(0.1f,0.2f,-5.0f),Vec3fa(0,0,1));
+      rtcIntersect1(scene,&context,&ray);
+      return ray.hit.geomID == RTC_INVALID_GEOMETRY_ID ? float(inf) : ray.ray.tfar;
+    }
+
+    RTCGeometry addCube(RTCDevice device, RTCScene scene)
+    {
+      static const float vertices[8*3] = {
+        -1.0f, -1.0f, -1.0f,  +1.0f, -1.0f, -1.0f,  +1.0f, +1.0f, -1.0f,  -1.0f, +1.0f, -1.0f,
+        -1.0f, -1.0f, +1.0f,  +1.0f, -1.0f, +1.0f,  +1.0f, +1.0f, +1.0f,  -1.0f, +1.0f, +1.0f
+      };
+      static const unsigned int indices[6*4] = {
+        0, 3, 2, 1,  4, 5, 6, 7,  0, 1, 5, 4,  1, 2, 6, 5,  2, 3, 7, 6,  3, 0, 4, 7
+      };
+      static const unsigned int faces[6] = { 4, 4, 4, 4, 4, 4 };
+
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_SUBDIVISION);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices, 0, 3*sizeof(float), 8);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX,  0, RTC_FORMAT_UINT,   indices,  0, sizeof(unsigned int), 6*4);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_FACE,   0, RTC_FORMAT_UINT,   faces,    0, sizeof(unsigned int), 6);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      return geom;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* reference with a high constant tessellation rate */
+      RTCSceneRef scene0 = rtcNewScene(device);
+      RTCGeometry geom0 = addCube(device,scene0);
+      rtcSetGeometryTessellationRate(geom0,64.0f);
+      rtcCommitGeometry(geom0);
+      rtcCommitScene(scene0);
+
+      /* narrow cone close to the surface results in a fine tessellation */
+      RTCSceneRef scene1 = rtcNewScene(device);
+      RTCGeometry geom1 = addCube(device,scene1);
+      rtcSetGeometryTessellationRate(geom1,1.0f);
+      rtcSetGeometryTessellationCone(geom1,0.0f,0.0f,-5.0f,0.03f,0.0f);
+      rtcCommitGeometry(geom1);
+      rtcCommitScene(scene1);
+
+      /* wide cone results in a single quad per face */
+      RTCSceneRef scene2 = rtcNewScene(device);
+      RTCGeometry geom2 = addCube(device,scene2);
+      rtcSetGeometryTessellationRate(geom2,1.0f);
+      rtcSetGeometryTessellationCone(geom2,0.0f,0.0f,-5.0f,100.0f,0.0f);
+      rtcCommitGeometry(geom2);
+      rtcCommitScene(scene2);
+      AssertNoError(device);
+
+      const float t0 = trace(scene0);
+      const float t1 = trace(scene1);
+      const float t2 = trace(scene2);
+      if (std::isinf(t0) || std::fabs(t1-t0) > 1E-3f || !(std::fabs(t2-t0) > 1E-2f))
+        return VerifyApplication::FAILED;
+
+      /* narrowing the cone has to refine the tessellation on the next commit */
+      rtcSetGeometryTessellationCone(geom2,0.0f,0.0f,-5.0f,0.03f,0.0f);
+      rtcCommitGeometry(geom2);
+      rtcCommitScene(scene2);
+      if (std::fabs(trace(scene2)-t0) > 1E-3f)
+        return VerifyApplication::FAILED;
+
+      /* negative cone parameters are invalid */
+      rtcSetGeometryTessellationCone(geom2,0.0f,0.0f,-5.0f,-1.0f,0.0f);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct SubdivTopologyUpdateTest : public VerifyApplication::Test
+  {
+    static const unsigned int W = 4;
+
+    SubdivTopologyUpdateTest (std::string name, int isa)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS) {}
+
+    struct Grid
+    {
+      Grid ()
+      {
+        for (unsigned int y=0; y<=W; y++)
+          for (unsigned int x=0; x<=W; x++)
+            vertices.push_back(Vec3f(float(x),float(y),0.1f*float((x*7+y*3)%5)));
+        for (unsigned int y=0; y<W; y++) {
+          for (unsigned int x=0; x<W; x++) {
+            indices.push_back(y*(W+1)+x); indices.push_back(y*(W+1)+x+1);
+            indices.push_back((y+1)*(W+1)+x+1); indices.push_back((y+1)*(W+1)+x);
+            faces.push_back(4);
+          }
+        }
+      }
+      std::vector<Vec3f> vertices;
+      std::vector<unsigned int> indices;
+      std::vector<unsigned int> faces;
+    };
+
+    RTCGeometry addGrid(RTCDevice device, RTCScene scene, const Grid& grid, const std::vector<unsigned int>& holes, const std::vector<unsigned int>& creases, const std::vector<float>& weights)
+    {
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_SUBDIVISION);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, grid.vertices.data(), 0, sizeof(Vec3f), grid.vertices.size());
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX,  0, RTC_FORMAT_UINT,   grid.indices.data(),  0, sizeof(unsigned int), grid.indices.size());
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_FACE,   0, RTC_FORMAT_UINT,   grid.faces.data(),    0, sizeof(unsigned int), grid.faces.size());
+      setTopology(geom,holes,creases,weights);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      return geom;
+    }
+
+    void setTopology(RTCGeometry geom, const std::vector<unsigned int>& holes, const std::vector<unsigned int>& creases, const std::vector<float>& weights)
+    {
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_HOLE, 0, RTC_FORMAT_UINT, holes.data(), 0, sizeof(unsigned int), holes.size());
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_EDGE_CREASE_INDEX, 0, RTC_FORMAT_UINT2, creases.data(), 0, 2*sizeof(unsigned int), creases.size()/2);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_EDGE_CREASE_WEIGHT, 0, RTC_FORMAT_FLOAT, weights.data(), 0, sizeof(float), weights.size());
+      rtcCommitGeometry(geom);
+    }
+
+    /* compares the incrementally updated scene against a freshly built one */
+    bool compare(RTCScene scene0, RTCScene scene1)
+    {
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (float y=0.1f; y<float(W); y+=0.2f)
+      {
+        for (float x=0.1f; x<float(W); x+=0.2f)
+        {
+          RTCRayHit ray0 = makeRay(Vec3fa(x,y,-5.0f),Vec3fa(0,0,1));
+          RTCRayHit ray1 = makeRay(Vec3fa(x,y,-5.0f),Vec3fa(0,0,1));
+          rtcIntersect1(scene0,&context,&ray0);
+          rtcIntersect1(scene1,&context,&ray1);
+          if (ray0.hit.geomID != ray1.hit.geomID) return false;
+          if (ray0.hit.geomID == RTC_INVALID_GEOMETRY_ID) continue;
+          if (ray0.hit.primID != ray1.hit.primID || std::fabs(ray0.ray.tfar-ray1.ray.tfar) > 1E-4f) return false;
+        }
+      }
+      return true;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      Grid grid;
+
+      const std::vector<unsigned int> holes0 = { 5 };
+      const std::vector<unsigned int> holes1 = { 6, 9 };
+      const std::vector<unsigned int> creases0 = { 6, 7 };
+      const std::vector<unsigned int> creases1 = { 6, 7, 11, 12 };
+      const std::vector<float> weights0 = { 2.0f };
+      const std::vector<float> weights1 = { 4.0f, 2.0f };
+
+      RTCSceneRef scene0 = rtcNewScene(device);
+      RTCGeometry geom0 = addGrid(device,scene0,grid,holes0,creases0,weights0);
+      rtcCommitScene(scene0);
+      AssertNoError(device);
+
+      /* update only the holes */
+      rtcSetSharedGeometryBuffer(geom0, RTC_BUFFER_TYPE_HOLE, 0, RTC_FORMAT_UINT, holes1.data(), 0, sizeof(unsigned int), holes1.size());
+      rtcCommitGeometry(geom0);
+      rtcCommitScene(scene0);
+      RTCSceneRef scene1 = rtcNewScene(device);
+      addGrid(device,scene1,grid,holes1,creases0,weights0);
+      rtcCommitScene(scene1);
+      AssertNoError(device);
+      if (!compare(scene0,scene1)) return VerifyApplication::FAILED;
+
+      /* update holes and creases together */
+      setTopology(geom0,holes0,creases1,weights1);
+      rtcCommitScene(scene0);
+      RTCSceneRef scene2 = rtcNewScene(device);
+      addGrid(device,scene2,grid,holes0,creases1,weights1);
+      rtcCommitScene(scene2);
+      AssertNoError(device);
+      if (!compare(scene0,scene2)) return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct SubdivMultiDeviceCacheTest : public VerifyApplication::Test
+  {
+    static const unsigned int W = 4;
+
+    SubdivMultiDeviceCacheTest (std::string name, int isa)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::vector<Vec3f> vertices;
+      std::vector<unsigned int> indices, faces;
+      for (unsigned int y=0; y<=W; y++)
+        for (unsigned int x=0; x<=W; x++)
+          vertices.push_back(Vec3f(float(x),float(y),0.1f*float((x*7+y*3)%5)));
+      for (unsigned int y=0; y<W; y++) {
+        for (unsigned int x=0; x<W; x++) {
+          indices.push_back(y*(W+1)+x); indices.push_back(y*(W+1)+x+1);
+          indices.push_back((y+1)*(W+1)+x+1); indices.push_back((y+1)*(W+1)+x);
+          faces.push_back(4);
+        }
+      }
+
+      /* the thread uses more devices than it has tessellation cache slots */
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      const size_t numDevices = SharedLazyTessellationCache::NUM_THREAD_CACHE_SLOTS+2;
+      std::vector<RTCDeviceRef> devices;
+      std::vector<RTCSceneRef> scenes;
+      std::vector<RTCGeometry> geometries;
+      for (size_t i=0; i<numDevices; i++)
+      {
+        devices.push_back(rtcNewDevice(cfg.c_str()));
+        errorHandler(nullptr,rtcGetDeviceError(devices[i]));
+        if (!rtcGetDeviceProperty(devices[i],RTC_DEVICE_PROPERTY_SUBDIVISION_GEOMETRY_SUPPORTED))
+          return VerifyApplication::SKIPPED;
+
+        scenes.push_back(rtcNewScene(devices[i]));
+        RTCGeometry geom = rtcNewGeometry(devices[i], RTC_GEOMETRY_TYPE_SUBDIVISION);
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices.data(), 0, sizeof(Vec3f), vertices.size());
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX,  0, RTC_FORMAT_UINT,   indices.data(),  0, sizeof(unsigned int), indices.size());
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_FACE,   0, RTC_FORMAT_UINT,   faces.data(),    0, sizeof(unsigned int), faces.size());
+        rtcCommitGeometry(geom);
+        rtcAttachGeometry(scenes[i],geom);
+        rtcReleaseGeometry(geom);
+        rtcCommitScene(scenes[i]);
+        geometries.push_back(geom);
+        AssertNoError(devices[i]);
+      }
+
+      /* interpolating round robin over the devices gives the same results on all devices */
+      bool passed = true;
+      for (size_t round=0; round<50; round++)
+      {
+        const unsigned int primID = (unsigned int)(round % faces.size());
+        const float u = float(round%7)/7.0f, v = float(round%5)/5.0f;
+        float P0[3];
+        rtcInterpolate0(geometries[0],primID,u,v,RTC_BUFFER_TYPE_VERTEX,0,P0,3);
+        for (size_t i=1; i<numDevices; i++)
+        {
+          float P[3];
+          rtcInterpolate0(geometries[i],primID,u,v,RTC_BUFFER_TYPE_VERTEX,0,P,3);
+          passed &= P[0] == P0[0] && P[1] == P0[1] && P[2] == P0[2];
+        }
+      }
+
+      for (size_t i=0; i<numDevices; i++)
+        AssertNoError(devices[i]);
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct SubdivDisplacementBatchTest : public VerifyApplication::Test
+  {
+    static const unsigned int W = 2;
+
+    SubdivDisplacementBatchTest (std::string name, int isa)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS) {}
+
+    struct DisplacementStats
+    {
+      DisplacementStats () : calls(0), points(0), maxN(0) {}
+      std::atomic<size_t> calls;
+      std::atomic<size_t> points;
+      std::atomic<size_t> maxN;
+    };
+
+    static void displacement(const RTCDisplacementFunctionNArguments* args)
+    {
+      DisplacementStats* stats = (DisplacementStats*) args->geometryUserPtr;
+      stats->calls++;
+      stats->points += args->N;
+      size_t maxN = stats->maxN;
+      while (args->N > maxN && !stats->maxN.compare_exchange_weak(maxN,args->N));
+      for (unsigned int i=0; i<args->N; i++)
+        args->P_z[i] += 1.0f;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* flat grid of quads in the z=0 plane */
+      std::vector<Vec3f> vertices;
+      std::vector<unsigned int> indices;
+      std::vector<unsigned int> faces;
+      for (unsigned int y=0; y<=W; y++)
+        for (unsigned int x=0; x<=W; x++)
+          vertices.push_back(Vec3f(float(x),float(y),0.0f));
+      for (unsigned int y=0; y<W; y++) {
+        for (unsigned int x=0; x<W; x++) {
+          indices.push_back(y*(W+1)+x); indices.push_back(y*(W+1)+x+1);
+          indices.push_back((y+1)*(W+1)+x+1); indices.push_back((y+1)*(W+1)+x);
+          faces.push_back(4);
+        }
+      }
+
+      DisplacementStats stats;
+      RTCSceneRef scene = rtcNewScene(device);
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_SUBDIVISION);
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices.data(), 0, sizeof(Vec3f), vertices.size());
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX,  0, RTC_FORMAT_UINT,   indices.data(),  0, sizeof(unsigned int), indices.size());
+      rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_FACE,   0, RTC_FORMAT_UINT,   faces.data(),    0, sizeof(unsigned int), faces.size());
+      rtcSetGeometrySubdivisionMode(geom,0,RTC_SUBDIVISION_MODE_PIN_BOUNDARY);
+      rtcSetGeometryTessellationRate(geom,8.0f);
+      rtcSetGeometryUserData(geom,&stats);
+      rtcSetGeometryDisplacementFunction(geom,displacement);
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      /* each grid has to get displaced with a single call */
+      if (stats.calls == 0 || stats.maxN <= 16) return VerifyApplication::FAILED;
+      if (stats.points/stats.calls <= 16) return VerifyApplication::FAILED;
+
+      /* the displaced surface is the z=1 plane */
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      for (float y=0.1f; y<float(W); y+=0.2f)
+      {
+        for (float x=0.1f; x<float(W); x+=0.2f)
+        {
+          RTCRayHit ray = makeRay(Vec3fa(x,y,-5.0f),Vec3fa(0,0,1));
+          rtcIntersect1(scene,&context,&ray);
+          if (ray.hit.geomID == RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+          if (std::fabs(ray.ray.tfar-6.0f) > 1E-3f) return VerifyApplication::FAILED;
+        }
+      }
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct QuantizedGridTest : public VerifyApplication::Test
+  {
+    static const unsigned int W = 8;
+
+    QuantizedGridTest (std::string name, int isa)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS) {}
+
+    static unsigned short height(unsigned int x, unsigned int y) {
+      return (unsigned short) ((x*37+y*91) % 1000);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      RTCVertexQuantization quantization;
+      quantization.origin_x = -3.0f;   quantization.origin_y = -3.0f;   quantization.origin_z = 0.5f;
+      quantization.scale_x  =  0.25f;  quantization.scale_y  =  0.25f;  quantization.scale_z  = 0.001f;
+      quantization.offset_y = quantization.offset_z = 0;
+
+      /* two neighboring terrain tiles that store their vertices relative to their own lattice offset */
+      RTCGrid grid;
+      grid.startVertexID = 0;
+      grid.stride = W+1;
+      grid.width = grid.height = W+1;
+      std::vector<unsigned short> qvertices[2];
+      std::vector<Vec3f> fvertices[2];
+      RTCSceneRef qscene = rtcNewScene(device);
+      RTCSceneRef fscene = rtcNewScene(device);
+      for (unsigned int tile=0; tile<2; tile++)
+      {
+        for (unsigned int y=0; y<=W; y++)
+        {
+          for (unsigned int x=0; x<=W; x++)
+          {
+            const unsigned short h = height(tile*W+x,y);
+            qvertices[tile].push_back(x); qvertices[tile].push_back(y); qvertices[tile].push_back(h);
+            fvertices[tile].push_back(Vec3f(-3.0f+0.25f*float(tile*W+x),-3.0f+0.25f*float(y),0.5f+0.001f*float(h)));
+          }
+        }
+        fvertices[tile].push_back(Vec3f(0.0f)); // pads the last vertex to 16 bytes
+
+        quantization.offset_x = tile*W;
+        RTCGeometry qgeom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_GRID);
+        rtcSetSharedGeometryBuffer(qgeom, RTC_BUFFER_TYPE_GRID, 0, RTC_FORMAT_GRID, &grid, 0, sizeof(RTCGrid), 1);
+        rtcSetSharedGeometryBuffer(qgeom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_USHORT3, qvertices[tile].data(), 0, 3*sizeof(unsigned short), (W+1)*(W+1));
+        rtcSetGeometryVertexQuantization(qgeom,&quantization);
+        rtcCommitGeometry(qgeom);
+        rtcAttachGeometry(qscene,qgeom);
+        rtcReleaseGeometry(qgeom);
+
+        RTCGeometry fgeom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_GRID);
+        rtcSetSharedGeometryBuffer(fgeom, RTC_BUFFER_TYPE_GRID, 0, RTC_FORMAT_GRID, &grid, 0, sizeof(RTCGrid), 1);
+        rtcSetSharedGeometryBuffer(fgeom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, fvertices[tile].data(), 0, sizeof(Vec3f), (W+1)*(W+1));
+        rtcCommitGeometry(fgeom);
+        rtcAttachGeometry(fscene,fgeom);
+        rtcReleaseGeometry(fgeom);
+      }
+      rtcCommitScene(qscene);
+      rtcCommitScene(fscene);
+      AssertNoError(device);
+
+      /* the quantized tiles have to match the float tiles */
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      RandomSampler sampler;
+      RandomSampler_init(sampler, int(isa));
+      for (size_t i=0; i<1000; i++)
+      {
+        /* every third ray exactly on the shared edge of the tiles */
+        const float x = i%3 == 0 ? -1.0f : -3.0f+4.0f*RandomSampler_getFloat(sampler);
+        const float y = -3.0f+2.0f*RandomSampler_getFloat(sampler);
+        RTCRayHit qray = makeRay(Vec3fa(x,y,5.0f),Vec3fa(0,0,-1));
+        RTCRayHit fray = makeRay(Vec3fa(x,y,5.0f),Vec3fa(0,0,-1));
+        rtcIntersect1(qscene,&context,&qray);
+        rtcIntersect1(fscene,&context,&fray);
+        if (qray.hit.geomID == RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+        if (fray.hit.geomID == RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+        if (std::fabs(qray.ray.tfar-fray.ray.tfar) > 1E-4f) return VerifyApplication::FAILED;
+      }
+
+      /* interpolation decodes the vertices */
+      float P[3];
+      rtcInterpolate0(rtcGetGeometry(qscene,1),0,0.0f,0.5f,RTC_BUFFER_TYPE_VERTEX,0,P,3);
+      AssertNoError(device);
+      const Vec3f& p = fvertices[1][(W/2)*(W+1)];
+      if (length(Vec3f(P[0],P[1],P[2])-p) > 1E-5f) return VerifyApplication::FAILED;
+
+      return VerifyApplication::PASSED;
+    }
+  };
+
+  struct PointCloudMortonTest : public VerifyApplication::Test
+  {
+    static const size_t N = 20000;
+
+    PointCloudMortonTest (std::string name, int isa)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      RandomSampler sampler;
+      RandomSampler_init(sampler, int(isa));
+      std::vector<Vec4f> points(N);
+      for (size_t i=0; i<N; i++) {
+        const Vec3fa p = RandomSampler_get3D(sampler);
+        points[i] = Vec4f(p.x,p.y,p.z,0.005f+0.01f*RandomSampler_getFloat(sampler));
+      }
+
+      /* the same mix of spheres and discs in a low and a medium quality scene */
+      RTCSceneRef scenes[2] = { rtcNewScene(device), rtcNewScene(device) };
+      rtcSetSceneBuildQuality(scenes[0],RTC_BUILD_QUALITY_LOW);
+      rtcSetSceneBuildQuality(scenes[1],RTC_BUILD_QUALITY_MEDIUM);
+      for (size_t i=0; i<2; i++)
+      {
+        const RTCGeometryType types[2] = { RTC_GEOMETRY_TYPE_SPHERE_POINT, RTC_GEOMETRY_TYPE_DISC_POINT };
+        for (size_t j=0; j<2; j++)
+        {
+          RTCGeometry geom = rtcNewGeometry(device, types[j]);
+          rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT4, points.data()+j*N/2, 0, sizeof(Vec4f), N/2);
+          rtcCommitGeometry(geom);
+          rtcAttachGeometry(scenes[i],geom);
+          rtcReleaseGeometry(geom);
+        }
+        rtcCommitScene(scenes[i]);
+      }
+      AssertNoError(device);
+
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      size_t numHits = 0;
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org(RandomSampler_get3D(sampler));
+        const Vec3fa dir = normalize(Vec3fa(RandomSampler_get3D(sampler))-Vec3fa(0.5f));
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = makeRay(org,dir);
+        rtcIntersect1(scenes[0],&context,&ray0);
+        rtcIntersect1(scenes[1],&context,&ray1);
+        if (ray0.hit.geomID != ray1.hit.geomID) return VerifyApplication::FAILED;
+        if (ray0.hit.geomID == RTC_INVALID_GEOMETRY_ID) continue;
+        if (std::fabs(ray0.ray.tfar-ray1.ray.tfar) > 1E-5f) return VerifyApplication::FAILED;
+        numHits++;
+      }
+      AssertNoError(device);
+      return numHits > 0 ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct ClosestPointBatchTest : public VerifyApplication::Test
+  {
+    static const size_t N = 2000;
+
+    ClosestPointBatchTest (std::string name, int isa)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      RandomSampler sampler;
+      RandomSampler_init(sampler, int(isa));
+
+      /* random triangles and quads, the quads are tested as triangles (v0,v1,v3) and (v2,v3,v1) */
+      std::vector<Vec3fa> vertices(4*300);
+      for (size_t i=0; i<vertices.size(); i+=4) {
+        const Vec3fa c = RandomSampler_get3D(sampler);
+        for (size_t j=0; j<4; j++) vertices[i+j] = c + 0.1f*(Vec3fa(RandomSampler_get3D(sampler))-Vec3fa(0.5f));
+      }
+      std::vector<unsigned int> triangles(3*200), quads(4*100);
+      for (size_t i=0; i<200; i++) for (size_t j=0; j<3; j++) triangles[3*i+j] = unsigned(4*i+j);
+      for (size_t i=0; i<100; i++) for (size_t j=0; j<4; j++) quads[4*i+j] = unsigned(4*(200+i)+j);
+
+      RTCSceneRef mesh_scene = rtcNewScene(device);
+      RTCGeometry tris = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+      rtcSetSharedGeometryBuffer(tris, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices.data(), 0, sizeof(Vec3fa), vertices.size());
+      rtcSetSharedGeometryBuffer(tris, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, triangles.data(), 0, 3*sizeof(unsigned int), 200);
+      rtcCommitGeometry(tris);
+      rtcAttachGeometry(mesh_scene,tris);
+      rtcReleaseGeometry(tris);
+      RTCGeometry quad = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_QUAD);
+      rtcSetSharedGeometryBuffer(quad, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices.data(), 0, sizeof(Vec3fa), vertices.size());
+      rtcSetSharedGeometryBuffer(quad, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT4, quads.data(), 0, 4*sizeof(unsigned int), 100);
+      rtcCommitGeometry(quad);
+      rtcAttachGeometry(mesh_scene,quad);
+      rtcReleaseGeometry(quad);
+      rtcCommitScene(mesh_scene);
+
+      /* the meshes are used directly and through a scaled and translated instance */
+      const AffineSpace3fa xfm = AffineSpace3fa::translate(Vec3fa(1.5f,0.0f,0.0f))*AffineSpace3fa::scale(Vec3fa(0.5f,2.0f,1.0f));
+      RTCSceneRef scene = rtcNewScene(device);
+      RTCGeometry geom0 = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_INSTANCE);
+      rtcSetGeometryInstancedScene(geom0,mesh_scene);
+      rtcCommitGeometry(geom0);
+      rtcAttachGeometry(scene,geom0);
+      rtcReleaseGeometry(geom0);
+      RTCGeometry geom1 = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_INSTANCE);
+      rtcSetGeometryInstancedScene(geom1,mesh_scene);
+      rtcSetGeometryTransform(geom1,0,RTC_FORMAT_FLOAT4X4_COLUMN_MAJOR,(float*)&xfm);
+      rtcCommitGeometry(geom1);
+      rtcAttachGeometry(scene,geom1);
+      rtcReleaseGeometry(geom1);
+      rtcCommitScene(scene);
+      AssertNoError(device);
+
+      avector<RTCPointQuery> queries(N);
+      std::vector<RTCClosestPointHit> hits(N);
+      for (size_t i=0; i<N; i++) {
+        const Vec3fa p = Vec3fa(2.5f,2.0f,1.0f)*Vec3fa(RandomSampler_get3D(sampler)) - Vec3fa(0.25f);
+        queries[i].x = p.x; queries[i].y = p.y; queries[i].z = p.z;
+        queries[i].time = 0.0f;
+        queries[i].radius = (i%2) ? 0.1f : float(inf);
+      }
+
+      /* queries with non-finite coordinates must not disturb the others */
+      for (size_t i=5; i<N; i+=97) queries[i].x = nan;
+      for (size_t i=11; i<N; i+=97) queries[i].y = inf;
+      for (size_t i=17; i<N; i+=97) queries[i].z = neg_inf;
+      rtcClosestPointBatch(scene,queries.data(),hits.data(),N);
+      AssertNoError(device);
+
+      /* brute force reference over all primitives of both instances */
+      auto closestDistance = [&] (const Vec3fa& q) -> float
+      {
+        float d = inf;
+        for (const AffineSpace3fa& space : { AffineSpace3fa(one), xfm })
+        {
+          for (size_t j=0; j<200; j++) {
+            const Vec3fa v0 = xfmPoint(space,vertices[triangles[3*j+0]]);
+            const Vec3fa v1 = xfmPoint(space,vertices[triangles[3*j+1]]);
+            const Vec3fa v2 = xfmPoint(space,vertices[triangles[3*j+2]]);
+            d = min(d,distance(q,closestPointTriangle(q,v0,v1,v2)));
+          }
+          for (size_t j=0; j<100; j++) {
+            const Vec3fa v0 = xfmPoint(space,vertices[quads[4*j+0]]);
+            const Vec3fa v1 = xfmPoint(space,vertices[quads[4*j+1]]);
+            const Vec3fa v2 = xfmPoint(space,vertices[quads[4*j+2]]);
+            const Vec3fa v3 = xfmPoint(space,vertices[quads[4*j+3]]);
+            d = min(d,distance(q,closestPointTriangle(q,v0,v1,v3)));
+            d = min(d,distance(q,closestPointTriangle(q,v2,v3,v1)));
+          }
+        }
+        return d;
+      };
+
+      size_t numHits = 0;
+      for (size_t i=0; i<N; i++)
+      {
+        const Vec3fa q(queries[i].x,queries[i].y,queries[i].z);
+        if (!isvalid(q)) continue;
+        const float d = closestDistance(q);
+        if (d >= queries[i].radius) {
+          if (hits[i].geomID != RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+          continue;
+        }
+        if (hits[i].geomID == RTC_INVALID_GEOMETRY_ID) return VerifyApplication::FAILED;
+        if (std::fabs(hits[i].distance-d) > 1E-5f) return VerifyApplication::FAILED;
+        const Vec3fa p(hits[i].p_x,hits[i].p_y,hits[i].p_z);
+        if (std::fabs(distance(p,q)-d) > 1E-5f) return VerifyApplication::FAILED;
+        numHits++;
+      }
+      return numHits > N/2 ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct TriangleCollideTest : public VerifyApplication::Test
+  {
+    static const size_t N = 64;
+
+    TriangleCollideTest (std::string name, int isa, RTCSceneFlags sflags)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS), sflags(sflags) {}
+
+    struct Collisions
+    {
+      MutexSys mutex;
+      std::vector<RTCCollision> collisions;
+      bool valid = true;
+    };
+
+    static void collideFunc (void* userPtr, RTCCollision* collisions, unsigned int num_collisions)
+    {
+      Collisions* c = (Collisions*) userPtr;
+      Lock<MutexSys> lock(c->mutex);
+      if (num_collisions == 0 || num_collisions > 256) c->valid = false;
+      c->collisions.insert(c->collisions.end(),collisions,collisions+num_collisions);
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* every grid cell contains a triangle in the xy plane in the first scene and a
+       * triangle in the xz plane in the second scene, which only crosses the first one in every second cell */
+      std::vector<Vec3fa> vertices0(3*N*N), vertices1(3*N*N);
+      std::vector<unsigned int> indices(3*N*N);
+      for (size_t y=0; y<N; y++)
+      {
+        for (size_t x=0; x<N; x++)
+        {
+          const size_t i = y*N+x;
+          const Vec3fa p(float(x),float(y),0.0f);
+          const float h = (i%2) ? 0.0f : 1.0f;
+          vertices0[3*i+0] = p+Vec3fa(0.1f,0.1f,0.0f);
+          vertices0[3*i+1] = p+Vec3fa(0.9f,0.1f,0.0f);
+          vertices0[3*i+2] = p+Vec3fa(0.1f,0.9f,0.0f);
+          vertices1[3*i+0] = p+Vec3fa(0.2f,0.3f,h-0.5f);
+          vertices1[3*i+1] = p+Vec3fa(0.6f,0.3f,h-0.5f);
+          vertices1[3*i+2] = p+Vec3fa(0.2f,0.3f,h+0.5f);
+          for (size_t j=0; j<3; j++) indices[3*i+j] = unsigned(3*i+j);
+        }
+      }
+
+      RTCSceneRef scenes[2] = { rtcNewScene(device), rtcNewScene(device) };
+      std::vector<Vec3fa>* vertices[2] = { &vertices0, &vertices1 };
+      for (size_t i=0; i<2; i++)
+      {
+        rtcSetSceneFlags(scenes[i],sflags);
+        RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, vertices[i]->data(), 0, sizeof(Vec3fa), vertices[i]->size());
+        rtcSetSharedGeometryBuffer(geom, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, indices.data(), 0, 3*sizeof(unsigned int), N*N);
+        rtcCommitGeometry(geom);
+        rtcAttachGeometry(scenes[i],geom);
+        rtcReleaseGeometry(geom);
+        rtcCommitScene(scenes[i]);
+      }
+      AssertNoError(device);
+
+      Collisions c;
+      rtcCollide(scenes[0],scenes[1],collideFunc,&c);
+      AssertNoError(device);
+
+      if (!c.valid) return VerifyApplication::FAILED;
+      if (c.collisions.size() != N*N/2) return VerifyApplication::FAILED;
+      std::vector<bool> found(N*N,false);
+      for (const RTCCollision& collision : c.collisions)
+      {
+        if (collision.geomID0 != 0 || collision.geomID1 != 0) return VerifyApplication::FAILED;
+        if (collision.primID0 != collision.primID1) return VerifyApplication::FAILED;
+        if (collision.primID0 % 2 == 0 || found[collision.primID0]) return VerifyApplication::FAILED;
+        found[collision.primID0] = true;
+      }
+      return VerifyApplication::PASSED;
+    }
+
+    RTCSceneFlags sflags;
+  };
+
+  struct BufferFromFileTest : public VerifyApplication::Test
+  {
+    BufferFromFileTest (std::string name, int isa)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+
+      /* the same sphere once from shared buffers and once mapped from a file at unaligned offsets */
+      Ref<SceneGraph::TriangleMeshNode> mesh = SceneGraph::createTriangleSphere(Vec3fa(0,0,0),1.0f,32,nullptr).dynamicCast<SceneGraph::TriangleMeshNode>();
+      const size_t vertexBytes = mesh->positions[0].size()*sizeof(SceneGraph::TriangleMeshNode::Vertex);
+      const size_t indexBytes = mesh->triangles.size()*sizeof(SceneGraph::TriangleMeshNode::Triangle);
+      const size_t vertexOffset = 12, indexOffset = vertexOffset+vertexBytes+4;
+      const std::string fileName = "verify_buffer_from_file.bin";
+      {
+        std::vector<char> data(indexOffset+indexBytes+16,0);
+        memcpy(data.data()+vertexOffset,mesh->positions[0].data(),vertexBytes);
+        memcpy(data.data()+indexOffset,mesh->triangles.data(),indexBytes);
+        FILE* file = fopen(fileName.c_str(),"wb");
+        if (!file) return VerifyApplication::FAILED;
+        fwrite(data.data(),1,data.size(),file);
+        fclose(file);
+      }
+
+      RTCBuffer vertices = rtcNewBufferFromFile(device,fileName.c_str(),vertexOffset,vertexBytes);
+      RTCBuffer indices = rtcNewBufferFromFile(device,fileName.c_str(),indexOffset,indexBytes);
+      AssertNoError(device);
+      rtcNewBufferFromFile(device,fileName.c_str(),indexOffset,indexBytes+17);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+      rtcNewBufferFromFile(device,fileName.c_str(),indexOffset,size_t(-1)-indexOffset+1);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+      rtcNewBufferFromFile(device,(fileName+".missing").c_str(),0,4);
+      AssertError(device,RTC_ERROR_INVALID_ARGUMENT);
+
+      RTCSceneRef scenes[2] = { rtcNewScene(device), rtcNewScene(device) };
+      for (size_t i=0; i<2; i++)
+      {
+        RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+        if (i == 0) {
+          rtcSetSharedGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,mesh->positions[0].data(),0,sizeof(SceneGraph::TriangleMeshNode::Vertex),mesh->positions[0].size());
+          rtcSetSharedGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,mesh->triangles.data(),0,sizeof(SceneGraph::TriangleMeshNode::Triangle),mesh->triangles.size());
+        } else {
+          rtcSetGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,vertices,0,sizeof(SceneGraph::TriangleMeshNode::Vertex),mesh->positions[0].size());
+          rtcSetGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,indices,0,sizeof(SceneGraph::TriangleMeshNode::Triangle),mesh->triangles.size());
+        }
+        rtcCommitGeometry(geom);
+        rtcAttachGeometry(scenes[i],geom);
+        rtcReleaseGeometry(geom);
+        rtcCommitScene(scenes[i]);
+      }
+      rtcReleaseBuffer(vertices);
+      rtcReleaseBuffer(indices);
+      AssertNoError(device);
+
+      RandomSampler sampler;
+      RandomSampler_init(sampler, int(isa));
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      bool passed = true;
+      for (size_t i=0; i<100; i++)
+      {
+        const Vec3fa org = 4.0f*Vec3fa(RandomSampler_get3D(sampler))-Vec3fa(2.0f);
+        const Vec3fa dir = normalize(Vec3fa(RandomSampler_get3D(sampler))-Vec3fa(0.5f)-0.25f*org);
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = makeRay(org,dir);
+        rtcIntersect1(scenes[0],&context,&ray0);
+        rtcIntersect1(scenes[1],&context,&ray1);
+        passed &= ray0.hit.primID == ray1.hit.primID && ray0.ray.tfar == ray1.ray.tfar;
+      }
+      AssertNoError(device);
+
+      scenes[0] = nullptr;
+      scenes[1] = nullptr;
+      std::remove(fileName.c_str());
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  /* two devices that differ only in their configuration have to find the same hits in the same scenes */
+  struct DeviceConfigComparison
+  {
+    DeviceConfigComparison (VerifyApplication* state, int isa, const std::string& config0, const std::string& config1)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa);
+      devices[0] = rtcNewDevice((cfg+config0).c_str());
+      devices[1] = rtcNewDevice((cfg+config1).c_str());
+      errorHandler(nullptr,rtcGetDeviceError(devices[0]));
+      errorHandler(nullptr,rtcGetDeviceError(devices[1]));
+    }
+
+    static RTCScene createScene(RTCDevice device, Ref<SceneGraph::TriangleMeshNode> mesh, RTCSceneFlags flags, RTCBuildQuality quality)
+    {
+      RTCScene scene = rtcNewScene(device);
+      rtcSetSceneFlags(scene,flags);
+      rtcSetSceneBuildQuality(scene,quality);
+      RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+      rtcSetGeometryBuildQuality(geom,quality);
+      rtcSetSharedGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,mesh->positions[0].data(),0,sizeof(SceneGraph::TriangleMeshNode::Vertex),mesh->positions[0].size());
+      rtcSetSharedGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,mesh->triangles.data(),0,sizeof(SceneGraph::TriangleMeshNode::Triangle),mesh->triangles.size());
+      rtcCommitGeometry(geom);
+      rtcAttachGeometry(scene,geom);
+      rtcReleaseGeometry(geom);
+      rtcCommitScene(scene);
+      return scene;
+    }
+
+    /* builds a triangle sphere on both devices and compares the hits of random rays */
+    bool compare(size_t numPhi, RTCSceneFlags flags, RTCBuildQuality quality, int seed)
+    {
+      Ref<SceneGraph::Node> node = SceneGraph::createTriangleSphere(Vec3fa(0,0,0),1.0f,numPhi,nullptr);
+      Ref<SceneGraph::TriangleMeshNode> mesh = node.dynamicCast<SceneGraph::TriangleMeshNode>();
+      RTCSceneRef scenes[2] = { createScene(devices[0],mesh,flags,quality), createScene(devices[1],mesh,flags,quality) };
+      AssertNoError(devices[0]);
+      AssertNoError(devices[1]);
+
+      RandomSampler sampler;
+      RandomSampler_init(sampler, seed);
+      RTCIntersectContext context;
+      rtcInitIntersectContext(&context);
+      bool passed = true;
+      for (size_t i=0; i<1000; i++)
+      {
+        const Vec3fa org = 4.0f*Vec3fa(RandomSampler_get3D(sampler))-Vec3fa(2.0f);
+        const Vec3fa dir = normalize(Vec3fa(RandomSampler_get3D(sampler))-Vec3fa(0.5f)-0.25f*org);
+        RTCRayHit ray0 = makeRay(org,dir);
+        RTCRayHit ray1 = makeRay(org,dir);
+        rtcIntersect1(scenes[0],&context,&ray0);
+        rtcIntersect1(scenes[1],&context,&ray1);
+        passed &= ray0.hit.geomID == ray1.hit.geomID && ray0.ray.tfar == ray1.ray.tfar;
+      }
+      AssertNoError(devices[0]);
+      AssertNoError(devices[1]);
+      return passed;
+    }
+
+    RTCDeviceRef devices[2];
+  };
+
+  struct QuantizedBinningTest : public VerifyApplication::Test
+  {
+    QuantizedBinningTest (std::string name, int isa)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      /* one device bins the full primrefs, the other quantized primrefs for all builds, large enough to requantize subtrees */
+      DeviceConfigComparison comparison(state,isa,"",",quantized_binning_threshold=1");
+      const bool passed = comparison.compare(128,RTC_SCENE_FLAG_NONE,RTC_BUILD_QUALITY_MEDIUM,int(isa));
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct MortonCodeBitsTest : public VerifyApplication::Test
+  {
+    MortonCodeBitsTest (std::string name, int isa)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS) {}
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      /* one device builds with 32 bit morton codes, the other with 64 bit morton codes */
+      DeviceConfigComparison comparison(state,isa,"",",morton_code_bits=64");
+      const bool passed = comparison.compare(256,RTC_SCENE_FLAG_DYNAMIC,RTC_BUILD_QUALITY_LOW,int(isa));
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+  };
+
+  struct BlockPoolTest : public VerifyApplication::Test
+  {
+    BlockPoolTest (std::string name, int isa, RTCBuildQuality quality)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS), quality(quality) {}
+
+    static size_t getUsage(RTCDevice device, RTCMemoryCategory category)
+    {
+      RTCMemoryUsage usage;
+      rtcGetDeviceMemoryUsage(device,category,&usage);
+      return usage.bytes;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      /* the first device frees its blocks, the second device keeps them in its block pool */
+      DeviceConfigComparison comparison(state,isa,"",",block_pool_max_size=256");
+      RTCDevice devices[2] = { comparison.devices[0], comparison.devices[1] };
+      if (rtcGetDeviceProperty(devices[0],RTC_DEVICE_PROPERTY_BLOCK_POOL_MAX_SIZE) != 0) return VerifyApplication::FAILED;
+      if (rtcGetDeviceProperty(devices[1],RTC_DEVICE_PROPERTY_BLOCK_POOL_MAX_SIZE) != 256*1024*1024) return VerifyApplication::FAILED;
+
+      /* every scene of the second device gets built from the blocks of the previous scene */
+      bool passed = true;
+      for (size_t numPhi=256; numPhi>=16; numPhi/=2)
+        passed &= comparison.compare(numPhi,RTC_SCENE_FLAG_NONE,quality,int(numPhi));
+
+      /* the blocks of the released scenes are pooled */
+      passed &= rtcGetDeviceProperty(devices[0],RTC_DEVICE_PROPERTY_BLOCK_POOL_SIZE) == 0;
+      passed &= rtcGetDeviceProperty(devices[1],RTC_DEVICE_PROPERTY_BLOCK_POOL_SIZE) > 0;
+
+      /* taking blocks out of the pool and returning them moves the same bytes between the categories */
+      for (size_t i=0; i<2; i++) {
+        passed &= getUsage(devices[i],RTC_MEMORY_CATEGORY_ACCEL_UNUSED) == 0;
+        passed &= getUsage(devices[i],RTC_MEMORY_CATEGORY_BLOCK_POOL) == rtcGetDeviceProperty(devices[i],RTC_DEVICE_PROPERTY_BLOCK_POOL_SIZE);
+        passed &= getUsage(devices[i],RTC_MEMORY_CATEGORY_TOTAL) == getUsage(devices[i],RTC_MEMORY_CATEGORY_BLOCK_POOL) + getUsage(devices[i],RTC_MEMORY_CATEGORY_TESSELLATION_CACHE);
+      }
+
+      /* trimming the pool returns all blocks to the OS */
+      rtcSetDeviceProperty(devices[1],RTC_DEVICE_PROPERTY_BLOCK_POOL_MAX_SIZE,0);
+      passed &= rtcGetDeviceProperty(devices[1],RTC_DEVICE_PROPERTY_BLOCK_POOL_SIZE) == 0;
+      passed &= getUsage(devices[1],RTC_MEMORY_CATEGORY_TOTAL) == getUsage(devices[1],RTC_MEMORY_CATEGORY_TESSELLATION_CACHE);
+      AssertNoError(devices[0]);
+      AssertNoError(devices[1]);
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+
+    RTCBuildQuality quality;
+  };
+
+  struct MemoryUsageTest : public VerifyApplication::Test
+  {
+    MemoryUsageTest (std::string name, int isa, RTCBuildQuality quality)
+      : VerifyApplication::Test(name, isa, VerifyApplication::TEST_SHOULD_PASS), quality(quality) {}
+
+    static RTCMemoryUsage getUsage(RTCDevice device, RTCMemoryCategory category)
+    {
+      RTCMemoryUsage usage;
+      rtcGetDeviceMemoryUsage(device,category,&usage);
+      return usage;
+    }
+
+    static RTCMemoryUsage getUsage(RTCScene scene, RTCMemoryCategory category)
+    {
+      RTCMemoryUsage usage;
+      rtcGetSceneMemoryUsage(scene,category,&usage);
+      return usage;
+    }
+
+    VerifyApplication::TestReturnValue run(VerifyApplication* state, bool silent)
+    {
+      std::string cfg = state->rtcore + ",isa="+stringOfISA(isa)+",tessellation_cache_size=16";
+      RTCDeviceRef device = rtcNewDevice(cfg.c_str());
+      errorHandler(nullptr,rtcGetDeviceError(device));
+      bool passed = true;
+      if (rtcGetDeviceProperty(device,RTC_DEVICE_PROPERTY_SUBDIVISION_GEOMETRY_SUPPORTED))
+        passed &= getUsage(device,RTC_MEMORY_CATEGORY_TESSELLATION_CACHE).bytes == 16*1024*1024;
+
+      Ref<SceneGraph::Node> node = SceneGraph::createTriangleSphere(Vec3fa(0,0,0),1.0f,64,nullptr);
+      Ref<SceneGraph::TriangleMeshNode> mesh = node.dynamicCast<SceneGraph::TriangleMeshNode>();
+      const size_t numVertices = mesh->positions[0].size();
+      const size_t numTriangles = mesh->triangles.size();
+      {
+        RTCSceneRef scene = rtcNewScene(device);
+        rtcSetSceneBuildQuality(scene,quality);
+        RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
+        rtcSetGeometryBuildQuality(geom,quality);
+        void* vertices = rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_VERTEX,0,RTC_FORMAT_FLOAT3,sizeof(SceneGraph::TriangleMeshNode::Vertex),numVertices);
+        void* triangles = rtcSetNewGeometryBuffer(geom,RTC_BUFFER_TYPE_INDEX,0,RTC_FORMAT_UINT3,sizeof(SceneGraph::TriangleMeshNode::Triangle),numTriangles);
+        memcpy(vertices,mesh->positions[0].data(),numVertices*sizeof(SceneGraph::TriangleMeshNode::Vertex));
+        memcpy(triangles,mesh->triangles.data(),numTriangles*sizeof(SceneGraph::TriangleMeshNode::Triangle));
+        rtcCommitGeometry(geom);
+        rtcAttachGeometry(scene,geom);
+        rtcReleaseGeometry(geom);
+        rtcCommitScene(scene);
+        AssertNoError(device);
+
+        const size_t bufferBytes = numVertices*sizeof(SceneGraph::TriangleMeshNode::Vertex) + numTriangles*sizeof(SceneGraph::TriangleMeshNode::Triangle);
+        passed &= getUsage(device,RTC_MEMORY_CATEGORY_GEOMETRY_BUFFERS).bytes >= bufferBytes;
+        passed &= getUsage(device,RTC_MEMORY_CATEGORY_BUILD_TEMPORARIES).peakBytes > 0;
+
+        /* the scene is the only scene of the device */
+        const RTCMemoryCategory categories[] = { RTC_MEMORY_CATEGORY_ACCEL_NODES, RTC_MEMORY_CATEGORY_ACCEL_LEAVES, RTC_MEMORY_CATEGORY_ACCEL_UNUSED };
+        size_t sceneBytes = 0;
+        for (auto category : categories) {
+          passed &= getUsage(scene,category).bytes == getUsage(device,category).bytes;
+          sceneBytes += getUsage(scene,category).bytes;
+        }
+        passed &= getUsage(scene,RTC_MEMORY_CATEGORY_ACCEL_NODES).bytes > 0;
+        passed &= getUsage(scene,RTC_MEMORY_CATEGORY_ACCEL_LEAVES).bytes >= numTriangles*sizeof(int)*3;
+        passed &= getUsage(scene,RTC_MEMORY_CATEGORY_TOTAL).bytes == sceneBytes;
+        passed &= getUsage(scene,RTC_MEMORY_CATEGORY_GEOMETRY_BUFFERS).bytes == 0;
+        passed &= getUsage(device,RTC_MEMORY_CATEGORY_TOTAL).bytes >= sceneBytes + bufferBytes;
+        passed &= getUsage(device,RTC_MEMORY_CATEGORY_TOTAL).peakBytes >= getUsage(device,RTC_MEMORY_CATEGORY_TOTAL).bytes;
+      }
+
+      /* releasing the scene frees its acceleration structures and buffers, the peaks stay */
+      passed &= getUsage(device,RTC_MEMORY_CATEGORY_ACCEL_NODES).bytes == 0;
+      passed &= getUsage(device,RTC_MEMORY_CATEGORY_ACCEL_LEAVES).bytes == 0;
+      passed &= getUsage(device,RTC_MEMORY_CATEGORY_ACCEL_UNUSED).bytes == 0;
+      passed &= getUsage(device,RTC_MEMORY_CATEGORY_BUILD_TEMPORARIES).bytes == 0;
+      passed &= getUsage(device,RTC_MEMORY_CATEGORY_GEOMETRY_BUFFERS).bytes == 0;
+      passed &= getUsage(device,RTC_MEMORY_CATEGORY_ACCEL_NODES).peakBytes > 0;
+      passed &= getUsage(device,RTC_MEMORY_CATEGORY_ACCEL_LEAVES).peakBytes > 0;
+      AssertNoError(device);
+      return passed ? VerifyApplication::PASSED : VerifyApplication::FAILED;
+    }
+
+    RTCBuildQuality quality;
+  };
+
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+  /////////////////////////////////////////////////////////////////////////////////
+
+  void shootRandomRays (int hash, std::vector<IntersectMode>& intersectModes, std::vector<IntersectVariant>& intersectVariants, const VerifyScene& scene)
+  {
+    RandomSampler sampler;
+    RandomSampler_init(sampler,hash);
+
+    const size_t numRays = 100;
+    for (auto imode : intersectModes)
+    {
+      for (auto ivariant : intersectVariants)
+      {
+        if (!has_variant(imode,ivariant)) continue;
+
+        RTCRayHit rays[numRays];
+        for (size_t i=0; i<numRays; i++) {
+          Vec3fa org = 2.0f*RandomSampler_get3D(sampler) - Vec3fa(1.0f);
+          Vec3fa dir = 2.0f*RandomSampler_get3D(sampler) - Vec3fa(1.0f);
+          rays[i] = makeRay(org,dir); 
+        }
+        IntersectWithMode(imode,ivariant,scene,rays,numRays);
+      }
+    }
+  }
+
+  struct RegressionTask
+  {
+    RegressionTask (VerifyApplication::Test* test, unsigned int sceneIndex, unsigned int sceneCount, unsigned int threadCount, bool cancelBuild)
+      : sceneIndex(sceneIndex), sceneCount(sceneCount), test(test), scene(nullptr), numActiveThreads(0), cancelBuild(cancelBuild), errorCounter(0) 
+    { 
+      barrier.init(threadCount); 
+      RandomSampler_init(sampler,0);
+    }
+
+    unsigned int sceneIndex;
+    unsigned int sceneCount;
+    VerifyApplication::Test* test;
+    VerifyApplication* state;
+    Ref<VerifyScene> scene;
+    BarrierSys barrier;
+    volatile unsigned int numActiveThreads;
+    bool cancelBuild;
+    std::atomic<size_t> errorCounter;
+    RandomSampler sampler;
+  };
+
+  struct ThreadRegressionTask
+  {
+    ThreadRegressionTask (unsigned int threadIndex, unsigned int threadCount,
+                          VerifyApplication* state, RTCDeviceRef& device, std::vector<IntersectMode>& intersectModes, RegressionTask* task)
+      : threadIndex(threadIndex), threadCount(threadCount), state(state), device(device), intersectModes(intersectModes), task(task) {}
+
+    unsigned int threadIndex;
+    unsigned int threadCount;
+    VerifyApplication* state;
+    RTCDeviceRef& device;
+    std::vector<IntersectMode>& intersectModes;
+    RegressionTask* task;
+  };
+
+  size_t monitorProgressBreak = 0;
+  std::atomic<size_t> monitorProgressInvokations(0);
+  std::atomic<size_t> monitorProgressBreakExecuted(0);
+
+  bool monitorProgressFunction(void* ptr, double dn) 
+  {
+    size_t n = monitorProgressInvokations++;
+    if (n == monitorProgressBreak) {
+      monitorProgressBreakExecuted++;
+      return false;
+    }
+    return true;
+  }
+
+  void rtcore_regression_static_thread(void* ptr)
+  {
+    ThreadRegressionTask* thread = (ThreadRegressionTask*) ptr;
+    RegressionTask* task = thread->task;
+    if (thread->threadIndex > 0) 
+    {
+      for (unsigned int i=0; i<task->sceneCount; i++) 
+      {
+  task->barrier.wait();
+  if (thread->threadIndex < task->numActiveThreads) 
+  {
+          rtcJoinCommitScene(*task->scene);
+    //if (rtcGetDeviceError(thread->device) != RTC_ERROR_NONE) task->errorCounter++;;
+          if (rtcGetDeviceError(thread->device) != RTC_ERROR_NONE) {
+            task->errorCounter++;
+          }
+          else {
+            shootRandomRays(i,thread->intersectModes,thread->state->intersectVariants,*task->scene);
+          }
+  }
+        task->barrier.wait();
+      }
+      delete thread; thread = nullptr;
+      return;
+    }
+
+    if (rtcGetDeviceError(thread->device) != RTC_ERROR_NONE) task->errorCounter++;;
+    bool hasError = false;
+
+    for (unsigned int i=0; i<task->sceneCount; i++) 
+    {
+      RandomSampler_init(task->sampler,task->sceneIndex*13565+i*3242);
+      if (i%5 == 0) std::cout << "." << std::flush;
+
+      SceneFlags sflags = getSceneFlags(i);
+      task->scene = new VerifyScene(thread->device,sflags);
+      if (rtcGetDeviceError(thread->device) != RTC_ERROR_NONE) task->errorCounter++;;
+      if (task->cancelBuild) rtcSetSceneProgressMonitorFunction(*task->scene,monitorProgressFunction,nullptr);
+      std::vector<std::unique_ptr<Sphere>> spheres;
+      
+      for (unsigned int j=0; j<10; j++) 
+      {
+        Vec3fa pos = 100.0f*RandomSampler_get3D(task->sampler);
+        int type = RandomSampler_getInt(task->sampler)%11;
+        switch (RandomSampler_getInt(task->sampler)%16) {
+        case 0: pos = Vec3fa(nan); break;
         case 1: pos = Vec3fa(inf); break;
         case 2: pos = Vec3fa(1E30f); break;
         default: break;
@@ -5277,6 +6771,7 @@ namespace embree
       groups.top()->add(new EmbreeInternalTest(testName,i-2000000));
     }
     groups.top()->add(new os_shrink_test());
+    groups.top()->add(new DuplicateInstancingTest("convert_duplicates_to_instances"));
 
     for (auto isa : isas)
     {
@@ -5408,6 +6903,11 @@ namespace embree
         groups.top()->add(new InterpolateHairTest(std::to_string((long long)(s)),isa,s));
       groups.pop();
 
+      push(new TestGroup("batch",true,true));
+      groups.top()->add(new InterpolateBatchTest("triangles",isa,RTC_GEOMETRY_TYPE_TRIANGLE));
+      groups.top()->add(new InterpolateBatchTest("subdiv",isa,RTC_GEOMETRY_TYPE_SUBDIVISION));
+      groups.pop();
+
       groups.pop();
       
       /**************************************************************************/
@@ -5648,6 +7148,29 @@ namespace embree
       groups.top()->add(new GeometryStateTest("geometry_state_tests", isa));
       groups.top()->add(new SceneCheckModifiedGeometryTest("scene_modified_geometry_tests", isa));
       groups.top()->add(new SphereFilterMultiHitTest("sphere_filter_multi_hit_tests", isa));
+      groups.top()->add(new CurveLODTest("curve_lod_tests", isa));
+      groups.top()->add(new CurvePretessellationTest("curve_pretessellation_bezier", isa, RTC_GEOMETRY_TYPE_ROUND_BEZIER_CURVE));
+      groups.top()->add(new CurvePretessellationTest("curve_pretessellation_bspline", isa, RTC_GEOMETRY_TYPE_ROUND_BSPLINE_CURVE));
+      groups.top()->add(new UserGeometryBatchTest("user_geometry_batch", isa, "", false));
+      groups.top()->add(new UserGeometryBatchTest("user_geometry_batch_leaf_size", isa, ",object_accel_min_leaf_size=2,object_accel_max_leaf_size=4", false));
+      groups.top()->add(new UserGeometryBatchTest("user_geometry_batch_recommit", isa, "", true));
+      groups.top()->add(new SubdivTessellationConeTest("subdiv_tessellation_cone", isa));
+      groups.top()->add(new SubdivTopologyUpdateTest("subdiv_topology_update", isa));
+      groups.top()->add(new SubdivMultiDeviceCacheTest("subdiv_multi_device_cache", isa));
+      groups.top()->add(new SubdivDisplacementBatchTest("subdiv_displacement_batch", isa));
+      groups.top()->add(new QuantizedGridTest("quantized_grid", isa));
+      groups.top()->add(new PointCloudMortonTest("point_cloud_morton", isa));
+      groups.top()->add(new ClosestPointBatchTest("closest_point_batch", isa));
+      groups.top()->add(new TriangleCollideTest("triangle_collide", isa, RTC_SCENE_FLAG_NONE));
+      groups.top()->add(new TriangleCollideTest("triangle_collide_robust", isa, RTC_SCENE_FLAG_ROBUST));
+      groups.top()->add(new TriangleCollideTest("triangle_collide_compact", isa, RTC_SCENE_FLAG_COMPACT));
+      groups.top()->add(new BufferFromFileTest("buffer_from_file", isa));
+      groups.top()->add(new QuantizedBinningTest("quantized_binning", isa));
+      groups.top()->add(new MortonCodeBitsTest("morton_code_bits", isa));
+      groups.top()->add(new BlockPoolTest("block_pool", isa, RTC_BUILD_QUALITY_MEDIUM));
+      groups.top()->add(new BlockPoolTest("block_pool_morton", isa, RTC_BUILD_QUALITY_LOW));
+      groups.top()->add(new MemoryUsageTest("memory_usage", isa, RTC_BUILD_QUALITY_MEDIUM));
+      groups.top()->add(new MemoryUsageTest("memory_usage_morton", isa, RTC_BUILD_QUALITY_LOW));
 
       
       /**************************************************************************/